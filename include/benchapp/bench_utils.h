@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdio>
+#include <chrono>
+
+namespace bench_utils
+{
+
+// the mean time of one call in ns, after a warm-up call
+template<typename FUNCT>
+double measure_ns ( size_t const repeat, FUNCT&& funct )
+{
+  funct();
+
+  auto const start = std::chrono::steady_clock::now();
+
+  for ( size_t r = 0; r < repeat; ++r )
+  {
+    funct();
+  }
+
+  auto const stop = std::chrono::steady_clock::now();
+
+  return std::chrono::duration<double, std::nano> ( stop - start ).count() / static_cast<double> ( repeat );
+}
+
+inline void report ( char const* name, double const ns_per_call, char const* unit = "call" )
+{
+  std::printf ( "  %-48s %14.2f ns/%s\n", name, ns_per_call, unit );
+}
+
+}  // namespace bench_utils
@@ -5,6 +5,7 @@
 #include <type_traits>
 #include <tuple>
 #include <array>
+#include <utility>
 #include <cmath>
 
 namespace diffsolve
@@ -34,11 +35,10 @@ struct diffsolve_traits
   using ret_type_t = FUNCT_ARG;
   using funct_arg_t = FUNCT_ARG;
   using funct_args_t = tuple_utils::funct_args_t<ARGS...>;
-  using target_function_t = tuple_utils::target_nonstationary_function_t<funct_arg_t, ARGS...>;
-  using target_function_array_t = tuple_utils::target_function_array_t<target_function_t, SYSTEM_RANK>;
 
+  template<typename FUNCT_ARRAY>
   static funct_args_t
-  evaluate_gradient ( target_function_array_t const& f,
+  evaluate_gradient ( FUNCT_ARRAY const& f,
                       funct_arg_t t,
                       funct_args_t const& y,
                       funct_arg_t tau )
@@ -56,11 +56,10 @@ struct diffsolve_traits<diffsolve_method::euler, SYSTEM_RANK, FUNCT_ARG, ARGS...
   using ret_type_t = FUNCT_ARG;
   using funct_arg_t = FUNCT_ARG;
   using funct_args_t = tuple_utils::funct_args_t<ARGS...>;
-  using target_function_t = tuple_utils::target_nonstationary_function_t<funct_arg_t, ARGS...>;
-  using target_function_array_t = tuple_utils::target_function_array_t<target_function_t, SYSTEM_RANK>;
 
+  template<typename FUNCT_ARRAY>
   static funct_args_t
-  evaluate_gradient ( target_function_array_t const& f,
+  evaluate_gradient ( FUNCT_ARRAY const& f,
                       funct_arg_t t,
                       funct_args_t const& y,
                       funct_arg_t tau )
@@ -72,9 +71,9 @@ struct diffsolve_traits<diffsolve_method::euler, SYSTEM_RANK, FUNCT_ARG, ARGS...
   }
 
 private:
-  template <size_t ... Indexes>
+  template <typename FUNCT_ARRAY, size_t ... Indexes>
   static funct_args_t
-  evaluate_gradient_impl ( target_function_array_t const& f,
+  evaluate_gradient_impl ( FUNCT_ARRAY const& f,
                            funct_arg_t t,
                            funct_args_t const& y,
                            funct_arg_t tau,
@@ -82,7 +81,7 @@ private:
   {
     funct_args_t result{};
 
-    ( ( std::get<Indexes> ( result ) = tau * f[Indexes] ( t, y ) ), ... );
+    ( ( std::get<Indexes> ( result ) = tau * std::get<Indexes> ( f ) ( t, y ) ), ... );
 
     return result;
   }
@@ -96,11 +95,10 @@ struct diffsolve_traits<diffsolve_method::runge_kutta_4th, SYSTEM_RANK, FUNCT_AR
   using ret_type_t = FUNCT_ARG;
   using funct_arg_t = FUNCT_ARG;
   using funct_args_t = tuple_utils::funct_args_t<ARGS...>;
-  using target_function_t = tuple_utils::target_nonstationary_function_t<funct_arg_t, ARGS...>;
-  using target_function_array_t = tuple_utils::target_function_array_t<target_function_t, SYSTEM_RANK>;
 
+  template<typename FUNCT_ARRAY>
   static funct_args_t
-  evaluate_gradient ( target_function_array_t const& f,
+  evaluate_gradient ( FUNCT_ARRAY const& f,
                       funct_arg_t t,
                       funct_args_t const& y,
                       funct_arg_t tau )
@@ -112,9 +110,9 @@ struct diffsolve_traits<diffsolve_method::runge_kutta_4th, SYSTEM_RANK, FUNCT_AR
   }
 
 private:
-  template <size_t ... Indexes>
+  template <typename FUNCT_ARRAY, size_t ... Indexes>
   static funct_args_t
-  evaluate_gradient_impl ( target_function_array_t const& f,
+  evaluate_gradient_impl ( FUNCT_ARRAY const& f,
                            funct_arg_t t,
                            funct_args_t const& y,
                            funct_arg_t tau,
@@ -127,19 +125,19 @@ private:
     return result;
   }
 
-  template <size_t Index>
+  template <size_t Index, typename FUNCT_ARRAY>
   static funct_arg_t
-  evaluate_partial_delta_impl ( target_function_array_t const& f,
+  evaluate_partial_delta_impl ( FUNCT_ARRAY const& f,
                                 funct_arg_t t,
                                 funct_args_t const& y,
                                 funct_arg_t tau )
   {
     using namespace tuple_utils;
 
-    auto const k0 = tau * f[Index] ( t, y );
-    auto const k1 = tau * f[Index] ( t + tau / 2.0, y + k0 / 2.0 );
-    auto const k2 = tau * f[Index] ( t + tau / 2.0, y + k1 / 2.0 );
-    auto const k3 = tau * f[Index] ( t + tau, y + k2 );
+    auto const k0 = tau * std::get<Index> ( f ) ( t, y );
+    auto const k1 = tau * std::get<Index> ( f ) ( t + tau / 2.0, y + k0 / 2.0 );
+    auto const k2 = tau * std::get<Index> ( f ) ( t + tau / 2.0, y + k1 / 2.0 );
+    auto const k3 = tau * std::get<Index> ( f ) ( t + tau, y + k2 );
 
     return  ( k0 + 2.0 * k1 + 2.0 * k2 + k3 ) / 6.0;
   }
@@ -153,11 +151,10 @@ struct diffsolve_traits<diffsolve_method::runge_kutta_felberga_7th, SYSTEM_RANK,
   using ret_type_t = FUNCT_ARG;
   using funct_arg_t = FUNCT_ARG;
   using funct_args_t = tuple_utils::funct_args_t<ARGS...>;
-  using target_function_t = tuple_utils::target_nonstationary_function_t<funct_arg_t, ARGS...>;
-  using target_function_array_t = tuple_utils::target_function_array_t<target_function_t, SYSTEM_RANK>;
 
+  template<typename FUNCT_ARRAY>
   static funct_args_t
-  evaluate_gradient ( target_function_array_t const& f,
+  evaluate_gradient ( FUNCT_ARRAY const& f,
                       funct_arg_t t,
                       funct_args_t const& y,
                       funct_arg_t tau )
@@ -169,9 +166,9 @@ struct diffsolve_traits<diffsolve_method::runge_kutta_felberga_7th, SYSTEM_RANK,
   }
 
 private:
-  template <size_t ... Indexes>
+  template <typename FUNCT_ARRAY, size_t ... Indexes>
   static funct_args_t
-  evaluate_gradient_impl ( target_function_array_t const& f,
+  evaluate_gradient_impl ( FUNCT_ARRAY const& f,
                            funct_arg_t t,
                            funct_args_t const& y,
                            funct_arg_t tau,
@@ -184,23 +181,23 @@ private:
     return result;
   }
 
-  template <size_t Index>
+  template <size_t Index, typename FUNCT_ARRAY>
   static funct_arg_t
-  evaluate_partial_delta_impl ( target_function_array_t const& f,
+  evaluate_partial_delta_impl ( FUNCT_ARRAY const& f,
                                 funct_arg_t t,
                                 funct_args_t const& y,
                                 funct_arg_t tau )
   {
     using namespace tuple_utils;
 
-    auto const k1 = tau * f[Index] ( t, y );
-    auto const k2 = tau * f[Index] ( t + ( 1.0 / 4.0 ) * tau, y + ( 1.0 / 4.0 ) * k1 );
-    auto const k3 = tau * f[Index] ( t + ( 3.0 / 8.0 ) * tau, y + ( 3.0 / 32.0 ) * k1 + ( 9.0 / 32.0 ) * k2 );
-    auto const k4 = tau * f[Index] ( t + ( 12.0 / 13.0 ) * tau,
+    auto const k1 = tau * std::get<Index> ( f ) ( t, y );
+    auto const k2 = tau * std::get<Index> ( f ) ( t + ( 1.0 / 4.0 ) * tau, y + ( 1.0 / 4.0 ) * k1 );
+    auto const k3 = tau * std::get<Index> ( f ) ( t + ( 3.0 / 8.0 ) * tau, y + ( 3.0 / 32.0 ) * k1 + ( 9.0 / 32.0 ) * k2 );
+    auto const k4 = tau * std::get<Index> ( f ) ( t + ( 12.0 / 13.0 ) * tau,
                                      y + ( 1932.0 / 2197.0 ) * k1 - ( 7200.0 / 2197.0 ) * k2 + ( 7296.0 / 2197.0 ) * k3 );
-    auto const k5 = tau * f[Index] ( t + tau, y + ( 439.0 / 216.0 ) * k1 - 8.0 * k2 + ( 3680.0 / 513.0 ) * k3 -
+    auto const k5 = tau * std::get<Index> ( f ) ( t + tau, y + ( 439.0 / 216.0 ) * k1 - 8.0 * k2 + ( 3680.0 / 513.0 ) * k3 -
                                      ( 845.0 / 4104.0 ) * k4 );
-    auto const k6 = tau * f[Index] ( t + ( 1.0 / 2.0 ) * tau,
+    auto const k6 = tau * std::get<Index> ( f ) ( t + ( 1.0 / 2.0 ) * tau,
                                      y - ( 8.0 / 27.0 ) * k1 + 2.0 * k2 - ( 3544.0 / 2565.0 ) * k3 + ( 1859.0 / 4104.0 ) * k4 -
                                      ( 11.0 / 40.0 ) * k5 );
 
@@ -216,24 +213,26 @@ private:
 
 // taken from
 // https://habr.com/en/post/418139/
+//
+// FUNCT_ARRAY is anything std::get reaches the right-hand sides with, a std::tuple of
+// lambdas keeps every call inlinable, diffsolve below keeps the std::function array
 template<diffsolve_method METHOD_ENUM,
-         size_t SYSTEM_RANK,
+         typename FUNCT_ARRAY,
          typename FUNCT_ARG,
          typename ... ARGS>
-struct diffsolve
+struct basic_diffsolve
 {
-  static constexpr auto const system_rank = SYSTEM_RANK;
+  static constexpr auto const system_rank = std::tuple_size<FUNCT_ARRAY>::value;
 
   using ret_type_t = FUNCT_ARG;
   using funct_arg_t = FUNCT_ARG;
   using funct_args_t = tuple_utils::funct_args_t<ARGS...>;
 
-  using target_function_t = tuple_utils::target_nonstationary_function_t<funct_arg_t, ARGS...>;
-  using target_function_array_t = tuple_utils::target_function_array_t<target_function_t, system_rank>;
+  using target_function_array_t = FUNCT_ARRAY;
 
-  diffsolve ( funct_arg_t const& step,
-              funct_args_t const& min_point,
-              target_function_array_t const& funct )
+  basic_diffsolve ( funct_arg_t const& step,
+                    funct_args_t const& min_point,
+                    target_function_array_t const& funct )
     : step ( step )
     , min_point ( min_point )
     , funct ( funct )
@@ -246,10 +245,8 @@ struct diffsolve
   funct_args_t evaluate_gradient ( funct_arg_t t,
                                    funct_args_t const& y ) const
   {
-    constexpr auto const evaluate_gradient_funct_ptr =
-      diffsolve_details::diffsolve_traits<METHOD_ENUM, SYSTEM_RANK, FUNCT_ARG, ARGS...>::evaluate_gradient;
-
-    return  evaluate_gradient_funct_ptr ( funct, t, y, step );
+    return diffsolve_details::diffsolve_traits<METHOD_ENUM, system_rank, FUNCT_ARG, ARGS...>::evaluate_gradient (
+             funct, t, y, step );
   }
 
   funct_args_t from_too ( funct_arg_t const t0,
@@ -284,4 +281,27 @@ private:
   target_function_array_t const funct;
 };
 
+template<diffsolve_method METHOD_ENUM,
+         size_t SYSTEM_RANK,
+         typename FUNCT_ARG,
+         typename ... ARGS>
+using diffsolve = basic_diffsolve < METHOD_ENUM,
+      tuple_utils::target_function_array_t<tuple_utils::target_nonstationary_function_t<FUNCT_ARG, ARGS...>, SYSTEM_RANK>,
+      FUNCT_ARG, ARGS... >;
+
+// one right-hand side per equation, stored in a std::tuple
+template<diffsolve_method METHOD_ENUM,
+         typename FUNCT_ARG,
+         typename ... ARGS,
+         typename ... FUNCTS>
+auto make_diffsolve ( FUNCT_ARG const& step,
+                      tuple_utils::funct_args_t<ARGS...> const& min_point,
+                      FUNCTS&& ... functs )
+{
+  using funct_array_t = std::tuple<std::decay_t<FUNCTS>...>;
+
+  return basic_diffsolve<METHOD_ENUM, funct_array_t, FUNCT_ARG, ARGS...> ( step, min_point,
+         funct_array_t ( std::forward<FUNCTS> ( functs )... ) );
+}
+
 } // namespace diffsolve
@@ -4,6 +4,7 @@
 
 #include <type_traits>
 #include <functional>
+#include <utility>
 
 namespace integral
 {
@@ -30,6 +31,7 @@ constexpr auto middle_div()
   }
 }
 
+// the type-erased adapter, the methods take any callable and inline it
 template<typename RET_TYPE, typename ARG_TYPE>
 using target_funct_t = std::function<RET_TYPE ( ARG_TYPE ) >;
 
@@ -45,7 +47,7 @@ template<integral_method METOD_ENUM,
          typename TARGET_FUNCT>
 struct integral_traits
 {
-  static RET_TYPE method ( ARG_TYPE, ARG_TYPE, ARG_TYPE, TARGET_FUNCT )
+  static RET_TYPE method ( ARG_TYPE, ARG_TYPE, ARG_TYPE, TARGET_FUNCT& )
   {
     static_assert ( always_false<RET_TYPE>(), "Implement specialization for METOD_ENUM instead" );
     return {};
@@ -53,14 +55,15 @@ struct integral_traits
 };
 
 template<typename RET_TYPE,
-         typename ARG_TYPE>
+         typename ARG_TYPE,
+         typename TARGET_FUNCT>
 struct integral_traits<integral_method::rectangle,
          RET_TYPE,
          ARG_TYPE,
-         target_funct_t<RET_TYPE, ARG_TYPE>>
+         TARGET_FUNCT>
 {
   static RET_TYPE method ( ARG_TYPE const from, ARG_TYPE const to, ARG_TYPE const step,
-                           target_funct_t<RET_TYPE, ARG_TYPE> funct )
+                           TARGET_FUNCT& funct )
   {
     auto const fa = funct ( from );
     auto const fb = funct ( to );
@@ -81,14 +84,15 @@ struct integral_traits<integral_method::rectangle,
 };
 
 template<typename RET_TYPE,
-         typename ARG_TYPE>
+         typename ARG_TYPE,
+         typename TARGET_FUNCT>
 struct integral_traits<integral_method::trapezoid,
          RET_TYPE,
          ARG_TYPE,
-         target_funct_t<RET_TYPE, ARG_TYPE>>
+         TARGET_FUNCT>
 {
   static RET_TYPE method ( ARG_TYPE const from, ARG_TYPE const to, ARG_TYPE const step,
-                           target_funct_t<RET_TYPE, ARG_TYPE> funct )
+                           TARGET_FUNCT& funct )
   {
     auto const fa = funct ( from );
     auto const fb = funct ( to );
@@ -110,18 +114,20 @@ struct integral_traits<integral_method::trapezoid,
 
 }  // namespace integral_details
 
+// FUNCT is stored and called as is, integral below keeps the std::function flavour
 template<integral_method METOD_ENUM,
          typename RET_TYPE,
-         typename ARG_TYPE>
-struct integral
+         typename ARG_TYPE,
+         typename FUNCT>
+struct basic_integral
 {
   using ret_type_t = RET_TYPE;
   using funct_arg_t = ARG_TYPE;
-  using target_funct_t = integral_details::target_funct_t<ret_type_t, funct_arg_t>;
+  using target_funct_t = FUNCT;
 
-  integral ( funct_arg_t step, target_funct_t funct )
+  basic_integral ( funct_arg_t step, target_funct_t funct )
     : step ( step )
-    , funct ( funct )
+    , funct ( std::move ( funct ) )
   {
     static_assert ( std::is_arithmetic<RET_TYPE>::value, "RET_TYPE should have an arithmetic type" );
     static_assert ( std::is_arithmetic<ARG_TYPE>::value, "ARG_TYPE should have an arithmetic type" );
@@ -129,16 +135,28 @@ struct integral
 
   RET_TYPE from_to ( funct_arg_t const& from, funct_arg_t const& to )
   {
-    auto const method_ptr =
-      integral_details::integral_traits<METOD_ENUM, RET_TYPE, ARG_TYPE, target_funct_t>::method;
-
-    return method_ptr ( from, to, step, funct );
+    return integral_details::integral_traits<METOD_ENUM, RET_TYPE, ARG_TYPE, target_funct_t>::method ( from, to, step,
+           funct );
   }
 
 private:
   funct_arg_t const step;
-  target_funct_t const funct;
+  target_funct_t funct;
 };
 
+template<integral_method METOD_ENUM,
+         typename RET_TYPE,
+         typename ARG_TYPE>
+using integral = basic_integral<METOD_ENUM, RET_TYPE, ARG_TYPE, integral_details::target_funct_t<RET_TYPE, ARG_TYPE>>;
+
+template<integral_method METOD_ENUM,
+         typename RET_TYPE,
+         typename ARG_TYPE,
+         typename FUNCT>
+auto make_integral ( ARG_TYPE step, FUNCT&& funct )
+{
+  return basic_integral<METOD_ENUM, RET_TYPE, ARG_TYPE, std::decay_t<FUNCT>> ( step, std::forward<FUNCT> ( funct ) );
+}
+
 }  // namespace integral
 
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <cmath>
+#include <ratio>
+#include <algorithm>
+
+namespace nnet
+{
+
+namespace activation
+{
+
+// every policy provides apply ( x ) and derivative ( y ),
+// the derivative is expressed through the activated value y = apply ( x )
+
+struct identity_t
+{
+  template<typename T>
+  static T apply ( T const x ) noexcept
+  {
+    return x;
+  }
+
+  template<typename T>
+  static T derivative ( [[maybe_unused]] T const y ) noexcept
+  {
+    return T{1};
+  }
+};
+
+struct relu_t
+{
+  template<typename T>
+  static T apply ( T const x ) noexcept
+  {
+    return x > T{} ? x : T{};
+  }
+
+  template<typename T>
+  static T derivative ( T const y ) noexcept
+  {
+    return y > T{} ? T{1} : T{};
+  }
+};
+
+template<typename SLOPE_RATIO = std::ratio<1, 100>>
+struct leaky_relu_t
+{
+  template<typename T>
+  static constexpr T slope() noexcept
+  {
+    return static_cast<T> ( SLOPE_RATIO::num ) / static_cast<T> ( SLOPE_RATIO::den );
+  }
+
+  template<typename T>
+  static T apply ( T const x ) noexcept
+  {
+    return x > T{} ? x : x * slope<T>();
+  }
+
+  template<typename T>
+  static T derivative ( T const y ) noexcept
+  {
+    return y > T{} ? T{1} : slope<T>();
+  }
+};
+
+struct sigmoid_t
+{
+  template<typename T>
+  static T apply ( T const x ) noexcept
+  {
+    return T{1} / ( T{1} + std::exp ( -x ) );
+  }
+
+  template<typename T>
+  static T derivative ( T const y ) noexcept
+  {
+    return y * ( T{1} - y );
+  }
+};
+
+struct tanh_t
+{
+  template<typename T>
+  static T apply ( T const x ) noexcept
+  {
+    return std::tanh ( x );
+  }
+
+  template<typename T>
+  static T derivative ( T const y ) noexcept
+  {
+    return T{1} - y * y;
+  }
+};
+
+// branch-free [7/6] Pade approximation, the absolute error is below 1e-4,
+// made of multiplications, one division and a clamp only, so it vectorizes
+struct fast_tanh_t
+{
+  template<typename T>
+  static T apply ( T const x ) noexcept
+  {
+    auto const xc = std::min ( std::max ( x, T ( -4.97 ) ), T ( 4.97 ) );
+    auto const x2 = xc * xc;
+
+    auto const p = xc * ( T ( 135135 ) + x2 * ( T ( 17325 ) + x2 * ( T ( 378 ) + x2 ) ) );
+    auto const q = T ( 135135 ) + x2 * ( T ( 62370 ) + x2 * ( T ( 3150 ) + x2 * T ( 28 ) ) );
+
+    return std::min ( std::max ( p / q, T ( -1 ) ), T ( 1 ) );
+  }
+
+  template<typename T>
+  static T derivative ( T const y ) noexcept
+  {
+    return tanh_t::derivative ( y );
+  }
+};
+
+// sigmoid ( x ) = ( tanh ( x / 2 ) + 1 ) / 2
+struct fast_sigmoid_t
+{
+  template<typename T>
+  static T apply ( T const x ) noexcept
+  {
+    return T ( 0.5 ) * fast_tanh_t::apply ( T ( 0.5 ) * x ) + T ( 0.5 );
+  }
+
+  template<typename T>
+  static T derivative ( T const y ) noexcept
+  {
+    return sigmoid_t::derivative ( y );
+  }
+};
+
+}  // namespace activation
+
+} // namespace nnet
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <algorithm>
+#include <type_traits>
+
+namespace nnet
+{
+
+// bump allocator over a single aligned block, nothing is freed until reset ()
+struct arena_t
+{
+  static constexpr size_t const alignment = 64;
+
+  static constexpr size_t aligned_size ( size_t const bytes ) noexcept
+  {
+    return ( bytes + alignment - 1 ) / alignment * alignment;
+  }
+
+  template<typename T>
+  static constexpr size_t required_bytes ( size_t const count ) noexcept
+  {
+    return aligned_size ( count * sizeof ( T ) );
+  }
+
+  explicit arena_t ( size_t const capacity )
+    : buffer ( static_cast<uint8_t*> ( ::operator new ( aligned_size ( capacity ), std::align_val_t ( alignment ) ) ) )
+    , capacity ( aligned_size ( capacity ) )
+  {
+  }
+
+  arena_t ( arena_t const& ) = delete;
+  arena_t& operator= ( arena_t const& ) = delete;
+
+  ~arena_t()
+  {
+    ::operator delete ( buffer, std::align_val_t ( alignment ) );
+  }
+
+  // zero initialized storage for count objects of the trivial type T or nullptr if the arena is exhausted
+  template<typename T>
+  T* allocate ( size_t const count ) noexcept
+  {
+    static_assert ( std::is_trivially_destructible<T>::value, "The arena never runs destructors" );
+    static_assert ( alignof ( T ) <= alignment, "The type is over-aligned for the arena" );
+
+    auto const bytes = required_bytes<T> ( count );
+
+    if ( bytes > capacity - used )
+    {
+      return nullptr;
+    }
+
+    auto* const result = buffer + used;
+    used += bytes;
+
+    std::fill ( result, result + bytes, uint8_t{} );
+
+    return reinterpret_cast<T*> ( result );
+  }
+
+  void reset() noexcept
+  {
+    used = 0;
+  }
+
+  size_t get_capacity() const noexcept
+  {
+    return capacity;
+  }
+
+  size_t get_used() const noexcept
+  {
+    return used;
+  }
+
+private:
+  uint8_t* const buffer;
+  size_t const capacity;
+  size_t used{};
+};
+
+} // namespace nnet
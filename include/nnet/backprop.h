@@ -0,0 +1,274 @@
+#pragma once
+
+#include <nnet/neuron_line.h>
+#include <nnet/neuron_network.h>
+
+#include <cstddef>
+#include <array>
+#include <tuple>
+#include <utility>
+#include <algorithm>
+
+namespace nnet
+{
+
+// accumulates dL/dW of the line into koef_gradient ( stored in the line layout )
+// and writes dL/dx to input_gradient unless it is nullptr,
+// output is the activated line output for the given input
+template<typename LINE_T>
+void line_backward ( LINE_T const& line,
+                     typename LINE_T::input_t const* input,
+                     typename LINE_T::output_t const* output,
+                     typename LINE_T::output_t const* output_gradient,
+                     typename LINE_T::koef_t* koef_gradient,
+                     typename LINE_T::input_t* input_gradient ) noexcept
+{
+  using layout_traits = typename LINE_T::layout_traits;
+  using activation_t = typename LINE_T::activation_t;
+
+  constexpr auto const input_dimension = LINE_T::input_dimension;
+  constexpr auto const line_dimension = LINE_T::line_dimension;
+
+  std::array<typename LINE_T::output_t, line_dimension> delta;
+
+  for ( size_t k = 0; k < line_dimension; ++k )
+  {
+    delta[k] = output_gradient[k] * activation_t::derivative ( output[k] );
+  }
+
+  auto const* koefs = line.koefs_data();
+
+  if constexpr ( LINE_T::layout == line_layout::row_major )
+  {
+    if ( input_gradient )
+    {
+      std::fill ( input_gradient, input_gradient + input_dimension, typename LINE_T::input_t{} );
+    }
+
+    for ( size_t k = 0; k < line_dimension; ++k )
+    {
+      auto* gradient_row = koef_gradient + layout_traits::koef_index ( k, 0 );
+      auto const* koef_row = koefs + layout_traits::koef_index ( k, 0 );
+
+      for ( size_t i = 0; i < input_dimension; ++i )
+      {
+        gradient_row[i] += delta[k] * input[i];
+      }
+
+      if ( input_gradient )
+      {
+        for ( size_t i = 0; i < input_dimension; ++i )
+        {
+          input_gradient[i] += delta[k] * koef_row[i];
+        }
+      }
+    }
+  }
+  else
+  {
+    for ( size_t i = 0; i < input_dimension; ++i )
+    {
+      auto* gradient_column = koef_gradient + layout_traits::koef_index ( 0, i );
+      auto const* koef_column = koefs + layout_traits::koef_index ( 0, i );
+
+      typename LINE_T::input_t sum{};
+
+      for ( size_t k = 0; k < line_dimension; ++k )
+      {
+        gradient_column[k] += delta[k] * input[i];
+        sum += delta[k] * koef_column[k];
+      }
+
+      if ( input_gradient )
+      {
+        input_gradient[i] = sum;
+      }
+    }
+  }
+}
+
+namespace backprop_details
+{
+
+template<typename MODEL_T>
+struct model_traits;
+
+template<typename INPUT_T,
+         size_t INPUT_DIMENSION,
+         size_t LINE_DIMENSION,
+         line_layout LAYOUT,
+         typename ACTIVATION>
+struct model_traits<neuron_line_t<INPUT_T, INPUT_DIMENSION, LINE_DIMENSION, LAYOUT, ACTIVATION>>
+{
+  using model_t = neuron_line_t<INPUT_T, INPUT_DIMENSION, LINE_DIMENSION, LAYOUT, ACTIVATION>;
+  using lines_t = std::tuple<model_t>;
+
+  template<size_t Index>
+  static model_t& get_line ( model_t& model ) noexcept
+  {
+    return model;
+  }
+
+  template<size_t Index>
+  static model_t const& get_line ( model_t const& model ) noexcept
+  {
+    return model;
+  }
+};
+
+template<typename ... LINES>
+struct model_traits<neuron_network_t<LINES...>>
+{
+  using model_t = neuron_network_t<LINES...>;
+  using lines_t = typename model_t::lines_t;
+
+  template<size_t Index>
+  static auto& get_line ( model_t& model ) noexcept
+  {
+    return model.template get_line<Index>();
+  }
+
+  template<size_t Index>
+  static auto const& get_line ( model_t const& model ) noexcept
+  {
+    return model.template get_line<Index>();
+  }
+};
+
+template<typename LINES_T, size_t ... Indexes>
+constexpr size_t max_dimension ( std::index_sequence<Indexes...> )
+{
+  return std::max ( { std::tuple_element_t<Indexes, LINES_T>::input_dimension... } );
+}
+
+template<typename LINES_T>
+struct workspace_types;
+
+template<typename ... LINES>
+struct workspace_types<std::tuple<LINES...>>
+{
+  using activations_t = std::tuple<typename LINES::output_array_t...>;
+  using gradients_t = std::tuple<typename LINES::koef_matrix_t...>;
+};
+
+}  // namespace backprop_details
+
+// keeps every layer activation of the forward pass and the accumulated
+// weight gradients, so a backward sweep costs the same as a forward one
+template<typename MODEL_T>
+struct backprop_t
+{
+  using model_traits = backprop_details::model_traits<MODEL_T>;
+  using lines_t = typename model_traits::lines_t;
+  using activations_t = typename backprop_details::workspace_types<lines_t>::activations_t;
+  using gradients_t = typename backprop_details::workspace_types<lines_t>::gradients_t;
+
+  static constexpr size_t const layer_count = std::tuple_size<lines_t>::value;
+
+  using first_line_t = std::tuple_element_t<0, lines_t>;
+  using last_line_t = std::tuple_element_t < layer_count - 1, lines_t >;
+  using input_t = typename first_line_t::input_t;
+  using output_t = typename last_line_t::output_t;
+  using input_array_t = typename first_line_t::input_array_t;
+  using output_array_t = typename last_line_t::output_array_t;
+
+  static constexpr size_t const delta_dimension =
+    backprop_details::max_dimension<lines_t> ( std::make_index_sequence<layer_count>() );
+
+  void forward ( MODEL_T const& model, input_array_t const& input ) noexcept
+  {
+    forward_impl<0> ( model, input.data() );
+  }
+
+  // accumulates the weight gradients for dL/dy = output_gradient,
+  // forward() should be called for the same input before
+  void backward ( MODEL_T const& model, input_array_t const& input, output_t const* output_gradient ) noexcept
+  {
+    backward_impl < layer_count - 1 > ( model, input.data(), output_gradient );
+  }
+
+  output_array_t const& get_value() const noexcept
+  {
+    return std::get < layer_count - 1 > ( activations );
+  }
+
+  template<size_t Index>
+  auto const& get_gradient() const noexcept
+  {
+    return std::get<Index> ( gradients );
+  }
+
+  void zero_gradient() noexcept
+  {
+    std::apply ( [] ( auto& ... gradient )
+    {
+      ( gradient.fill ( {} ), ... );
+    }, gradients );
+  }
+
+  // funct ( koefs, gradient, size ) is called for every line of the model
+  template<typename FUNCT>
+  void for_each_koefs ( MODEL_T& model, FUNCT&& funct ) noexcept
+  {
+    for_each_koefs_impl ( model, funct, std::make_index_sequence<layer_count>() );
+  }
+
+private:
+  template<size_t Index>
+  input_t const* layer_input ( input_t const* input ) const noexcept
+  {
+    if constexpr ( Index == 0 )
+    {
+      return input;
+    }
+    else
+    {
+      return std::get < Index - 1 > ( activations ).data();
+    }
+  }
+
+  template<size_t Index>
+  void forward_impl ( MODEL_T const& model, input_t const* input ) noexcept
+  {
+    model_traits::template get_line<Index> ( model ).apply ( layer_input<Index> ( input ),
+        std::get<Index> ( activations ).data() );
+
+    if constexpr ( Index + 1 < layer_count )
+    {
+      forward_impl < Index + 1 > ( model, input );
+    }
+  }
+
+  template<size_t Index>
+  void backward_impl ( MODEL_T const& model, input_t const* input, output_t const* output_gradient ) noexcept
+  {
+    auto* const input_gradient = ( Index == 0 ) ? nullptr : deltas[Index % 2].data();
+
+    line_backward ( model_traits::template get_line<Index> ( model ),
+                    layer_input<Index> ( input ),
+                    std::get<Index> ( activations ).data(),
+                    output_gradient,
+                    std::get<Index> ( gradients ).data(),
+                    input_gradient );
+
+    if constexpr ( Index > 0 )
+    {
+      backward_impl < Index - 1 > ( model, input, input_gradient );
+    }
+  }
+
+  template<typename FUNCT, size_t ... Indexes>
+  void for_each_koefs_impl ( MODEL_T& model, FUNCT& funct, std::index_sequence<Indexes...> ) noexcept
+  {
+    ( funct ( model_traits::template get_line<Indexes> ( model ).koefs_data(),
+              std::get<Indexes> ( gradients ).data(),
+              std::get<Indexes> ( gradients ).size() ), ... );
+  }
+
+private:
+  activations_t activations{};
+  gradients_t gradients{};
+  std::array<std::array<input_t, delta_dimension>, 2> deltas{};
+};
+
+} // namespace nnet
@@ -0,0 +1,164 @@
+#pragma once
+
+#include <nnet/simd.h>
+#include <nnet/activation.h>
+
+#include <cstddef>
+#include <array>
+#include <algorithm>
+
+namespace nnet
+{
+
+// a 1-D convolution over [time][channel] samples, the koefs of an output channel are
+// [tap][input channel], so the window of an output position is one contiguous run
+// of the input and every output is a direct dot product with no im2col copy
+template<typename INPUT_T,
+         size_t INPUT_CHANNELS,
+         size_t OUTPUT_CHANNELS,
+         size_t KERNEL_WIDTH,
+         size_t STRIDE = 1,
+         typename ACTIVATION = activation::identity_t>
+struct conv1d_line_t
+{
+  static_assert ( INPUT_CHANNELS > 0 && OUTPUT_CHANNELS > 0, "The channel counts should be positive" );
+  static_assert ( KERNEL_WIDTH > 0 && STRIDE > 0, "The kernel width and the stride should be positive" );
+
+  static constexpr size_t const input_channels = INPUT_CHANNELS;
+  static constexpr size_t const output_channels = OUTPUT_CHANNELS;
+  static constexpr size_t const kernel_width = KERNEL_WIDTH;
+  static constexpr size_t const stride = STRIDE;
+  static constexpr size_t const window_size = KERNEL_WIDTH * INPUT_CHANNELS;
+
+  // the windows still waiting for samples in the streaming mode
+  static constexpr size_t const pending_count = ( KERNEL_WIDTH + STRIDE - 1 ) / STRIDE;
+
+  using activation_t = ACTIVATION;
+  using input_t = INPUT_T;
+  using output_t = input_t;
+  using koef_t = input_t;
+  using sample_t = std::array<input_t, INPUT_CHANNELS>;
+  using output_array_t = std::array<output_t, OUTPUT_CHANNELS>;
+  using koef_array_t = std::array<koef_t, window_size>;
+  using koef_matrix_t = std::array<koef_t, window_size * OUTPUT_CHANNELS>;
+
+  // the partial sums of the open windows of one stream, the koefs are shared
+  struct alignas ( 64 ) stream_context_t
+  {
+    output_array_t const& get_value() const noexcept
+    {
+      return values;
+    }
+
+    void reset() noexcept
+    {
+      sample_count = 0;
+    }
+
+  private:
+    friend struct conv1d_line_t;
+
+    std::array<output_array_t, pending_count> sums{};
+    output_array_t values{};
+    size_t sample_count{};
+  };
+
+  // the number of the output positions of length input samples
+  static constexpr size_t output_length ( size_t const length ) noexcept
+  {
+    return ( length < KERNEL_WIDTH ) ? 0 : ( length - KERNEL_WIDTH ) / STRIDE + 1;
+  }
+
+  size_t size() const noexcept
+  {
+    return OUTPUT_CHANNELS;
+  }
+
+  koef_t* koefs_data() noexcept
+  {
+    return koefs.data();
+  }
+
+  koef_t const* koefs_data() const noexcept
+  {
+    return koefs.data();
+  }
+
+  void set_koefs ( size_t o, koef_array_t const& new_koef ) noexcept
+  {
+    std::copy ( new_koef.cbegin(), new_koef.cend(), koefs.begin() + o * window_size );
+  }
+
+  // input is [length][INPUT_CHANNELS], output receives [output_length ( length )][OUTPUT_CHANNELS]
+  void apply ( input_t const* input, size_t const length, output_t* output ) const noexcept
+  {
+    auto const positions = output_length ( length );
+
+    for ( size_t p = 0; p < positions; ++p )
+    {
+      auto const* const window = input + p * STRIDE * INPUT_CHANNELS;
+
+      for ( size_t o = 0; o < OUTPUT_CHANNELS; ++o )
+      {
+        output[p * OUTPUT_CHANNELS + o] =
+          activation_t::apply ( simd::dot<koef_t> ( koefs.data() + o * window_size, window, window_size ) );
+      }
+    }
+  }
+
+  // consumes the next sample of the stream, every sample is multiplied only with the taps
+  // of the windows it belongs to; true when a window is complete and its output is in the context
+  bool push ( input_t const* sample, stream_context_t& context ) const noexcept
+  {
+    auto const t = context.sample_count++;
+    auto const last = t / STRIDE;
+
+    if ( t % STRIDE == 0 )
+    {
+      auto& sums = context.sums[last % pending_count];
+      std::fill ( sums.begin(), sums.end(), output_t{} );
+    }
+
+    bool result = false;
+
+    // the windows starting at p * STRIDE <= t, newest first, while t is inside them
+    for ( size_t p = last + 1; p-- > 0; )
+    {
+      auto const tap = t - p * STRIDE;
+
+      if ( tap >= KERNEL_WIDTH )
+      {
+        break;
+      }
+
+      auto& sums = context.sums[p % pending_count];
+
+      for ( size_t o = 0; o < OUTPUT_CHANNELS; ++o )
+      {
+        sums[o] += simd::dot<koef_t> ( koefs.data() + o * window_size + tap * INPUT_CHANNELS, sample, INPUT_CHANNELS );
+      }
+
+      if ( tap + 1 == KERNEL_WIDTH )
+      {
+        for ( size_t o = 0; o < OUTPUT_CHANNELS; ++o )
+        {
+          context.values[o] = activation_t::apply ( sums[o] );
+        }
+
+        result = true;
+      }
+    }
+
+    return result;
+  }
+
+  bool push ( sample_t const& sample, stream_context_t& context ) const noexcept
+  {
+    return push ( sample.data(), context );
+  }
+
+private:
+  alignas ( 64 ) koef_matrix_t koefs{};
+};
+
+} // namespace nnet
@@ -0,0 +1,252 @@
+#pragma once
+
+#include <nnet/simd.h>
+#include <nnet/activation.h>
+#include <nnet/arena.h>
+
+#include <cstddef>
+#include <new>
+#include <array>
+#include <algorithm>
+
+namespace nnet
+{
+
+// runtime-shaped counterpart of neuron_line_t, the row-major koefs
+// and the outputs live in memory owned by somebody else ( usually an arena_t )
+template<typename INPUT_T>
+struct dynamic_neuron_line_t
+{
+  using input_t = INPUT_T;
+  using output_t = input_t;
+  using koef_t = input_t;
+
+  static size_t required_bytes ( size_t const input_dimension, size_t const line_dimension ) noexcept
+  {
+    return arena_t::required_bytes<koef_t> ( input_dimension * line_dimension )
+           + arena_t::required_bytes<output_t> ( line_dimension );
+  }
+
+  dynamic_neuron_line_t() = default;
+
+  dynamic_neuron_line_t ( size_t const input_dimension, size_t const line_dimension,
+                          koef_t* koefs, output_t* values ) noexcept
+    : input_dimension ( input_dimension )
+    , line_dimension ( line_dimension )
+    , koefs ( koefs )
+    , values ( values )
+  {
+  }
+
+  dynamic_neuron_line_t ( size_t const input_dimension, size_t const line_dimension, arena_t& arena ) noexcept
+    : input_dimension ( input_dimension )
+    , line_dimension ( line_dimension )
+    , koefs ( arena.allocate<koef_t> ( input_dimension * line_dimension ) )
+    , values ( arena.allocate<output_t> ( line_dimension ) )
+  {
+  }
+
+  bool is_valid() const noexcept
+  {
+    return koefs && values;
+  }
+
+  size_t get_input_dimension() const noexcept
+  {
+    return input_dimension;
+  }
+
+  size_t size() const noexcept
+  {
+    return line_dimension;
+  }
+
+  koef_t* koefs_data() noexcept
+  {
+    return koefs;
+  }
+
+  koef_t const* koefs_data() const noexcept
+  {
+    return koefs;
+  }
+
+  void set_koefs ( size_t const k, koef_t const* new_koef ) noexcept
+  {
+    std::copy ( new_koef, new_koef + input_dimension, koefs + k * input_dimension );
+  }
+
+  template<typename ACTIVATION = activation::identity_t>
+  void apply ( input_t const* input ) noexcept
+  {
+    apply<ACTIVATION> ( input, values );
+  }
+
+  template<typename ACTIVATION = activation::identity_t>
+  void apply ( input_t const* input, output_t* output ) const noexcept
+  {
+    for ( size_t k = 0; k < line_dimension; ++k )
+    {
+      output[k] = ACTIVATION::apply ( simd::dot<koef_t> ( koefs + k * input_dimension, input, input_dimension ) );
+    }
+  }
+
+  output_t const* get_value() const noexcept
+  {
+    return values;
+  }
+
+private:
+  size_t input_dimension{};
+  size_t line_dimension{};
+  koef_t* koefs{};
+  output_t* values{};
+};
+
+// a stack of dynamic lines, dimensions[0] is the network input and
+// dimensions[i] the output of the line i - 1; the line descriptors, every koef,
+// the ping-pong buffers and the output are carved from one arena
+template<typename INPUT_T,
+         typename HIDDEN_ACTIVATION = activation::identity_t,
+         typename OUTPUT_ACTIVATION = HIDDEN_ACTIVATION>
+struct dynamic_network_t
+{
+  using input_t = INPUT_T;
+  using output_t = input_t;
+  using line_t = dynamic_neuron_line_t<input_t>;
+
+  // with_koefs is false for networks over external koefs
+  static size_t required_bytes ( size_t const* dimensions, size_t const dimension_count,
+                                 bool const with_koefs = true ) noexcept
+  {
+    if ( dimension_count < 2 )
+    {
+      return 0;
+    }
+
+    size_t result = arena_t::required_bytes<line_t> ( dimension_count - 1 );
+    size_t hidden_dimension = 1;
+
+    for ( size_t i = 1; i < dimension_count; ++i )
+    {
+      if ( with_koefs )
+      {
+        result += arena_t::required_bytes<input_t> ( dimensions[i - 1] * dimensions[i] );
+      }
+
+      if ( i + 1 < dimension_count )
+      {
+        hidden_dimension = std::max ( hidden_dimension, dimensions[i] );
+      }
+    }
+
+    return result
+           + 2 * arena_t::required_bytes<input_t> ( hidden_dimension )
+           + arena_t::required_bytes<output_t> ( dimensions[dimension_count - 1] );
+  }
+
+  // koefs[i] are the row-major koefs of the line i, when given the lines point at them
+  // instead of carving the koefs from the arena
+  dynamic_network_t ( arena_t& arena, size_t const* dimensions, size_t const dimension_count,
+                      input_t* const* koefs = nullptr ) noexcept
+  {
+    if ( dimension_count < 2 )
+    {
+      return;
+    }
+
+    auto* const line_storage = arena.allocate<line_t> ( dimension_count - 1 );
+
+    if ( !line_storage )
+    {
+      return;
+    }
+
+    size_t hidden_dimension = 1;
+
+    for ( size_t i = 1; i < dimension_count; ++i )
+    {
+      // the hidden outputs go to the shared ping-pong buffers, so the lines own no values
+      auto* const line = new ( line_storage + i - 1 ) line_t ( dimensions[i - 1], dimensions[i],
+          koefs ? koefs[i - 1] : arena.allocate<input_t> ( dimensions[i - 1] * dimensions[i] ), nullptr );
+
+      if ( !line->koefs_data() )
+      {
+        return;
+      }
+
+      if ( i + 1 < dimension_count )
+      {
+        hidden_dimension = std::max ( hidden_dimension, dimensions[i] );
+      }
+    }
+
+    buffers[0] = arena.allocate<input_t> ( hidden_dimension );
+    buffers[1] = arena.allocate<input_t> ( hidden_dimension );
+    values = arena.allocate<output_t> ( dimensions[dimension_count - 1] );
+
+    if ( buffers[0] && buffers[1] && values )
+    {
+      lines = line_storage;
+      line_count = dimension_count - 1;
+    }
+  }
+
+  bool is_valid() const noexcept
+  {
+    return lines != nullptr;
+  }
+
+  size_t get_line_count() const noexcept
+  {
+    return line_count;
+  }
+
+  line_t& get_line ( size_t const i ) noexcept
+  {
+    return lines[i];
+  }
+
+  line_t const& get_line ( size_t const i ) const noexcept
+  {
+    return lines[i];
+  }
+
+  // 0 for an invalid network
+  size_t size() const noexcept
+  {
+    return is_valid() ? lines[line_count - 1].size() : 0;
+  }
+
+  // an invalid network has no lines and no values, nothing is written then
+  void apply ( input_t const* input ) noexcept
+  {
+    if ( !is_valid() )
+    {
+      return;
+    }
+
+    for ( size_t i = 0; i + 1 < line_count; ++i )
+    {
+      auto* const hidden = buffers[i % 2];
+
+      lines[i].template apply<HIDDEN_ACTIVATION> ( input, hidden );
+      input = hidden;
+    }
+
+    lines[line_count - 1].template apply<OUTPUT_ACTIVATION> ( input, values );
+  }
+
+  output_t const* get_value() const noexcept
+  {
+    return values;
+  }
+
+private:
+  line_t* lines{};
+  size_t line_count{};
+  std::array<input_t*, 2> buffers{};
+  output_t* values{};
+};
+
+} // namespace nnet
@@ -0,0 +1,156 @@
+#pragma once
+
+#include <cstddef>
+#include <array>
+#include <algorithm>
+
+namespace nnet
+{
+
+namespace gemm_details
+{
+
+// register block: MR x NR accumulators of the micro kernel
+constexpr size_t const mr = 4;
+constexpr size_t const nr = 4;
+
+// cache block: KC x NC weights are packed once and reused by every batch row
+constexpr size_t const kc = 128;
+constexpr size_t const nc = 64;
+
+template<typename T, typename B_AT>
+void pack_b ( size_t const j0, size_t const n_count,
+              size_t const p0, size_t const k_count,
+              B_AT const& b_at,
+              T* packed )
+{
+  for ( size_t jr = 0; jr < n_count; jr += nr )
+  {
+    for ( size_t p = 0; p < k_count; ++p )
+    {
+      for ( size_t q = 0; q < nr; ++q )
+      {
+        *packed++ = ( jr + q < n_count ) ? b_at ( j0 + jr + q, p0 + p ) : T{};
+      }
+    }
+  }
+}
+
+template<typename T, typename A_ROW, typename EPILOGUE>
+void micro_kernel ( size_t const i0, size_t const m_count,
+                    size_t const j0, size_t const n_count,
+                    size_t const p0, size_t const k_count,
+                    A_ROW const& a_row,
+                    T const* packed,
+                    T* c, size_t const ldc,
+                    bool const accumulate,
+                    bool const last,
+                    EPILOGUE const& epilogue )
+{
+  std::array<std::array<T, nr>, mr> acc{};
+  std::array<T const*, mr> a{};
+
+  for ( size_t r = 0; r < mr; ++r )
+  {
+    a[r] = a_row ( i0 + std::min ( r, m_count - 1 ) ) + p0;
+  }
+
+  for ( size_t p = 0; p < k_count; ++p, packed += nr )
+  {
+    for ( size_t r = 0; r < mr; ++r )
+    {
+      auto const ar = a[r][p];
+
+      for ( size_t q = 0; q < nr; ++q )
+      {
+        acc[r][q] += ar * packed[q];
+      }
+    }
+  }
+
+  for ( size_t r = 0; r < m_count; ++r )
+  {
+    auto* c_row = c + ( i0 + r ) * ldc + j0;
+
+    for ( size_t q = 0; q < n_count; ++q )
+    {
+      auto const sum = accumulate ? c_row[q] + acc[r][q] : acc[r][q];
+      c_row[q] = last ? epilogue ( sum ) : sum;
+    }
+  }
+}
+
+}  // namespace gemm_details
+
+// C[i][j] = epilogue ( sum_p A[i][p] * B[j][p] ), i < n, j < m, p < k
+//
+// a_row ( i ) returns the pointer to the contiguous row i of A,
+// b_at ( j, p ) returns the element B[j][p] and is used only while packing,
+// epilogue is applied in registers when the last block of k is stored.
+template<typename T, typename A_ROW, typename B_AT, typename EPILOGUE>
+void gemm_nt ( size_t const n, size_t const m, size_t const k,
+               A_ROW const& a_row,
+               B_AT const& b_at,
+               T* c, size_t const ldc,
+               EPILOGUE const& epilogue )
+{
+  using namespace gemm_details;
+
+  if ( k == 0 )
+  {
+    for ( size_t i = 0; i < n; ++i )
+    {
+      std::fill ( c + i * ldc, c + i * ldc + m, epilogue ( T{} ) );
+    }
+
+    return;
+  }
+
+  alignas ( 64 ) std::array<T, kc * nc> packed;
+
+  for ( size_t jc = 0; jc < m; jc += nc )
+  {
+    auto const n_block = std::min ( nc, m - jc );
+
+    for ( size_t pc = 0; pc < k; pc += kc )
+    {
+      auto const k_block = std::min ( kc, k - pc );
+
+      pack_b ( jc, n_block, pc, k_block, b_at, packed.data() );
+
+      for ( size_t ic = 0; ic < n; ic += mr )
+      {
+        auto const m_count = std::min ( mr, n - ic );
+
+        for ( size_t jr = 0; jr < n_block; jr += nr )
+        {
+          micro_kernel ( ic, m_count,
+                         jc + jr, std::min ( nr, n_block - jr ),
+                         pc, k_block,
+                         a_row,
+                         packed.data() + jr * k_block,
+                         c, ldc,
+                         pc != 0,
+                         pc + k_block == k,
+                         epilogue );
+        }
+      }
+    }
+  }
+}
+
+template<typename T, typename A_ROW, typename B_AT>
+void gemm_nt ( size_t const n, size_t const m, size_t const k,
+               A_ROW const& a_row,
+               B_AT const& b_at,
+               T* c, size_t const ldc )
+{
+  auto const identity = [] ( T x )
+  {
+    return x;
+  };
+
+  gemm_nt ( n, m, k, a_row, b_at, c, ldc, identity );
+}
+
+} // namespace nnet
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+namespace nnet
+{
+
+// 16 bit storage formats, the arithmetic is always done in float;
+// the conversions from float round to nearest even
+
+// the upper half of an ieee float: 8 exponent bits, 7 mantissa bits
+struct bf16_t
+{
+  uint16_t bits;
+
+  static bf16_t from_float ( float const x ) noexcept
+  {
+    uint32_t u;
+    std::memcpy ( &u, &x, sizeof ( u ) );
+
+    if ( ( u & 0x7fffffffu ) > 0x7f800000u )
+    {
+      // keep nan a quiet nan
+      return bf16_t{static_cast<uint16_t> ( ( u >> 16 ) | 0x40u )};
+    }
+
+    return bf16_t{static_cast<uint16_t> ( ( u + 0x7fffu + ( ( u >> 16 ) & 1u ) ) >> 16 )};
+  }
+
+  float to_float() const noexcept
+  {
+    uint32_t const u = static_cast<uint32_t> ( bits ) << 16;
+
+    float result;
+    std::memcpy ( &result, &u, sizeof ( result ) );
+
+    return result;
+  }
+};
+
+// ieee binary16: 5 exponent bits, 10 mantissa bits
+struct fp16_t
+{
+  uint16_t bits;
+
+  static fp16_t from_float ( float const x ) noexcept
+  {
+    uint32_t u;
+    std::memcpy ( &u, &x, sizeof ( u ) );
+
+    auto const sign = static_cast<uint32_t> ( ( u >> 16 ) & 0x8000u );
+    auto const exponent = static_cast<int32_t> ( ( u >> 23 ) & 0xffu );
+    auto mantissa = u & 0x7fffffu;
+
+    if ( exponent == 0xff )
+    {
+      return fp16_t{static_cast<uint16_t> ( sign | 0x7c00u | ( mantissa ? 0x200u : 0u ) )};
+    }
+
+    auto const half_exponent = exponent - 127 + 15;
+
+    if ( half_exponent >= 31 )
+    {
+      return fp16_t{static_cast<uint16_t> ( sign | 0x7c00u )};
+    }
+
+    if ( half_exponent <= 0 )
+    {
+      // a subnormal or zero, the dropped bits decide the rounding
+      if ( half_exponent < -10 )
+      {
+        return fp16_t{static_cast<uint16_t> ( sign )};
+      }
+
+      mantissa |= 0x800000u;
+
+      auto const shift = static_cast<uint32_t> ( 14 - half_exponent );
+      auto result = mantissa >> shift;
+      auto const rest = mantissa & ( ( 1u << shift ) - 1 );
+      auto const halfway = 1u << ( shift - 1 );
+
+      if ( rest > halfway || ( rest == halfway && ( result & 1u ) ) )
+      {
+        ++result;
+      }
+
+      return fp16_t{static_cast<uint16_t> ( sign | result )};
+    }
+
+    // a carry out of the mantissa correctly bumps the exponent, up to the infinity
+    auto result = sign | ( static_cast<uint32_t> ( half_exponent ) << 10 ) | ( mantissa >> 13 );
+    auto const rest = mantissa & 0x1fffu;
+
+    if ( rest > 0x1000u || ( rest == 0x1000u && ( result & 1u ) ) )
+    {
+      ++result;
+    }
+
+    return fp16_t{static_cast<uint16_t> ( result )};
+  }
+
+  float to_float() const noexcept
+  {
+    auto const sign = static_cast<uint32_t> ( bits & 0x8000u ) << 16;
+    auto const exponent = static_cast<uint32_t> ( ( bits >> 10 ) & 0x1fu );
+    auto const mantissa = static_cast<uint32_t> ( bits & 0x3ffu );
+
+    uint32_t u;
+
+    if ( exponent == 0 )
+    {
+      // the subnormals are mantissa * 2^-24, exact in float
+      float const magnitude = static_cast<float> ( mantissa ) * 5.9604644775390625e-8f;
+      std::memcpy ( &u, &magnitude, sizeof ( u ) );
+      u |= sign;
+    }
+    else if ( exponent == 0x1f )
+    {
+      u = sign | 0x7f800000u | ( mantissa << 13 );
+    }
+    else
+    {
+      u = sign | ( ( exponent - 15 + 127 ) << 23 ) | ( mantissa << 13 );
+    }
+
+    float result;
+    std::memcpy ( &result, &u, sizeof ( result ) );
+
+    return result;
+  }
+};
+
+} // namespace nnet
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <nnet/half.h>
+#include <nnet/simd.h>
+#include <nnet/neuron_line.h>
+#include <nnet/activation.h>
+
+#include <cstddef>
+#include <array>
+
+namespace nnet
+{
+
+// float activations with row-major bf16_t or fp16_t koefs, half of the memory traffic
+// of a float line; the koefs are widened in registers and accumulated in float
+template<typename HALF_T,
+         size_t INPUT_DIMENSION,
+         size_t LINE_DIMENSION,
+         typename ACTIVATION = activation::identity_t>
+struct half_neuron_line_t
+{
+  static constexpr size_t const input_dimension = INPUT_DIMENSION;
+  static constexpr size_t const line_dimension = LINE_DIMENSION;
+
+  using activation_t = ACTIVATION;
+  using input_t = float;
+  using output_t = float;
+  using koef_t = HALF_T;
+  using input_array_t = std::array<input_t, INPUT_DIMENSION>;
+  using output_array_t = std::array<output_t, LINE_DIMENSION>;
+  using koef_array_t = std::array<float, INPUT_DIMENSION>;
+  using koef_matrix_t = std::array<koef_t, INPUT_DIMENSION * LINE_DIMENSION>;
+
+  half_neuron_line_t() = default;
+
+  template<line_layout LAYOUT>
+  explicit half_neuron_line_t ( neuron_line_t<float, INPUT_DIMENSION, LINE_DIMENSION, LAYOUT, ACTIVATION> const& line ) noexcept
+  {
+    using layout_traits = typename neuron_line_t<float, INPUT_DIMENSION, LINE_DIMENSION, LAYOUT, ACTIVATION>::layout_traits;
+
+    for ( size_t k = 0; k < LINE_DIMENSION; ++k )
+    {
+      for ( size_t i = 0; i < INPUT_DIMENSION; ++i )
+      {
+        koefs[k * INPUT_DIMENSION + i] = koef_t::from_float ( line.koefs_data() [layout_traits::koef_index ( k, i )] );
+      }
+    }
+  }
+
+  size_t size() const noexcept
+  {
+    return LINE_DIMENSION;
+  }
+
+  koef_t const* koefs_data() const noexcept
+  {
+    return koefs.data();
+  }
+
+  void set_koefs ( size_t k, koef_array_t const& new_koef ) noexcept
+  {
+    for ( size_t i = 0; i < INPUT_DIMENSION; ++i )
+    {
+      koefs[k * INPUT_DIMENSION + i] = koef_t::from_float ( new_koef[i] );
+    }
+  }
+
+  void apply ( input_array_t const& input ) noexcept
+  {
+    apply ( input.data(), values.data() );
+  }
+
+  // writes LINE_DIMENSION outputs straight to the caller buffer, the neuron values are left intact
+  void apply ( input_t const* input, output_t* output ) const noexcept
+  {
+    for ( size_t k = 0; k < LINE_DIMENSION; ++k )
+    {
+      output[k] = activation_t::apply ( simd::dot_half ( input, koefs.data() + k * INPUT_DIMENSION, INPUT_DIMENSION ) );
+    }
+  }
+
+  // outputs is a row-major count x LINE_DIMENSION buffer, the neuron values are left intact
+  void apply_batch ( input_array_t const* inputs, size_t count, output_t* outputs ) const noexcept
+  {
+    for ( size_t s = 0; s < count; ++s )
+    {
+      apply ( inputs[s].data(), outputs + s * LINE_DIMENSION );
+    }
+  }
+
+  output_array_t const& get_value() const noexcept
+  {
+    return values;
+  }
+
+private:
+  alignas ( 64 ) koef_matrix_t koefs{};
+  alignas ( 64 ) output_array_t values{};
+};
+
+template<size_t INPUT_DIMENSION, size_t LINE_DIMENSION, typename ACTIVATION = activation::identity_t>
+using bf16_neuron_line_t = half_neuron_line_t<bf16_t, INPUT_DIMENSION, LINE_DIMENSION, ACTIVATION>;
+
+template<size_t INPUT_DIMENSION, size_t LINE_DIMENSION, typename ACTIVATION = activation::identity_t>
+using fp16_neuron_line_t = half_neuron_line_t<fp16_t, INPUT_DIMENSION, LINE_DIMENSION, ACTIVATION>;
+
+} // namespace nnet
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <nnet/neuron_line.h>
+#include <nnet/simd.h>
+
+#include <cstddef>
+#include <array>
+#include <algorithm>
+
+namespace nnet
+{
+
+// keeps the last input and the pre-activation sums of a neuron_line_t, so a change
+// of a few inputs costs O ( changed x LINE_DIMENSION ) instead of a full apply;
+// the sums are recomputed from scratch after refresh_interval changed inputs to
+// bound the rounding drift, and should be refreshed after the koefs change
+template<typename LINE_T>
+struct incremental_line_t
+{
+  using line_t = LINE_T;
+  using layout_traits = typename line_t::layout_traits;
+  using activation_t = typename line_t::activation_t;
+  using input_t = typename line_t::input_t;
+  using output_t = typename line_t::output_t;
+  using input_array_t = typename line_t::input_array_t;
+  using output_array_t = typename line_t::output_array_t;
+
+  static constexpr size_t const input_dimension = line_t::input_dimension;
+  static constexpr size_t const line_dimension = line_t::line_dimension;
+
+  explicit incremental_line_t ( line_t const& line, size_t const refresh_interval = 1024 ) noexcept
+    : line ( line )
+    , refresh_interval ( std::max ( refresh_interval, size_t{1} ) )
+  {
+    refresh();
+  }
+
+  void reset ( input_array_t const& new_input ) noexcept
+  {
+    input = new_input;
+    refresh();
+  }
+
+  // input[indexes[j]] += deltas[j] for every j
+  void update ( size_t const* indexes, input_t const* deltas, size_t const count ) noexcept
+  {
+    for ( size_t j = 0; j < count; ++j )
+    {
+      input[indexes[j]] += deltas[j];
+    }
+
+    pending_changes += count;
+
+    if ( pending_changes >= refresh_interval )
+    {
+      refresh();
+      return;
+    }
+
+    auto const* const koefs = line.koefs_data();
+
+    for ( size_t j = 0; j < count; ++j )
+    {
+      auto const i = indexes[j];
+      auto const delta = deltas[j];
+
+      // a contiguous column for the column-major lines
+      for ( size_t k = 0; k < line_dimension; ++k )
+      {
+        sums[k] += koefs[layout_traits::koef_index ( k, i )] * delta;
+      }
+    }
+
+    activate();
+  }
+
+  // the full product over the kept input
+  void refresh() noexcept
+  {
+    auto const* const koefs = line.koefs_data();
+
+    if constexpr ( line_t::layout == line_layout::row_major )
+    {
+      for ( size_t k = 0; k < line_dimension; ++k )
+      {
+        sums[k] = simd::dot ( koefs + layout_traits::koef_index ( k, 0 ), input.data(), input_dimension );
+      }
+    }
+    else
+    {
+      std::fill ( sums.begin(), sums.end(), output_t{} );
+
+      for ( size_t i = 0; i < input_dimension; ++i )
+      {
+        auto const* const column = koefs + layout_traits::koef_index ( 0, i );
+
+        for ( size_t k = 0; k < line_dimension; ++k )
+        {
+          sums[k] += column[k] * input[i];
+        }
+      }
+    }
+
+    pending_changes = 0;
+    ++refresh_count;
+
+    activate();
+  }
+
+  input_array_t const& get_input() const noexcept
+  {
+    return input;
+  }
+
+  output_array_t const& get_sums() const noexcept
+  {
+    return sums;
+  }
+
+  output_array_t const& get_value() const noexcept
+  {
+    return values;
+  }
+
+  size_t get_refresh_count() const noexcept
+  {
+    return refresh_count;
+  }
+
+private:
+  void activate() noexcept
+  {
+    for ( size_t k = 0; k < line_dimension; ++k )
+    {
+      values[k] = activation_t::apply ( sums[k] );
+    }
+  }
+
+private:
+  line_t const& line;
+  size_t const refresh_interval;
+  size_t pending_changes{};
+  size_t refresh_count{};
+
+  alignas ( 64 ) input_array_t input{};
+  alignas ( 64 ) output_array_t sums{};
+  alignas ( 64 ) output_array_t values{};
+};
+
+} // namespace nnet
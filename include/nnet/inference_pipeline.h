@@ -0,0 +1,267 @@
+#pragma once
+
+#include <utils/ring_buffer.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <algorithm>
+#include <utility>
+#include <type_traits>
+
+namespace nnet
+{
+
+namespace inference_pipeline_details
+{
+
+template<typename MODEL_T, typename = void>
+struct has_apply_batch : std::false_type
+{
+};
+
+template<typename MODEL_T>
+struct has_apply_batch<MODEL_T, std::void_t<decltype ( std::declval<MODEL_T&>().apply_batch (
+           std::declval<typename MODEL_T::input_array_t const*>(), size_t{},
+           std::declval<typename MODEL_T::output_t*>() ) )>> : std::true_type
+{
+};
+
+}  // namespace inference_pipeline_details
+
+// the result slot of one submitted sample, it should outlive the sample processing
+template<typename MODEL_T>
+struct inference_completion_t
+{
+  using output_array_t = typename MODEL_T::output_array_t;
+
+  bool is_ready() const noexcept
+  {
+    return ready.load ( std::memory_order_acquire );
+  }
+
+  void wait() const noexcept
+  {
+    while ( !is_ready() )
+    {
+      std::this_thread::yield();
+    }
+  }
+
+  output_array_t const& get_value() const noexcept
+  {
+    return values;
+  }
+
+private:
+  template<typename, size_t, size_t>
+  friend struct inference_pipeline_t;
+
+  output_array_t values{};
+  std::atomic<bool> ready{};
+};
+
+// producers submit single samples into a lock-free queue, one consumer thread
+// collects them into micro-batches of up to MAX_BATCH samples, waiting at most
+// max_delay after the first sample of a batch, and runs the batched forward pass;
+// the model is used by the consumer thread only while the pipeline is alive
+template<typename MODEL_T,
+         size_t MAX_BATCH = 16,
+         size_t QUEUE_CAPACITY = 256>
+struct inference_pipeline_t
+{
+  static_assert ( MAX_BATCH > 0, "MAX_BATCH should be positive" );
+
+  using model_t = MODEL_T;
+  using input_array_t = typename model_t::input_array_t;
+  using output_t = typename model_t::output_t;
+  using output_array_t = typename model_t::output_array_t;
+  using completion_t = inference_completion_t<model_t>;
+
+  static constexpr size_t const max_batch = MAX_BATCH;
+  static constexpr size_t const line_dimension = model_t::line_dimension;
+
+  explicit inference_pipeline_t ( model_t& model,
+                                  std::chrono::microseconds const max_delay = std::chrono::microseconds ( 100 ) )
+    : model ( model )
+    , max_delay ( max_delay )
+    , consumer ( [this]
+  {
+    consumer_loop();
+  } )
+  {
+  }
+
+  inference_pipeline_t ( inference_pipeline_t const& ) = delete;
+  inference_pipeline_t& operator= ( inference_pipeline_t const& ) = delete;
+
+  // the samples already submitted are processed before the consumer exits
+  ~inference_pipeline_t()
+  {
+    {
+      std::lock_guard<std::mutex> lock ( mutex );
+      stopping.store ( true );
+    }
+
+    wake_up.notify_one();
+    consumer.join();
+  }
+
+  // false if the queue is full, the completion becomes ready once the output is written
+  bool submit ( input_array_t const& input, completion_t& completion ) noexcept
+  {
+    completion.ready.store ( false, std::memory_order_relaxed );
+
+    if ( !queue.try_push ( request_t{input, &completion} ) )
+    {
+      return false;
+    }
+
+    // pairs with the fence of the consumer going to sleep
+    std::atomic_thread_fence ( std::memory_order_seq_cst );
+
+    if ( sleeping.load ( std::memory_order_relaxed ) )
+    {
+      std::lock_guard<std::mutex> lock ( mutex );
+      wake_up.notify_one();
+    }
+
+    return true;
+  }
+
+  uint64_t get_batch_count() const noexcept
+  {
+    return batch_count.load ( std::memory_order_relaxed );
+  }
+
+  uint64_t get_sample_count() const noexcept
+  {
+    return sample_count.load ( std::memory_order_relaxed );
+  }
+
+private:
+  struct request_t
+  {
+    input_array_t input;
+    completion_t* completion;
+  };
+
+  void consumer_loop()
+  {
+    request_t request{};
+
+    for ( ;; )
+    {
+      if ( !queue.try_pop ( request ) )
+      {
+        if ( stopping.load() )
+        {
+          return;
+        }
+
+        wait_for_work();
+        continue;
+      }
+
+      size_t count = 0;
+      add_request ( request, count );
+
+      auto const deadline = std::chrono::steady_clock::now() + max_delay;
+
+      while ( count < MAX_BATCH )
+      {
+        if ( queue.try_pop ( request ) )
+        {
+          add_request ( request, count );
+        }
+        else if ( stopping.load() || std::chrono::steady_clock::now() >= deadline )
+        {
+          break;
+        }
+        else
+        {
+          std::this_thread::yield();
+        }
+      }
+
+      run_batch ( count );
+    }
+  }
+
+  void wait_for_work()
+  {
+    std::unique_lock<std::mutex> lock ( mutex );
+
+    sleeping.store ( true, std::memory_order_relaxed );
+    std::atomic_thread_fence ( std::memory_order_seq_cst );
+
+    // the timeout only guards against a missed notification
+    wake_up.wait_for ( lock, std::chrono::milliseconds ( 10 ), [this]
+    {
+      return stopping.load() || !queue.empty();
+    } );
+
+    sleeping.store ( false, std::memory_order_relaxed );
+  }
+
+  void add_request ( request_t const& request, size_t& count ) noexcept
+  {
+    inputs[count] = request.input;
+    completions[count] = request.completion;
+    ++count;
+  }
+
+  void run_batch ( size_t const count ) noexcept
+  {
+    if constexpr ( inference_pipeline_details::has_apply_batch<model_t>::value )
+    {
+      model.apply_batch ( inputs.data(), count, outputs.data() );
+    }
+    else
+    {
+      for ( size_t i = 0; i < count; ++i )
+      {
+        model.apply ( inputs[i].data(), outputs.data() + i * line_dimension );
+      }
+    }
+
+    for ( size_t i = 0; i < count; ++i )
+    {
+      auto* const output = outputs.data() + i * line_dimension;
+
+      std::copy ( output, output + line_dimension, completions[i]->values.begin() );
+      completions[i]->ready.store ( true, std::memory_order_release );
+    }
+
+    batch_count.fetch_add ( 1, std::memory_order_relaxed );
+    sample_count.fetch_add ( count, std::memory_order_relaxed );
+  }
+
+private:
+  model_t& model;
+  std::chrono::microseconds const max_delay;
+
+  ring_buffer_utils::mpsc_ring_buffer_t<request_t, QUEUE_CAPACITY> queue;
+
+  // touched by the consumer thread only
+  alignas ( 64 ) std::array<input_array_t, MAX_BATCH> inputs{};
+  alignas ( 64 ) std::array < output_t, MAX_BATCH* line_dimension > outputs{};
+  std::array<completion_t*, MAX_BATCH> completions{};
+
+  std::mutex mutex;
+  std::condition_variable wake_up;
+  std::atomic<bool> sleeping{};
+  std::atomic<bool> stopping{};
+
+  std::atomic<uint64_t> batch_count{};
+  std::atomic<uint64_t> sample_count{};
+
+  std::thread consumer;
+};
+
+} // namespace nnet
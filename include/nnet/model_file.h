@@ -0,0 +1,448 @@
+#pragma once
+
+#include <nnet/dynamic_line.h>
+#include <nnet/neuron_network.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include <utility>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace nnet
+{
+
+// the file is a model_header_t, line_count + 1 uint64 dimensions and the row-major
+// koefs of every line, each block starting on a 64 byte boundary; the numbers are
+// in the native byte order and the checksum covers everything after the header
+enum class model_dtype : uint32_t
+{
+  float32 = 1,
+  float64 = 2,
+  int32 = 3
+};
+
+struct model_header_t
+{
+  static constexpr uint32_t const current_version = 1;
+
+  char magic[8];
+  uint32_t version;
+  model_dtype dtype;
+  uint32_t line_count;
+  uint32_t reserved;
+  uint64_t file_size;
+  uint64_t checksum;
+};
+
+namespace model_file_details
+{
+
+constexpr char const magic[8] = {'N', 'N', 'E', 'T', 'M', 'D', 'L', '\0'};
+
+constexpr size_t const alignment = 64;
+
+constexpr size_t aligned_size ( size_t const bytes ) noexcept
+{
+  return ( bytes + alignment - 1 ) / alignment * alignment;
+}
+
+template<typename T>
+struct dtype_traits;
+
+template<>
+struct dtype_traits<float>
+{
+  static constexpr model_dtype const dtype = model_dtype::float32;
+};
+
+template<>
+struct dtype_traits<double>
+{
+  static constexpr model_dtype const dtype = model_dtype::float64;
+};
+
+template<>
+struct dtype_traits<int32_t>
+{
+  static constexpr model_dtype const dtype = model_dtype::int32;
+};
+
+// FNV-1a over 64 bit words, every block of the file is a multiple of 8 bytes
+inline uint64_t checksum ( uint8_t const* data, size_t const size ) noexcept
+{
+  uint64_t result = 14695981039346656037ull;
+
+  for ( size_t i = 0; i + sizeof ( uint64_t ) <= size; i += sizeof ( uint64_t ) )
+  {
+    uint64_t word;
+    std::memcpy ( &word, data + i, sizeof ( word ) );
+
+    result = ( result ^ word ) * 1099511628211ull;
+  }
+
+  return result;
+}
+
+inline size_t dimensions_offset() noexcept
+{
+  return aligned_size ( sizeof ( model_header_t ) );
+}
+
+inline size_t first_koefs_offset ( size_t const line_count ) noexcept
+{
+  return dimensions_offset() + aligned_size ( ( line_count + 1 ) * sizeof ( uint64_t ) );
+}
+
+// the koef bytes of a in x out line, false when the product does not fit size_t
+inline bool checked_line_bytes ( size_t const in, size_t const out, size_t const element_size, size_t& result ) noexcept
+{
+  if ( ( out && in > SIZE_MAX / out ) || ( element_size && in * out > SIZE_MAX / element_size ) )
+  {
+    return false;
+  }
+
+  result = in * out * element_size;
+  return true;
+}
+
+// KOEF_AT ( line, neuron, input ) gives the koef of the line
+template<typename T, typename KOEF_AT>
+bool write_model ( char const* path, size_t const* dimensions, size_t const line_count, KOEF_AT const& koef_at )
+{
+  std::vector<size_t> offsets ( line_count + 1 );
+  offsets[0] = first_koefs_offset ( line_count );
+
+  for ( size_t i = 0; i < line_count; ++i )
+  {
+    offsets[i + 1] = offsets[i] + aligned_size ( dimensions[i] * dimensions[i + 1] * sizeof ( T ) );
+  }
+
+  std::vector<uint8_t> image ( offsets[line_count] );
+
+  for ( size_t i = 0; i <= line_count; ++i )
+  {
+    uint64_t const dimension = dimensions[i];
+    std::memcpy ( image.data() + dimensions_offset() + i * sizeof ( uint64_t ), &dimension, sizeof ( dimension ) );
+  }
+
+  for ( size_t i = 0; i < line_count; ++i )
+  {
+    auto* const koefs = reinterpret_cast<T*> ( image.data() + offsets[i] );
+
+    for ( size_t k = 0; k < dimensions[i + 1]; ++k )
+    {
+      for ( size_t j = 0; j < dimensions[i]; ++j )
+      {
+        koefs[k * dimensions[i] + j] = koef_at ( i, k, j );
+      }
+    }
+  }
+
+  model_header_t header{};
+  std::memcpy ( header.magic, magic, sizeof ( magic ) );
+  header.version = model_header_t::current_version;
+  header.dtype = dtype_traits<T>::dtype;
+  header.line_count = static_cast<uint32_t> ( line_count );
+  header.file_size = image.size();
+  header.checksum = checksum ( image.data() + sizeof ( model_header_t ), image.size() - sizeof ( model_header_t ) );
+
+  std::memcpy ( image.data(), &header, sizeof ( header ) );
+
+  auto* const file = std::fopen ( path, "wb" );
+
+  if ( !file )
+  {
+    return false;
+  }
+
+  bool const written = std::fwrite ( image.data(), 1, image.size(), file ) == image.size();
+
+  return ( std::fclose ( file ) == 0 ) && written;
+}
+
+template<typename LINE_T>
+typename LINE_T::koef_t line_koef ( LINE_T const& line, size_t const k, size_t const j ) noexcept
+{
+  return line.koefs_data() [LINE_T::layout_traits::koef_index ( k, j )];
+}
+
+template<typename NETWORK_T, size_t ... Indexes>
+typename NETWORK_T::input_t network_koef ( NETWORK_T const& network, size_t const i, size_t const k, size_t const j,
+    std::index_sequence<Indexes...> ) noexcept
+{
+  typename NETWORK_T::input_t result{};
+
+  ( void ) ( ( i == Indexes && ( result = line_koef ( network.template get_line<Indexes>(), k, j ), true ) ) || ... );
+
+  return result;
+}
+
+}  // namespace model_file_details
+
+template<typename LINE_T>
+bool save_line ( char const* path, LINE_T const& line )
+{
+  size_t const dimensions[] = {LINE_T::input_dimension, LINE_T::line_dimension};
+
+  return model_file_details::write_model<typename LINE_T::koef_t> ( path, dimensions, 1,
+         [&line] ( size_t, size_t k, size_t j )
+  {
+    return model_file_details::line_koef ( line, k, j );
+  } );
+}
+
+template<typename ... LINES>
+bool save_network ( char const* path, neuron_network_t<LINES...> const& network )
+{
+  using network_t = neuron_network_t<LINES...>;
+  using koef_t = typename network_t::input_t;
+
+  constexpr size_t const line_count = network_t::layer_count;
+
+  size_t const dimensions[] = {network_t::input_dimension, LINES::line_dimension...};
+
+  return model_file_details::write_model<koef_t> ( path, dimensions, line_count,
+         [&network] ( size_t i, size_t k, size_t j )
+  {
+    return model_file_details::network_koef ( network, i, k, j, std::make_index_sequence<line_count>() );
+  } );
+}
+
+template<typename INPUT_T, typename HIDDEN_ACTIVATION, typename OUTPUT_ACTIVATION>
+bool save_network ( char const* path, dynamic_network_t<INPUT_T, HIDDEN_ACTIVATION, OUTPUT_ACTIVATION> const& network )
+{
+  if ( !network.is_valid() )
+  {
+    return false;
+  }
+
+  std::vector<size_t> dimensions ( network.get_line_count() + 1 );
+  dimensions[0] = network.get_line ( 0 ).get_input_dimension();
+
+  for ( size_t i = 0; i < network.get_line_count(); ++i )
+  {
+    dimensions[i + 1] = network.get_line ( i ).size();
+  }
+
+  return model_file_details::write_model<INPUT_T> ( path, dimensions.data(), network.get_line_count(),
+         [&network, &dimensions] ( size_t i, size_t k, size_t j )
+  {
+    return network.get_line ( i ).koefs_data() [k * dimensions[i] + j];
+  } );
+}
+
+// a private copy-on-write mapping of a model file, the pages are shared with every
+// other process mapping the same file until somebody writes to the koefs
+struct model_file_t
+{
+  // the checksum pass reads the whole file, skip it to keep the load lazy
+  explicit model_file_t ( char const* path, bool const verify_checksum = true ) noexcept
+  {
+    auto const fd = ::open ( path, O_RDONLY );
+
+    if ( fd < 0 )
+    {
+      return;
+    }
+
+    struct stat status;
+
+    if ( ::fstat ( fd, &status ) == 0 && static_cast<size_t> ( status.st_size ) >= sizeof ( model_header_t ) )
+    {
+      auto* const mapping = ::mmap ( nullptr, status.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0 );
+
+      if ( mapping != MAP_FAILED )
+      {
+        data = static_cast<uint8_t*> ( mapping );
+        size = status.st_size;
+      }
+    }
+
+    ::close ( fd );
+
+    if ( data && !validate ( verify_checksum ) )
+    {
+      unmap();
+    }
+  }
+
+  model_file_t ( model_file_t const& ) = delete;
+  model_file_t& operator= ( model_file_t const& ) = delete;
+
+  ~model_file_t()
+  {
+    unmap();
+  }
+
+  bool is_valid() const noexcept
+  {
+    return data != nullptr;
+  }
+
+  model_dtype get_dtype() const noexcept
+  {
+    return get_header().dtype;
+  }
+
+  size_t get_line_count() const noexcept
+  {
+    return get_header().line_count;
+  }
+
+  // the input dimension of the line i is get_dimension ( i ), its output one get_dimension ( i + 1 )
+  size_t get_dimension ( size_t const i ) const noexcept
+  {
+    uint64_t result;
+    std::memcpy ( &result, data + model_file_details::dimensions_offset() + i * sizeof ( uint64_t ), sizeof ( result ) );
+
+    return static_cast<size_t> ( result );
+  }
+
+  // the row-major koefs of the line i inside the mapping or nullptr if T is not the file dtype
+  template<typename T>
+  T* get_koefs ( size_t const i ) noexcept
+  {
+    if ( !data || get_dtype() != model_file_details::dtype_traits<T>::dtype || i >= get_line_count() )
+    {
+      return nullptr;
+    }
+
+    auto offset = model_file_details::first_koefs_offset ( get_line_count() );
+
+    for ( size_t j = 0; j < i; ++j )
+    {
+      offset += model_file_details::aligned_size ( get_dimension ( j ) * get_dimension ( j + 1 ) * sizeof ( T ) );
+    }
+
+    return reinterpret_cast<T*> ( data + offset );
+  }
+
+  // a line over the mapped koefs writing its outputs to values
+  template<typename T>
+  dynamic_neuron_line_t<T> get_line ( size_t const i, T* values ) noexcept
+  {
+    auto* const koefs = get_koefs<T> ( i );
+
+    if ( !koefs )
+    {
+      return dynamic_neuron_line_t<T>();
+    }
+
+    return dynamic_neuron_line_t<T> ( get_dimension ( i ), get_dimension ( i + 1 ), koefs, values );
+  }
+
+  // the dimensions and the koef pointers for the dynamic_network_t constructor
+  std::vector<size_t> get_dimensions() const
+  {
+    std::vector<size_t> result ( data ? get_line_count() + 1 : 0 );
+
+    for ( size_t i = 0; i < result.size(); ++i )
+    {
+      result[i] = get_dimension ( i );
+    }
+
+    return result;
+  }
+
+  template<typename T>
+  std::vector<T*> get_all_koefs()
+  {
+    std::vector<T*> result ( data ? get_line_count() : 0 );
+
+    for ( size_t i = 0; i < result.size(); ++i )
+    {
+      result[i] = get_koefs<T> ( i );
+
+      if ( !result[i] )
+      {
+        return std::vector<T*>();
+      }
+    }
+
+    return result;
+  }
+
+private:
+  model_header_t const& get_header() const noexcept
+  {
+    return *reinterpret_cast<model_header_t const*> ( data );
+  }
+
+  size_t get_element_size() const noexcept
+  {
+    return ( get_dtype() == model_dtype::float64 ) ? sizeof ( double ) : sizeof ( int32_t );
+  }
+
+  bool validate ( bool const verify_checksum ) const noexcept
+  {
+    auto const& header = get_header();
+
+    if ( std::memcmp ( header.magic, model_file_details::magic, sizeof ( header.magic ) ) != 0
+         || header.version != model_header_t::current_version
+         || header.file_size != size
+         || header.line_count == 0
+         || ( header.dtype != model_dtype::float32 && header.dtype != model_dtype::float64
+              && header.dtype != model_dtype::int32 ) )
+    {
+      return false;
+    }
+
+    auto offset = model_file_details::first_koefs_offset ( header.line_count );
+
+    if ( offset > size )
+    {
+      return false;
+    }
+
+    // the dimensions come from the file, a product that wraps around must not pass for a small line
+    for ( size_t i = 0; i < header.line_count; ++i )
+    {
+      size_t bytes = 0;
+
+      if ( !model_file_details::checked_line_bytes ( get_dimension ( i ), get_dimension ( i + 1 ), get_element_size(), bytes )
+           || bytes > size - offset )
+      {
+        return false;
+      }
+
+      offset += model_file_details::aligned_size ( bytes );
+
+      if ( offset > size )
+      {
+        return false;
+      }
+    }
+
+    if ( offset != size )
+    {
+      return false;
+    }
+
+    return !verify_checksum
+           || header.checksum == model_file_details::checksum ( data + sizeof ( model_header_t ),
+               size - sizeof ( model_header_t ) );
+  }
+
+  void unmap() noexcept
+  {
+    if ( data )
+    {
+      ::munmap ( data, size );
+      data = nullptr;
+      size = 0;
+    }
+  }
+
+private:
+  uint8_t* data{};
+  size_t size{};
+};
+
+} // namespace nnet
@@ -1,16 +1,22 @@
 #pragma once
 
+#include <nnet/simd.h>
+#include <nnet/activation.h>
+
+#include <cstddef>
 #include <cstdint>
 #include <array>
-#include <numeric>
+#include <type_traits>
 
 namespace nnet
 {
 
 template<typename INPUT_T,
-         size_t INPUT_DIMENSION>
+         size_t INPUT_DIMENSION,
+         typename ACTIVATION = activation::identity_t>
 struct neuron_t
 {
+  using activation_t = ACTIVATION;
   using input_t = INPUT_T;
   using output_t = input_t;
   using koef_t = input_t;
@@ -34,9 +40,7 @@ struct neuron_t
 
   void apply ( input_array_t const& input ) noexcept
   {
-    value = std::inner_product ( koef.cbegin(), koef.cend(),
-                                 input.cbegin(),
-                                 output_t{} );
+    value = activation_t::apply ( simd::dot ( koef.data(), input.data(), INPUT_DIMENSION ) );
   }
 
   output_t get_value() const noexcept
@@ -49,5 +53,81 @@ private:
   koef_array_t koef{};
 };
 
+// neuron_t interface over a weight row kept outside of the neuron,
+// KOEF_STRIDE is the distance between two consecutive koefs of the row
+template<typename KOEF_T,
+         size_t INPUT_DIMENSION,
+         size_t KOEF_STRIDE = 1,
+         typename ACTIVATION = activation::identity_t>
+struct neuron_view_t
+{
+  using activation_t = ACTIVATION;
+  using koef_t = std::remove_const_t<KOEF_T>;
+  using input_t = koef_t;
+  using output_t = input_t;
+  using koef_array_t = std::array<koef_t, INPUT_DIMENSION>;
+  using input_array_t = std::array<input_t, INPUT_DIMENSION>;
+  using value_t = std::conditional_t<std::is_const<KOEF_T>::value, output_t const, output_t>;
+
+  neuron_view_t ( KOEF_T* koef, value_t* value ) noexcept
+    : koef ( koef )
+    , value ( value )
+  {
+  }
+
+  KOEF_T& get_koef ( size_t i ) const noexcept
+  {
+    return koef[i * KOEF_STRIDE];
+  }
+
+  koef_array_t get_koefs () const noexcept
+  {
+    koef_array_t result{};
+
+    for ( size_t i = 0; i < INPUT_DIMENSION; ++i )
+    {
+      result[i] = get_koef ( i );
+    }
+
+    return result;
+  }
+
+  void set_koefs ( koef_array_t const& new_koef ) const noexcept
+  {
+    for ( size_t i = 0; i < INPUT_DIMENSION; ++i )
+    {
+      get_koef ( i ) = new_koef[i];
+    }
+  }
+
+  void apply ( input_array_t const& input ) const noexcept
+  {
+    if constexpr ( KOEF_STRIDE == 1 )
+    {
+      *value = activation_t::apply ( simd::dot<koef_t> ( koef, input.data(), INPUT_DIMENSION ) );
+    }
+    else
+    {
+      output_t result{};
+
+      for ( size_t i = 0; i < INPUT_DIMENSION; ++i )
+      {
+        result += get_koef ( i ) * input[i];
+      }
+
+      *value = activation_t::apply ( result );
+    }
+  }
+
+  output_t get_value() const noexcept
+  {
+    return *value;
+  }
+
+private:
+  KOEF_T* koef;
+  value_t* value;
+};
+
 } // namespace nnet
 
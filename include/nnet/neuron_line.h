@@ -1,80 +1,255 @@
 #pragma once
 
 #include <nnet/neuron.h>
+#include <nnet/gemm.h>
+#include <nnet/activation.h>
+#include <utils/thread_pool.h>
 
+#include <cstddef>
 #include <cstdint>
 #include <array>
+#include <algorithm>
 
 namespace nnet
 {
 
+enum class line_layout
+{
+  row_major,
+  column_major
+};
+
+namespace neuron_line_details
+{
+
+template<size_t INPUT_DIMENSION,
+         size_t LINE_DIMENSION,
+         line_layout LAYOUT>
+struct line_layout_traits;
+
+template<size_t INPUT_DIMENSION,
+         size_t LINE_DIMENSION>
+struct line_layout_traits<INPUT_DIMENSION, LINE_DIMENSION, line_layout::row_major>
+{
+  static constexpr size_t const koef_stride = 1;
+
+  static constexpr size_t koef_index ( size_t neuron, size_t input ) noexcept
+  {
+    return neuron * INPUT_DIMENSION + input;
+  }
+};
+
+template<size_t INPUT_DIMENSION,
+         size_t LINE_DIMENSION>
+struct line_layout_traits<INPUT_DIMENSION, LINE_DIMENSION, line_layout::column_major>
+{
+  static constexpr size_t const koef_stride = LINE_DIMENSION;
+
+  static constexpr size_t koef_index ( size_t neuron, size_t input ) noexcept
+  {
+    return input * LINE_DIMENSION + neuron;
+  }
+};
+
+// lines with fewer multiply-adds per sample stay on the calling thread
+constexpr size_t const parallel_threshold = size_t{1} << 18;
+
+// the koefs of one parallel chunk of neurons fit into L2
+constexpr size_t const chunk_bytes = size_t{1} << 17;
+
+}  // namespace neuron_line_details
+
 template<typename INPUT_T,
          size_t INPUT_DIMENSION,
-         size_t LINE_DIMENSION>
+         size_t LINE_DIMENSION,
+         line_layout LAYOUT = line_layout::row_major,
+         typename ACTIVATION = activation::identity_t>
 struct neuron_line_t
 {
+  static constexpr size_t const input_dimension = INPUT_DIMENSION;
+  static constexpr size_t const line_dimension = LINE_DIMENSION;
+  static constexpr auto const layout = LAYOUT;
+
+  using layout_traits = neuron_line_details::line_layout_traits<INPUT_DIMENSION, LINE_DIMENSION, LAYOUT>;
+
+  using activation_t = ACTIVATION;
   using input_t = INPUT_T;
-  using neuron_t = nnet::neuron_t<input_t, INPUT_DIMENSION>;
-  using line_t = std::array<neuron_t, LINE_DIMENSION>;
+  using neuron_t = nnet::neuron_t<input_t, INPUT_DIMENSION, activation_t>;
+  using koef_t = typename neuron_t::koef_t;
+  using output_t = typename neuron_t::output_t;
   using input_array_t = typename neuron_t::input_array_t;
-  using output_array_t = std::array<typename neuron_t::output_t, LINE_DIMENSION>;
+  using output_array_t = std::array<output_t, LINE_DIMENSION>;
+  using koef_matrix_t = std::array<koef_t, INPUT_DIMENSION * LINE_DIMENSION>;
+  using neuron_view_t = nnet::neuron_view_t<koef_t, INPUT_DIMENSION, layout_traits::koef_stride, activation_t>;
+  using const_neuron_view_t =
+    nnet::neuron_view_t<koef_t const, INPUT_DIMENSION, layout_traits::koef_stride, activation_t>;
 
-  neuron_t& operator[] ( size_t k )
+  neuron_view_t operator[] ( size_t k )
   {
-    return line[k];
+    return neuron_view_t ( koefs.data() + layout_traits::koef_index ( k, 0 ), values.data() + k );
   }
 
-  neuron_t const& operator[] ( size_t k ) const
+  const_neuron_view_t operator[] ( size_t k ) const
   {
-    return line[k];
+    return const_neuron_view_t ( koefs.data() + layout_traits::koef_index ( k, 0 ), values.data() + k );
   }
 
   size_t size() const noexcept
   {
-    return line.size();
+    return LINE_DIMENSION;
   }
 
-  neuron_t* data() noexcept
+  koef_t* koefs_data() noexcept
   {
-    return line.data();
+    return koefs.data();
   }
 
-  neuron_t const* data() const noexcept
+  koef_t const* koefs_data() const noexcept
   {
-    return line.data();
+    return koefs.data();
   }
 
   void set_koefs ( size_t k, typename neuron_t::koef_array_t const& new_koef ) noexcept
   {
-    line[k].set_koefs ( new_koef );
+    ( *this ) [k].set_koefs ( new_koef );
   }
 
-  void apply ( typename neuron_t::input_array_t const& input ) noexcept
+  // the per-thread outputs, one line can serve any number of threads with a context each
+  struct alignas ( 64 ) context_t
   {
-    for ( auto& n : line )
+    output_array_t const& get_value() const noexcept
     {
-      n.apply ( input );
+      return values;
     }
+
+  private:
+    friend struct neuron_line_t;
+
+    output_array_t values{};
+  };
+
+  void apply ( input_array_t const& input ) noexcept
+  {
+    apply ( input.data(), values.data() );
   }
 
-  output_array_t get_value() const noexcept
+  // the whole line on the calling thread, the inference threads never meet on the pool
+  void apply ( input_array_t const& input, context_t& thread_context ) const noexcept
   {
-    output_array_t result{};
+    apply_range ( input.data(), thread_context.values.data(), 0, LINE_DIMENSION );
+  }
 
-    auto it = result.begin();
+  // writes LINE_DIMENSION outputs straight to the caller buffer, the neuron values are left intact,
+  // wide lines are split into cache-sized chunks of neurons across the default thread pool
+  void apply ( input_t const* input, output_t* output ) const noexcept
+  {
+    if constexpr ( INPUT_DIMENSION * LINE_DIMENSION >= neuron_line_details::parallel_threshold )
+    {
+      constexpr size_t const chunk_size =
+        std::max ( size_t{1}, neuron_line_details::chunk_bytes / ( INPUT_DIMENSION * sizeof ( koef_t ) ) );
+
+      thread_pool_utils::thread_pool_t::get_default_pool().parallel_for ( 0, LINE_DIMENSION, chunk_size,
+          [this, input, output] ( size_t begin, size_t end )
+      {
+        apply_range ( input, output, begin, end );
+      } );
+    }
+    else
+    {
+      apply_range ( input, output, 0, LINE_DIMENSION );
+    }
+  }
+
+  // outputs is a row-major count x LINE_DIMENSION buffer, the neuron values are left intact,
+  // large batches are split into row blocks across the default thread pool
+  void apply_batch ( input_array_t const* inputs, size_t count, output_t* outputs ) const noexcept
+  {
+    auto& pool = thread_pool_utils::thread_pool_t::get_default_pool();
+
+    if ( count * INPUT_DIMENSION * LINE_DIMENSION >= neuron_line_details::parallel_threshold
+         && count > gemm_details::mr && pool.get_thread_count() > 1 )
+    {
+      // every block packs the weights once, so the blocks are kept as large as possible
+      auto const block_count = pool.get_thread_count();
+      auto const block_size = ( ( count + block_count - 1 ) / block_count + gemm_details::mr - 1 )
+                              / gemm_details::mr * gemm_details::mr;
+
+      pool.parallel_for ( 0, count, block_size, [this, inputs, outputs] ( size_t begin, size_t end )
+      {
+        apply_batch_rows ( inputs + begin, end - begin, outputs + begin * LINE_DIMENSION );
+      } );
+    }
+    else
+    {
+      apply_batch_rows ( inputs, count, outputs );
+    }
+  }
+
+  output_array_t const& get_value() const noexcept
+  {
+    return values;
+  }
 
-    for ( auto& n : line )
+  // the outputs of the neurons [begin, end) only, on the calling thread
+  void apply_range ( input_t const* input, output_t* output, size_t const begin, size_t const end ) const noexcept
+  {
+    if constexpr ( LAYOUT == line_layout::row_major )
+    {
+      for ( size_t k = begin; k < end; ++k )
+      {
+        output[k] = activation_t::apply (
+                      simd::dot<koef_t> ( koefs.data() + layout_traits::koef_index ( k, 0 ), input, INPUT_DIMENSION ) );
+      }
+    }
+    else
     {
-      *it = n.get_value();
-      ++it;
+      std::fill ( output + begin, output + end, output_t{} );
+
+      for ( size_t i = 0; i < INPUT_DIMENSION; ++i )
+      {
+        auto const* column = koefs.data() + layout_traits::koef_index ( 0, i );
+
+        for ( size_t k = begin; k < end; ++k )
+        {
+          output[k] += column[k] * input[i];
+        }
+      }
+
+      // the outputs are still hot in L1 after the last column
+      for ( size_t k = begin; k < end; ++k )
+      {
+        output[k] = activation_t::apply ( output[k] );
+      }
     }
+  }
 
-    return result;
+private:
+  void apply_batch_rows ( input_array_t const* inputs, size_t count, output_t* outputs ) const noexcept
+  {
+    auto const input_row = [inputs] ( size_t i )
+    {
+      return inputs[i].data();
+    };
+
+    auto const koef_at = [this] ( size_t j, size_t p )
+    {
+      return koefs[layout_traits::koef_index ( j, p )];
+    };
+
+    auto const activation = [] ( output_t x )
+    {
+      return activation_t::apply ( x );
+    };
+
+    gemm_nt ( count, LINE_DIMENSION, INPUT_DIMENSION,
+              input_row, koef_at,
+              outputs, LINE_DIMENSION,
+              activation );
   }
 
 private:
-  line_t line{};
+  alignas ( 64 ) koef_matrix_t koefs{};
+  alignas ( 64 ) output_array_t values{};
 };
 
 } // namespace nnet
-
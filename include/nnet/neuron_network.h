@@ -0,0 +1,179 @@
+#pragma once
+
+#include <nnet/neuron_line.h>
+
+#include <cstddef>
+#include <array>
+#include <tuple>
+#include <utility>
+#include <algorithm>
+#include <type_traits>
+
+namespace nnet
+{
+
+namespace neuron_network_details
+{
+
+template<typename LINES_T, size_t ... Indexes>
+constexpr bool dimensions_match ( std::index_sequence<Indexes...> )
+{
+  return ( ( std::tuple_element_t<Indexes, LINES_T>::line_dimension
+             == std::tuple_element_t < Indexes + 1, LINES_T >::input_dimension ) && ... && true );
+}
+
+template<typename LINES_T, size_t ... Indexes>
+constexpr bool types_match ( std::index_sequence<Indexes...> )
+{
+  return ( std::is_same < typename std::tuple_element_t<Indexes, LINES_T>::output_t,
+           typename std::tuple_element_t < Indexes + 1, LINES_T >::input_t >::value && ... && true );
+}
+
+// the widest hidden layer, the last layer writes to the network output instead
+template<typename LINES_T, size_t ... Indexes>
+constexpr size_t max_hidden_dimension ( std::index_sequence<Indexes...> )
+{
+  return std::max ( { size_t{1}, std::tuple_element_t<Indexes, LINES_T>::line_dimension... } );
+}
+
+// the neuron lines split a wide line across the default pool, apply_range stays on the calling thread
+template<typename LINE_T, typename = void>
+struct has_apply_range : std::false_type
+{
+};
+
+template<typename LINE_T>
+struct has_apply_range < LINE_T, std::void_t < decltype ( std::declval<LINE_T const&>().apply_range (
+  std::declval<typename LINE_T::input_t const*>(), std::declval<typename LINE_T::output_t*>(), size_t{}, size_t{} ) ) >>
+: std::true_type
+{
+};
+
+}  // namespace neuron_network_details
+
+template<typename ... LINES>
+struct neuron_network_t
+{
+  static_assert ( sizeof... ( LINES ) > 0, "At least one line is required" );
+
+  using lines_t = std::tuple<LINES...>;
+
+  static constexpr size_t const layer_count = sizeof... ( LINES );
+
+  using first_line_t = std::tuple_element_t<0, lines_t>;
+  using last_line_t = std::tuple_element_t < layer_count - 1, lines_t >;
+
+  static_assert ( neuron_network_details::dimensions_match<lines_t> ( std::make_index_sequence < layer_count - 1 > () ),
+                  "LINE_DIMENSION of each line should be equal to INPUT_DIMENSION of the next one" );
+  static_assert ( neuron_network_details::types_match<lines_t> ( std::make_index_sequence < layer_count - 1 > () ),
+                  "output_t of each line should be equal to input_t of the next one" );
+
+  static constexpr size_t const input_dimension = first_line_t::input_dimension;
+  static constexpr size_t const line_dimension = last_line_t::line_dimension;
+  static constexpr size_t const hidden_dimension =
+    neuron_network_details::max_hidden_dimension<lines_t> ( std::make_index_sequence < layer_count - 1 > () );
+
+  using input_t = typename first_line_t::input_t;
+  using output_t = typename last_line_t::output_t;
+  using input_array_t = typename first_line_t::input_array_t;
+  using output_array_t = typename last_line_t::output_array_t;
+  using hidden_array_t = std::array<input_t, hidden_dimension>;
+
+  template<size_t Index>
+  std::tuple_element_t<Index, lines_t>& get_line() noexcept
+  {
+    return std::get<Index> ( lines );
+  }
+
+  template<size_t Index>
+  std::tuple_element_t<Index, lines_t> const& get_line() const noexcept
+  {
+    return std::get<Index> ( lines );
+  }
+
+  // the per-thread activations, the lines are only read while applying,
+  // so any number of threads can share one network with a context each
+  struct alignas ( 64 ) context_t
+  {
+    output_array_t const& get_value() const noexcept
+    {
+      return values;
+    }
+
+  private:
+    friend struct neuron_network_t;
+
+    alignas ( 64 ) std::array<hidden_array_t, 2> buffers{};
+    alignas ( 64 ) output_array_t values{};
+  };
+
+  // the single-threaded apply, wide lines are split across the default pool
+  void apply ( input_array_t const& input ) noexcept
+  {
+    apply_impl<0, false> ( input.data(), context.values.data(), context );
+  }
+
+  void apply ( input_t const* input, output_t* output ) noexcept
+  {
+    apply_impl<0, false> ( input, output, context );
+  }
+
+  void apply ( input_array_t const& input, context_t& thread_context ) const noexcept
+  {
+    apply ( input.data(), thread_context.values.data(), thread_context );
+  }
+
+  // the hidden layers ping-pong between the two context buffers, the last one writes straight
+  // to the caller output; every line runs on the calling thread, so the inference threads with
+  // a context each never meet on the pool
+  void apply ( input_t const* input, output_t* output, context_t& thread_context ) const noexcept
+  {
+    apply_impl<0, true> ( input, output, thread_context );
+  }
+
+  output_array_t const& get_value() const noexcept
+  {
+    return context.get_value();
+  }
+
+private:
+  template<size_t Index, bool ON_CALLING_THREAD>
+  void apply_impl ( input_t const* input, output_t* output, context_t& thread_context ) const noexcept
+  {
+    using line_t = std::tuple_element_t<Index, lines_t>;
+
+    auto const& line = std::get<Index> ( lines );
+
+    auto const apply_line = [&line] ( auto const* line_input, auto* line_output )
+    {
+      if constexpr ( ON_CALLING_THREAD && neuron_network_details::has_apply_range<line_t>::value )
+      {
+        line.apply_range ( line_input, line_output, 0, line_t::line_dimension );
+      }
+      else
+      {
+        line.apply ( line_input, line_output );
+      }
+    };
+
+    if constexpr ( Index + 1 == layer_count )
+    {
+      apply_line ( input, output );
+    }
+    else
+    {
+      auto* const hidden = thread_context.buffers[Index % 2].data();
+
+      apply_line ( input, hidden );
+      apply_impl < Index + 1, ON_CALLING_THREAD > ( hidden, output, thread_context );
+    }
+  }
+
+private:
+  lines_t lines{};
+
+  // the context of the single-threaded apply
+  context_t context{};
+};
+
+} // namespace nnet
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <nnet/neuron_line.h>
+#include <utils/numa.h>
+#include <utils/thread_pool.h>
+
+#include <cstddef>
+#include <algorithm>
+
+namespace nnet
+{
+
+// a neuron_line_t copied onto every numa node and applied by a pool of pinned workers,
+// see numa_utils::make_pinned_pool; every chunk of neurons reads the koefs of the node
+// of the thread running it, so no thread streams the weights from a remote node
+template<typename LINE_T>
+struct numa_line_t
+{
+  using line_t = LINE_T;
+  using input_t = typename line_t::input_t;
+  using output_t = typename line_t::output_t;
+  using koef_t = typename line_t::koef_t;
+  using input_array_t = typename line_t::input_array_t;
+  using output_array_t = typename line_t::output_array_t;
+
+  static constexpr size_t const input_dimension = line_t::input_dimension;
+  static constexpr size_t const line_dimension = line_t::line_dimension;
+
+  numa_line_t ( line_t const& line, thread_pool_utils::thread_pool_t& pool,
+                numa_utils::numa_topology_t const& topology, bool const huge_pages = false )
+    : pool ( pool )
+    , replicas ( line, topology, huge_pages )
+  {
+  }
+
+  bool is_valid() const noexcept
+  {
+    return replicas.is_valid();
+  }
+
+  size_t get_replica_count() const noexcept
+  {
+    return replicas.get_replica_count();
+  }
+
+  line_t const& get_replica ( size_t const node ) const noexcept
+  {
+    return replicas.get ( node );
+  }
+
+  bool is_bound ( size_t const node ) const noexcept
+  {
+    return replicas.get_buffer ( node ).is_bound();
+  }
+
+  bool has_huge_pages ( size_t const node ) const noexcept
+  {
+    return replicas.get_buffer ( node ).has_huge_pages();
+  }
+
+  size_t size() const noexcept
+  {
+    return line_dimension;
+  }
+
+  // writes LINE_DIMENSION outputs, the chunks are as in neuron_line_t::apply
+  void apply ( input_t const* input, output_t* output ) const noexcept
+  {
+    constexpr size_t const chunk_size =
+      std::max ( size_t{1}, neuron_line_details::chunk_bytes / ( input_dimension * sizeof ( koef_t ) ) );
+
+    pool.parallel_for ( 0, line_dimension, chunk_size, [this, input, output] ( size_t begin, size_t end )
+    {
+      replicas.get_local().apply_range ( input, output, begin, end );
+    } );
+  }
+
+  void apply ( input_array_t const& input, output_array_t& output ) const noexcept
+  {
+    apply ( input.data(), output.data() );
+  }
+
+private:
+  thread_pool_utils::thread_pool_t& pool;
+  numa_utils::replicated_t<line_t> replicas;
+};
+
+} // namespace nnet
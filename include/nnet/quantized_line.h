@@ -0,0 +1,216 @@
+#pragma once
+
+#include <nnet/simd.h>
+#include <nnet/activation.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <array>
+#include <cmath>
+#include <algorithm>
+#include <type_traits>
+
+namespace nnet
+{
+
+// affine mapping real = scale * ( q - zero_point )
+struct quantization_t
+{
+  float scale{1.0f};
+  int32_t zero_point{};
+
+  uint8_t quantize ( float const x ) const noexcept
+  {
+    auto const q = static_cast<int32_t> ( std::lround ( x / scale ) ) + zero_point;
+    return static_cast<uint8_t> ( std::min ( std::max ( q, int32_t{0} ), int32_t{255} ) );
+  }
+
+  float dequantize ( uint8_t const q ) const noexcept
+  {
+    return scale * static_cast<float> ( static_cast<int32_t> ( q ) - zero_point );
+  }
+
+  // the range is extended to include zero, so zero is represented exactly
+  static quantization_t from_range ( float min_value, float max_value ) noexcept
+  {
+    min_value = std::min ( min_value, 0.0f );
+    max_value = std::max ( max_value, 0.0f );
+
+    quantization_t result;
+
+    if ( max_value > min_value )
+    {
+      result.scale = ( max_value - min_value ) / 255.0f;
+      result.zero_point = static_cast<int32_t> ( std::lround ( -min_value / result.scale ) );
+    }
+
+    return result;
+  }
+};
+
+// uint8 activations, int8 symmetric koefs and int32 accumulators,
+// the accumulators are requantized to the uint8 output once per neuron
+template<size_t INPUT_DIMENSION,
+         size_t LINE_DIMENSION,
+         typename ACTIVATION = activation::identity_t>
+struct quantized_neuron_line_t
+{
+  static constexpr size_t const input_dimension = INPUT_DIMENSION;
+  static constexpr size_t const line_dimension = LINE_DIMENSION;
+
+  using activation_t = ACTIVATION;
+  using input_t = uint8_t;
+  using output_t = uint8_t;
+  using koef_t = int8_t;
+  using accumulator_t = int32_t;
+  using input_array_t = std::array<input_t, INPUT_DIMENSION>;
+  using output_array_t = std::array<output_t, LINE_DIMENSION>;
+  using koef_array_t = std::array<koef_t, INPUT_DIMENSION>;
+  using koef_matrix_t = std::array<koef_t, INPUT_DIMENSION * LINE_DIMENSION>;
+
+  size_t size() const noexcept
+  {
+    return LINE_DIMENSION;
+  }
+
+  koef_t const* koefs_data() const noexcept
+  {
+    return koefs.data();
+  }
+
+  void set_koefs ( size_t k, koef_array_t const& new_koef ) noexcept
+  {
+    std::copy ( new_koef.cbegin(), new_koef.cend(), koefs.begin() + k * INPUT_DIMENSION );
+
+    koef_sums[k] = 0;
+
+    for ( auto const koef : new_koef )
+    {
+      koef_sums[k] += koef;
+    }
+  }
+
+  void set_quantization ( quantization_t const& input, float const koef, quantization_t const& output ) noexcept
+  {
+    input_quantization = input;
+    koef_scale = koef;
+    output_quantization = output;
+  }
+
+  quantization_t const& get_input_quantization() const noexcept
+  {
+    return input_quantization;
+  }
+
+  quantization_t const& get_output_quantization() const noexcept
+  {
+    return output_quantization;
+  }
+
+  float get_koef_scale() const noexcept
+  {
+    return koef_scale;
+  }
+
+  void apply ( input_array_t const& input ) noexcept
+  {
+    apply ( input.data(), values.data() );
+  }
+
+  void apply ( input_t const* input, output_t* output ) const noexcept
+  {
+    auto const multiplier = input_quantization.scale * koef_scale;
+
+    for ( size_t k = 0; k < LINE_DIMENSION; ++k )
+    {
+      // sum ( x - zx ) * w = sum x * w - zx * sum w
+      accumulator_t const acc = simd::dot_u8s8 ( input, koefs.data() + k * INPUT_DIMENSION, INPUT_DIMENSION )
+                                - input_quantization.zero_point * koef_sums[k];
+
+      output[k] = output_quantization.quantize ( activation_t::apply ( multiplier * static_cast<float> ( acc ) ) );
+    }
+  }
+
+  output_array_t const& get_value() const noexcept
+  {
+    return values;
+  }
+
+private:
+  alignas ( 64 ) koef_matrix_t koefs{};
+  alignas ( 64 ) std::array<accumulator_t, LINE_DIMENSION> koef_sums{};
+  alignas ( 64 ) output_array_t values{};
+  quantization_t input_quantization{};
+  quantization_t output_quantization{};
+  float koef_scale{1.0f};
+};
+
+// converts a float line into the quantized one, the activation ranges are
+// taken from running the float line over the calibration inputs
+template<typename LINE_T, typename QUANTIZED_LINE_T>
+void quantize_line ( LINE_T const& line,
+                     typename LINE_T::input_array_t const* calibration_inputs,
+                     size_t const count,
+                     QUANTIZED_LINE_T& quantized_line )
+{
+  static_assert ( std::is_same<typename LINE_T::input_t, float>::value, "Only float lines can be quantized" );
+  static_assert ( LINE_T::input_dimension == QUANTIZED_LINE_T::input_dimension
+                  && LINE_T::line_dimension == QUANTIZED_LINE_T::line_dimension,
+                  "The line dimensions should be the same" );
+  static_assert ( std::is_same<typename LINE_T::activation_t, typename QUANTIZED_LINE_T::activation_t>::value,
+                  "The activations should be the same" );
+
+  constexpr auto const input_dimension = LINE_T::input_dimension;
+  constexpr auto const line_dimension = LINE_T::line_dimension;
+
+  float koef_max{};
+
+  for ( size_t k = 0; k < line_dimension; ++k )
+  {
+    for ( auto const koef : line[k].get_koefs() )
+    {
+      koef_max = std::max ( koef_max, std::fabs ( koef ) );
+    }
+  }
+
+  auto const koef_scale = ( koef_max > 0.0f ) ? koef_max / 127.0f : 1.0f;
+
+  for ( size_t k = 0; k < line_dimension; ++k )
+  {
+    typename QUANTIZED_LINE_T::koef_array_t koefs{};
+    auto const float_koefs = line[k].get_koefs();
+
+    for ( size_t i = 0; i < input_dimension; ++i )
+    {
+      koefs[i] = static_cast<int8_t> ( std::lround ( float_koefs[i] / koef_scale ) );
+    }
+
+    quantized_line.set_koefs ( k, koefs );
+  }
+
+  float input_min{};
+  float input_max{};
+  float output_min{};
+  float output_max{};
+
+  typename LINE_T::output_array_t output{};
+
+  for ( size_t s = 0; s < count; ++s )
+  {
+    auto const& input = calibration_inputs[s];
+
+    input_min = std::min ( input_min, *std::min_element ( input.cbegin(), input.cend() ) );
+    input_max = std::max ( input_max, *std::max_element ( input.cbegin(), input.cend() ) );
+
+    line.apply ( input.data(), output.data() );
+
+    output_min = std::min ( output_min, *std::min_element ( output.cbegin(), output.cend() ) );
+    output_max = std::max ( output_max, *std::max_element ( output.cbegin(), output.cend() ) );
+  }
+
+  quantized_line.set_quantization ( quantization_t::from_range ( input_min, input_max ),
+                                    koef_scale,
+                                    quantization_t::from_range ( output_min, output_max ) );
+}
+
+} // namespace nnet
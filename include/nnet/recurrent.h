@@ -0,0 +1,291 @@
+#pragma once
+
+#include <nnet/neuron_line.h>
+#include <nnet/activation.h>
+
+#include <cstddef>
+#include <array>
+#include <algorithm>
+
+namespace nnet
+{
+
+enum class cell_method
+{
+  lstm,
+  gru
+};
+
+enum class lstm_gate : size_t
+{
+  input,
+  forget,
+  cell,
+  output
+};
+
+// the reset-after gru: n = tanh ( W_n x + b_n + r * ( U_n h + b_hn ) ), so the
+// candidate is split into an input and a hidden block to keep a single product
+enum class gru_gate : size_t
+{
+  update,
+  reset,
+  candidate_input,
+  candidate_hidden
+};
+
+namespace recurrent_details
+{
+
+template<cell_method METHOD_ENUM>
+struct cell_traits;
+
+template<>
+struct cell_traits<cell_method::lstm>
+{
+  using gate_t = lstm_gate;
+
+  static constexpr size_t const gate_count = 4;
+
+  static constexpr bool uses_input ( gate_t ) noexcept
+  {
+    return true;
+  }
+
+  static constexpr bool uses_hidden ( gate_t ) noexcept
+  {
+    return true;
+  }
+
+  // gates holds the pre-activations of the 4 blocks of HIDDEN rows
+  template<typename T>
+  static void update ( T const* gates, T* hidden, T* cell, size_t const hidden_dimension ) noexcept
+  {
+    auto const* const i = gates;
+    auto const* const f = gates + hidden_dimension;
+    auto const* const g = gates + 2 * hidden_dimension;
+    auto const* const o = gates + 3 * hidden_dimension;
+
+    for ( size_t k = 0; k < hidden_dimension; ++k )
+    {
+      cell[k] = activation::sigmoid_t::apply ( f[k] ) * cell[k]
+                + activation::sigmoid_t::apply ( i[k] ) * activation::tanh_t::apply ( g[k] );
+      hidden[k] = activation::sigmoid_t::apply ( o[k] ) * activation::tanh_t::apply ( cell[k] );
+    }
+  }
+};
+
+template<>
+struct cell_traits<cell_method::gru>
+{
+  using gate_t = gru_gate;
+
+  static constexpr size_t const gate_count = 4;
+
+  static constexpr bool uses_input ( gate_t const gate ) noexcept
+  {
+    return gate != gru_gate::candidate_hidden;
+  }
+
+  static constexpr bool uses_hidden ( gate_t const gate ) noexcept
+  {
+    return gate != gru_gate::candidate_input;
+  }
+
+  template<typename T>
+  static void update ( T const* gates, T* hidden, [[maybe_unused]] T* cell, size_t const hidden_dimension ) noexcept
+  {
+    auto const* const z = gates;
+    auto const* const r = gates + hidden_dimension;
+    auto const* const nx = gates + 2 * hidden_dimension;
+    auto const* const nh = gates + 3 * hidden_dimension;
+
+    for ( size_t k = 0; k < hidden_dimension; ++k )
+    {
+      auto const update_gate = activation::sigmoid_t::apply ( z[k] );
+      auto const candidate = activation::tanh_t::apply ( nx[k] + activation::sigmoid_t::apply ( r[k] ) * nh[k] );
+
+      hidden[k] = ( T{1} - update_gate ) * candidate + update_gate * hidden[k];
+    }
+  }
+};
+
+}  // namespace recurrent_details
+
+// every gate of a timestep comes from one neuron_line_t over [x, h, 1], the
+// constant 1 carries the biases; the cell holds only the koefs, the hidden state
+// lives in state_t ( batch_state_t for BATCH sequences run in lockstep ) whose
+// concatenated input buffer keeps h in place for the next step
+template<cell_method METHOD_ENUM,
+         typename INPUT_T,
+         size_t INPUT_DIMENSION,
+         size_t HIDDEN_DIMENSION>
+struct recurrent_cell_t
+{
+  using traits = recurrent_details::cell_traits<METHOD_ENUM>;
+  using gate_t = typename traits::gate_t;
+
+  static constexpr auto const method = METHOD_ENUM;
+  static constexpr size_t const input_dimension = INPUT_DIMENSION;
+  static constexpr size_t const hidden_dimension = HIDDEN_DIMENSION;
+  static constexpr size_t const concat_dimension = INPUT_DIMENSION + HIDDEN_DIMENSION + 1;
+  static constexpr size_t const gate_dimension = traits::gate_count * HIDDEN_DIMENSION;
+
+  using input_t = INPUT_T;
+  using gate_line_t = neuron_line_t<input_t, concat_dimension, gate_dimension>;
+  using input_array_t = std::array<input_t, INPUT_DIMENSION>;
+  using hidden_array_t = std::array<input_t, HIDDEN_DIMENSION>;
+  using concat_array_t = typename gate_line_t::input_array_t;
+
+  struct alignas ( 64 ) state_t
+  {
+    state_t() noexcept
+    {
+      reset();
+    }
+
+    void reset() noexcept
+    {
+      std::fill ( concat.begin(), concat.end(), input_t{} );
+      std::fill ( cell.begin(), cell.end(), input_t{} );
+      concat.back() = input_t{1};
+    }
+
+    input_t const* get_hidden() const noexcept
+    {
+      return concat.data() + INPUT_DIMENSION;
+    }
+
+  private:
+    friend struct recurrent_cell_t;
+
+    alignas ( 64 ) concat_array_t concat;
+    alignas ( 64 ) hidden_array_t cell;
+    alignas ( 64 ) std::array<input_t, gate_dimension> gates;
+  };
+
+  template<size_t BATCH>
+  struct alignas ( 64 ) batch_state_t
+  {
+    batch_state_t() noexcept
+    {
+      reset();
+    }
+
+    void reset() noexcept
+    {
+      for ( size_t b = 0; b < BATCH; ++b )
+      {
+        std::fill ( concat[b].begin(), concat[b].end(), input_t{} );
+        std::fill ( cell[b].begin(), cell[b].end(), input_t{} );
+        concat[b].back() = input_t{1};
+      }
+    }
+
+    input_t const* get_hidden ( size_t const b ) const noexcept
+    {
+      return concat[b].data() + INPUT_DIMENSION;
+    }
+
+  private:
+    friend struct recurrent_cell_t;
+
+    alignas ( 64 ) std::array<concat_array_t, BATCH> concat;
+    alignas ( 64 ) std::array<hidden_array_t, BATCH> cell;
+    alignas ( 64 ) std::array < input_t, BATCH* gate_dimension > gates;
+  };
+
+  gate_line_t& get_gate_line() noexcept
+  {
+    return gate_line;
+  }
+
+  gate_line_t const& get_gate_line() const noexcept
+  {
+    return gate_line;
+  }
+
+  // the koefs of one unit of a gate, the parts a gate does not use are set to zero
+  void set_gate_koefs ( gate_t const gate, size_t const unit,
+                        input_array_t const& input_koefs, hidden_array_t const& hidden_koefs, input_t const bias ) noexcept
+  {
+    typename gate_line_t::neuron_t::koef_array_t koefs{};
+
+    if ( traits::uses_input ( gate ) )
+    {
+      std::copy ( input_koefs.cbegin(), input_koefs.cend(), koefs.begin() );
+    }
+
+    if ( traits::uses_hidden ( gate ) )
+    {
+      std::copy ( hidden_koefs.cbegin(), hidden_koefs.cend(), koefs.begin() + INPUT_DIMENSION );
+    }
+
+    koefs.back() = bias;
+
+    gate_line.set_koefs ( static_cast<size_t> ( gate ) * HIDDEN_DIMENSION + unit, koefs );
+  }
+
+  void step ( input_array_t const& input, state_t& state ) const noexcept
+  {
+    std::copy ( input.cbegin(), input.cend(), state.concat.begin() );
+
+    gate_line.apply ( state.concat.data(), state.gates.data() );
+
+    traits::update ( state.gates.data(), state.concat.data() + INPUT_DIMENSION, state.cell.data(), HIDDEN_DIMENSION );
+  }
+
+  // inputs holds one sample of each of the BATCH sequences, the gates of all of them are one gemm
+  template<size_t BATCH>
+  void step_batch ( input_array_t const* inputs, batch_state_t<BATCH>& state ) const noexcept
+  {
+    for ( size_t b = 0; b < BATCH; ++b )
+    {
+      std::copy ( inputs[b].cbegin(), inputs[b].cend(), state.concat[b].begin() );
+    }
+
+    gate_line.apply_batch ( state.concat.data(), BATCH, state.gates.data() );
+
+    for ( size_t b = 0; b < BATCH; ++b )
+    {
+      traits::update ( state.gates.data() + b * gate_dimension, state.concat[b].data() + INPUT_DIMENSION,
+                       state.cell[b].data(), HIDDEN_DIMENSION );
+    }
+  }
+
+  // hidden_outputs, if given, receives [length][HIDDEN_DIMENSION]
+  void run_sequence ( input_array_t const* inputs, size_t const length, state_t& state,
+                      input_t* hidden_outputs = nullptr ) const noexcept
+  {
+    for ( size_t t = 0; t < length; ++t )
+    {
+      step ( inputs[t], state );
+
+      if ( hidden_outputs )
+      {
+        std::copy ( state.get_hidden(), state.get_hidden() + HIDDEN_DIMENSION, hidden_outputs + t * HIDDEN_DIMENSION );
+      }
+    }
+  }
+
+  // inputs is [length][BATCH]
+  template<size_t BATCH>
+  void run_sequence_batch ( input_array_t const* inputs, size_t const length, batch_state_t<BATCH>& state ) const noexcept
+  {
+    for ( size_t t = 0; t < length; ++t )
+    {
+      step_batch ( inputs + t * BATCH, state );
+    }
+  }
+
+private:
+  gate_line_t gate_line;
+};
+
+template<typename INPUT_T, size_t INPUT_DIMENSION, size_t HIDDEN_DIMENSION>
+using lstm_cell_t = recurrent_cell_t<cell_method::lstm, INPUT_T, INPUT_DIMENSION, HIDDEN_DIMENSION>;
+
+template<typename INPUT_T, size_t INPUT_DIMENSION, size_t HIDDEN_DIMENSION>
+using gru_cell_t = recurrent_cell_t<cell_method::gru, INPUT_T, INPUT_DIMENSION, HIDDEN_DIMENSION>;
+
+} // namespace nnet
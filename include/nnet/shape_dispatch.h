@@ -0,0 +1,452 @@
+#pragma once
+
+#include <nnet/dynamic_line.h>
+#include <nnet/activation.h>
+#include <nnet/simd.h>
+
+#include <cstddef>
+#include <array>
+
+namespace nnet
+{
+
+template<size_t INPUT_DIMENSION, size_t LINE_DIMENSION>
+struct line_shape_t
+{
+  static constexpr size_t const input_dimension = INPUT_DIMENSION;
+  static constexpr size_t const line_dimension = LINE_DIMENSION;
+};
+
+template<typename ... SHAPES>
+struct line_shape_list_t
+{
+};
+
+// the shapes instantiated unless the caller gives its own list
+using default_line_shapes = line_shape_list_t <
+                            line_shape_t<4, 4>, line_shape_t<8, 8>, line_shape_t<16, 16>, line_shape_t<32, 32>,
+                            line_shape_t<64, 64>, line_shape_t<8, 4>, line_shape_t<16, 8>, line_shape_t<32, 16>,
+                            line_shape_t<64, 32>, line_shape_t<128, 64>, line_shape_t<16, 1>, line_shape_t<32, 1> >;
+
+enum class dispatch_path
+{
+  specialized,
+  generic
+};
+
+namespace shape_dispatch_details
+{
+
+// row-major koefs, the dimensions are ignored by the specialized kernels
+template<typename T>
+using line_kernel_t = void ( * ) ( T const* koefs, T const* input, T* output,
+                                   size_t input_dimension, size_t line_dimension );
+
+// the rows go through the dot kernel of ISA, float and double on avx2 and avx512 have the
+// row-blocked kernels below instead; the row length is passed at run time, gcc 12 inlines
+// the sse2 kernels and reports their dead tails for a constant one at -O2
+template<typename T, simd::isa ISA, size_t INPUT_DIMENSION, size_t LINE_DIMENSION, typename ACTIVATION>
+struct fixed_shape_kernel
+{
+  static void method ( T const* koefs, T const* input, T* output, size_t const input_dimension, size_t ) noexcept
+  {
+    for ( size_t k = 0; k < LINE_DIMENSION; ++k )
+    {
+      output[k] = ACTIVATION::apply (
+                    simd::simd_details::dot_traits<T, ISA>::method ( koefs + k * INPUT_DIMENSION, input, input_dimension ) );
+    }
+  }
+};
+
+#if defined ( NNET_SIMD_X86 )
+
+// four rows share every load of the input and are reduced together, the rows left
+// over by the blocks of four take one accumulator each
+
+//-----------------------------------------------------------------------------
+// avx2, the tail of a row is summed in scalar
+
+template<size_t INPUT_DIMENSION, size_t LINE_DIMENSION, typename ACTIVATION>
+struct fixed_shape_kernel<float, simd::isa::avx2, INPUT_DIMENSION, LINE_DIMENSION, ACTIVATION>
+{
+  static constexpr size_t const blocked = LINE_DIMENSION / 4 * 4;
+  static constexpr size_t const full = INPUT_DIMENSION / 8 * 8;
+
+  __attribute__ ( ( target ( "avx2,fma" ) ) )
+  static void method ( float const* koefs, float const* input, float* output, size_t, size_t ) noexcept
+  {
+    for ( size_t k = 0; k < blocked; k += 4 )
+    {
+      float const* const row = koefs + k * INPUT_DIMENSION;
+
+      __m256 acc0 = _mm256_setzero_ps();
+      __m256 acc1 = _mm256_setzero_ps();
+      __m256 acc2 = _mm256_setzero_ps();
+      __m256 acc3 = _mm256_setzero_ps();
+
+      for ( size_t i = 0; i < full; i += 8 )
+      {
+        __m256 const x = _mm256_loadu_ps ( input + i );
+        acc0 = _mm256_fmadd_ps ( _mm256_loadu_ps ( row + i ), x, acc0 );
+        acc1 = _mm256_fmadd_ps ( _mm256_loadu_ps ( row + INPUT_DIMENSION + i ), x, acc1 );
+        acc2 = _mm256_fmadd_ps ( _mm256_loadu_ps ( row + 2 * INPUT_DIMENSION + i ), x, acc2 );
+        acc3 = _mm256_fmadd_ps ( _mm256_loadu_ps ( row + 3 * INPUT_DIMENSION + i ), x, acc3 );
+      }
+
+      // the four sums end up in the four lanes of one register
+      __m256 const sums = _mm256_hadd_ps ( _mm256_hadd_ps ( acc0, acc1 ), _mm256_hadd_ps ( acc2, acc3 ) );
+
+      alignas ( 16 ) float lanes[4];
+      _mm_store_ps ( lanes, _mm_add_ps ( _mm256_castps256_ps128 ( sums ), _mm256_extractf128_ps ( sums, 1 ) ) );
+
+      for ( size_t r = 0; r < 4; ++r )
+      {
+        for ( size_t i = full; i < INPUT_DIMENSION; ++i )
+        {
+          lanes[r] += row[r * INPUT_DIMENSION + i] * input[i];
+        }
+
+        output[k + r] = ACTIVATION::apply ( lanes[r] );
+      }
+    }
+
+    for ( size_t k = blocked; k < LINE_DIMENSION; ++k )
+    {
+      output[k] = ACTIVATION::apply (
+                    simd::simd_details::dot_traits<float, simd::isa::avx2>::method ( koefs + k * INPUT_DIMENSION, input, INPUT_DIMENSION ) );
+    }
+  }
+};
+
+template<size_t INPUT_DIMENSION, size_t LINE_DIMENSION, typename ACTIVATION>
+struct fixed_shape_kernel<double, simd::isa::avx2, INPUT_DIMENSION, LINE_DIMENSION, ACTIVATION>
+{
+  static constexpr size_t const blocked = LINE_DIMENSION / 4 * 4;
+  static constexpr size_t const full = INPUT_DIMENSION / 4 * 4;
+
+  __attribute__ ( ( target ( "avx2,fma" ) ) )
+  static void method ( double const* koefs, double const* input, double* output, size_t, size_t ) noexcept
+  {
+    for ( size_t k = 0; k < blocked; k += 4 )
+    {
+      double const* const row = koefs + k * INPUT_DIMENSION;
+
+      __m256d acc0 = _mm256_setzero_pd();
+      __m256d acc1 = _mm256_setzero_pd();
+      __m256d acc2 = _mm256_setzero_pd();
+      __m256d acc3 = _mm256_setzero_pd();
+
+      for ( size_t i = 0; i < full; i += 4 )
+      {
+        __m256d const x = _mm256_loadu_pd ( input + i );
+        acc0 = _mm256_fmadd_pd ( _mm256_loadu_pd ( row + i ), x, acc0 );
+        acc1 = _mm256_fmadd_pd ( _mm256_loadu_pd ( row + INPUT_DIMENSION + i ), x, acc1 );
+        acc2 = _mm256_fmadd_pd ( _mm256_loadu_pd ( row + 2 * INPUT_DIMENSION + i ), x, acc2 );
+        acc3 = _mm256_fmadd_pd ( _mm256_loadu_pd ( row + 3 * INPUT_DIMENSION + i ), x, acc3 );
+      }
+
+      __m256d const sums01 = _mm256_hadd_pd ( acc0, acc1 );
+      __m256d const sums23 = _mm256_hadd_pd ( acc2, acc3 );
+
+      alignas ( 32 ) double lanes[4];
+      _mm256_store_pd ( lanes, _mm256_add_pd ( _mm256_permute2f128_pd ( sums01, sums23, 0x20 ),
+                        _mm256_permute2f128_pd ( sums01, sums23, 0x31 ) ) );
+
+      for ( size_t r = 0; r < 4; ++r )
+      {
+        for ( size_t i = full; i < INPUT_DIMENSION; ++i )
+        {
+          lanes[r] += row[r * INPUT_DIMENSION + i] * input[i];
+        }
+
+        output[k + r] = ACTIVATION::apply ( lanes[r] );
+      }
+    }
+
+    for ( size_t k = blocked; k < LINE_DIMENSION; ++k )
+    {
+      output[k] = ACTIVATION::apply (
+                    simd::simd_details::dot_traits<double, simd::isa::avx2>::method ( koefs + k * INPUT_DIMENSION, input, INPUT_DIMENSION ) );
+    }
+  }
+};
+
+//-----------------------------------------------------------------------------
+// avx512, the tail of a row is a masked load
+
+template<size_t INPUT_DIMENSION, size_t LINE_DIMENSION, typename ACTIVATION>
+struct fixed_shape_kernel<float, simd::isa::avx512, INPUT_DIMENSION, LINE_DIMENSION, ACTIVATION>
+{
+  static constexpr size_t const blocked = LINE_DIMENSION / 4 * 4;
+  static constexpr size_t const full = INPUT_DIMENSION / 16 * 16;
+  static constexpr __mmask16 const tail_mask = __mmask16 ( ( 1u << ( INPUT_DIMENSION - full ) ) - 1 );
+  static constexpr __mmask16 const all = __mmask16 ( 0xFFFF );
+  static constexpr __mmask8 const all_pairs = __mmask8 ( 0xFF );
+
+  __attribute__ ( ( target ( "avx512f" ) ) )
+  static void method ( float const* koefs, float const* input, float* output, size_t, size_t ) noexcept
+  {
+    for ( size_t k = 0; k < blocked; k += 4 )
+    {
+      float const* const row = koefs + k * INPUT_DIMENSION;
+
+      __m512 acc0 = _mm512_setzero_ps();
+      __m512 acc1 = _mm512_setzero_ps();
+      __m512 acc2 = _mm512_setzero_ps();
+      __m512 acc3 = _mm512_setzero_ps();
+
+      for ( size_t i = 0; i < full; i += 16 )
+      {
+        __m512 const x = _mm512_loadu_ps ( input + i );
+        acc0 = _mm512_fmadd_ps ( _mm512_loadu_ps ( row + i ), x, acc0 );
+        acc1 = _mm512_fmadd_ps ( _mm512_loadu_ps ( row + INPUT_DIMENSION + i ), x, acc1 );
+        acc2 = _mm512_fmadd_ps ( _mm512_loadu_ps ( row + 2 * INPUT_DIMENSION + i ), x, acc2 );
+        acc3 = _mm512_fmadd_ps ( _mm512_loadu_ps ( row + 3 * INPUT_DIMENSION + i ), x, acc3 );
+      }
+
+      if constexpr ( full < INPUT_DIMENSION )
+      {
+        __m512 const x = _mm512_maskz_loadu_ps ( tail_mask, input + full );
+        acc0 = _mm512_fmadd_ps ( _mm512_maskz_loadu_ps ( tail_mask, row + full ), x, acc0 );
+        acc1 = _mm512_fmadd_ps ( _mm512_maskz_loadu_ps ( tail_mask, row + INPUT_DIMENSION + full ), x, acc1 );
+        acc2 = _mm512_fmadd_ps ( _mm512_maskz_loadu_ps ( tail_mask, row + 2 * INPUT_DIMENSION + full ), x, acc2 );
+        acc3 = _mm512_fmadd_ps ( _mm512_maskz_loadu_ps ( tail_mask, row + 3 * INPUT_DIMENSION + full ), x, acc3 );
+      }
+
+      // the four sums are gathered in every 128 bit lane, which are then folded; the unmasked
+      // shuffles and the 512 to 256 bit casts trip the false -Wuninitialized of gcc 12 at -O2,
+      // their maskz forms with every lane set compile to the same instructions
+      __m512 const sums01 = _mm512_add_ps ( _mm512_maskz_unpacklo_ps ( all, acc0, acc1 ), _mm512_maskz_unpackhi_ps ( all, acc0, acc1 ) );
+      __m512 const sums23 = _mm512_add_ps ( _mm512_maskz_unpacklo_ps ( all, acc2, acc3 ), _mm512_maskz_unpackhi_ps ( all, acc2, acc3 ) );
+
+      __m512 sums = _mm512_add_ps ( _mm512_castpd_ps ( _mm512_maskz_unpacklo_pd ( all_pairs, _mm512_castps_pd ( sums01 ), _mm512_castps_pd ( sums23 ) ) ),
+                                    _mm512_castpd_ps ( _mm512_maskz_unpackhi_pd ( all_pairs, _mm512_castps_pd ( sums01 ), _mm512_castps_pd ( sums23 ) ) ) );
+      sums = _mm512_add_ps ( sums, _mm512_maskz_shuffle_f32x4 ( all, sums, sums, _MM_SHUFFLE ( 1, 0, 3, 2 ) ) );
+      sums = _mm512_add_ps ( sums, _mm512_maskz_shuffle_f32x4 ( all, sums, sums, _MM_SHUFFLE ( 2, 3, 0, 1 ) ) );
+
+      alignas ( 64 ) float lanes[16];
+      _mm512_store_ps ( lanes, sums );
+
+      for ( size_t r = 0; r < 4; ++r )
+      {
+        output[k + r] = ACTIVATION::apply ( lanes[r] );
+      }
+    }
+
+    for ( size_t k = blocked; k < LINE_DIMENSION; ++k )
+    {
+      output[k] = ACTIVATION::apply (
+                    simd::simd_details::dot_traits<float, simd::isa::avx512>::method ( koefs + k * INPUT_DIMENSION, input, INPUT_DIMENSION ) );
+    }
+  }
+};
+
+template<size_t INPUT_DIMENSION, size_t LINE_DIMENSION, typename ACTIVATION>
+struct fixed_shape_kernel<double, simd::isa::avx512, INPUT_DIMENSION, LINE_DIMENSION, ACTIVATION>
+{
+  static constexpr size_t const blocked = LINE_DIMENSION / 4 * 4;
+  static constexpr size_t const full = INPUT_DIMENSION / 8 * 8;
+  static constexpr __mmask8 const tail_mask = __mmask8 ( ( 1u << ( INPUT_DIMENSION - full ) ) - 1 );
+  static constexpr __mmask8 const all = __mmask8 ( 0xFF );
+
+  __attribute__ ( ( target ( "avx512f" ) ) )
+  static void method ( double const* koefs, double const* input, double* output, size_t, size_t ) noexcept
+  {
+    for ( size_t k = 0; k < blocked; k += 4 )
+    {
+      double const* const row = koefs + k * INPUT_DIMENSION;
+
+      __m512d acc0 = _mm512_setzero_pd();
+      __m512d acc1 = _mm512_setzero_pd();
+      __m512d acc2 = _mm512_setzero_pd();
+      __m512d acc3 = _mm512_setzero_pd();
+
+      for ( size_t i = 0; i < full; i += 8 )
+      {
+        __m512d const x = _mm512_loadu_pd ( input + i );
+        acc0 = _mm512_fmadd_pd ( _mm512_loadu_pd ( row + i ), x, acc0 );
+        acc1 = _mm512_fmadd_pd ( _mm512_loadu_pd ( row + INPUT_DIMENSION + i ), x, acc1 );
+        acc2 = _mm512_fmadd_pd ( _mm512_loadu_pd ( row + 2 * INPUT_DIMENSION + i ), x, acc2 );
+        acc3 = _mm512_fmadd_pd ( _mm512_loadu_pd ( row + 3 * INPUT_DIMENSION + i ), x, acc3 );
+      }
+
+      if constexpr ( full < INPUT_DIMENSION )
+      {
+        __m512d const x = _mm512_maskz_loadu_pd ( tail_mask, input + full );
+        acc0 = _mm512_fmadd_pd ( _mm512_maskz_loadu_pd ( tail_mask, row + full ), x, acc0 );
+        acc1 = _mm512_fmadd_pd ( _mm512_maskz_loadu_pd ( tail_mask, row + INPUT_DIMENSION + full ), x, acc1 );
+        acc2 = _mm512_fmadd_pd ( _mm512_maskz_loadu_pd ( tail_mask, row + 2 * INPUT_DIMENSION + full ), x, acc2 );
+        acc3 = _mm512_fmadd_pd ( _mm512_maskz_loadu_pd ( tail_mask, row + 3 * INPUT_DIMENSION + full ), x, acc3 );
+      }
+
+      // the 128 bit lanes hold the sums of rows 0, 1 and of rows 2, 3, the lanes 0 and 2 get them all,
+      // the shuffles are in their maskz forms for gcc 12 as in the float kernel
+      __m512d const sums01 = _mm512_add_pd ( _mm512_maskz_unpacklo_pd ( all, acc0, acc1 ), _mm512_maskz_unpackhi_pd ( all, acc0, acc1 ) );
+      __m512d const sums23 = _mm512_add_pd ( _mm512_maskz_unpacklo_pd ( all, acc2, acc3 ), _mm512_maskz_unpackhi_pd ( all, acc2, acc3 ) );
+
+      __m512d sums = _mm512_add_pd ( _mm512_maskz_shuffle_f64x2 ( all, sums01, sums23, _MM_SHUFFLE ( 2, 0, 2, 0 ) ),
+                                     _mm512_maskz_shuffle_f64x2 ( all, sums01, sums23, _MM_SHUFFLE ( 3, 1, 3, 1 ) ) );
+      sums = _mm512_add_pd ( sums, _mm512_maskz_shuffle_f64x2 ( all, sums, sums, _MM_SHUFFLE ( 2, 3, 0, 1 ) ) );
+
+      alignas ( 64 ) double lanes[8];
+      _mm512_store_pd ( lanes, sums );
+
+      lanes[2] = lanes[4];
+      lanes[3] = lanes[5];
+
+      for ( size_t r = 0; r < 4; ++r )
+      {
+        output[k + r] = ACTIVATION::apply ( lanes[r] );
+      }
+    }
+
+    for ( size_t k = blocked; k < LINE_DIMENSION; ++k )
+    {
+      output[k] = ACTIVATION::apply (
+                    simd::simd_details::dot_traits<double, simd::isa::avx512>::method ( koefs + k * INPUT_DIMENSION, input, INPUT_DIMENSION ) );
+    }
+  }
+};
+
+#endif // NNET_SIMD_X86
+
+template<typename T, typename ACTIVATION>
+struct generic_kernel
+{
+  static void method ( T const* koefs, T const* input, T* output,
+                       size_t const input_dimension, size_t const line_dimension ) noexcept
+  {
+    for ( size_t k = 0; k < line_dimension; ++k )
+    {
+      output[k] = ACTIVATION::apply ( simd::dot<T> ( koefs + k * input_dimension, input, input_dimension ) );
+    }
+  }
+};
+
+template<typename T>
+struct dispatch_entry_t
+{
+  size_t input_dimension;
+  size_t line_dimension;
+  line_kernel_t<T> kernel;
+};
+
+template<typename T, typename ACTIVATION, simd::isa ISA, typename SHAPE_LIST>
+struct dispatch_table_traits;
+
+template<typename T, typename ACTIVATION, simd::isa ISA, typename ... SHAPES>
+struct dispatch_table_traits<T, ACTIVATION, ISA, line_shape_list_t<SHAPES...>>
+{
+  static constexpr std::array<dispatch_entry_t<T>, sizeof... ( SHAPES )> const table =
+  {
+    {
+      {
+        SHAPES::input_dimension, SHAPES::line_dimension,
+        &fixed_shape_kernel<T, ISA, SHAPES::input_dimension, SHAPES::line_dimension, ACTIVATION>::method
+      }...
+    }
+  };
+
+  static line_kernel_t<T> find ( size_t const input_dimension, size_t const line_dimension ) noexcept
+  {
+    for ( auto const& entry : table )
+    {
+      if ( entry.input_dimension == input_dimension && entry.line_dimension == line_dimension )
+      {
+        return entry.kernel;
+      }
+    }
+
+    return nullptr;
+  }
+};
+
+// the table of the instruction set, the types without simd kernels take the scalar one
+template<typename T, typename ACTIVATION, typename SHAPE_LIST>
+line_kernel_t<T> find_kernel ( simd::isa const instruction_set,
+                               size_t const input_dimension, size_t const line_dimension ) noexcept
+{
+  if constexpr ( !simd::has_dot_kernels<T>() )
+  {
+    return dispatch_table_traits<T, ACTIVATION, simd::isa::scalar, SHAPE_LIST>::find ( input_dimension, line_dimension );
+  }
+  else
+  {
+    switch ( instruction_set )
+    {
+    case simd::isa::sse2:
+      return dispatch_table_traits<T, ACTIVATION, simd::isa::sse2, SHAPE_LIST>::find ( input_dimension, line_dimension );
+
+    case simd::isa::avx2:
+      return dispatch_table_traits<T, ACTIVATION, simd::isa::avx2, SHAPE_LIST>::find ( input_dimension, line_dimension );
+
+    case simd::isa::avx512:
+    case simd::isa::avx512_vnni:
+      return dispatch_table_traits<T, ACTIVATION, simd::isa::avx512, SHAPE_LIST>::find ( input_dimension, line_dimension );
+
+    case simd::isa::scalar:
+    default:
+      return dispatch_table_traits<T, ACTIVATION, simd::isa::scalar, SHAPE_LIST>::find ( input_dimension, line_dimension );
+    }
+  }
+}
+
+}  // namespace shape_dispatch_details
+
+// a runtime-shaped line bound once to the kernel instantiated for its shape and the
+// instruction set of the running cpu, or to the generic kernel when SHAPE_LIST has no such shape
+template<typename INPUT_T,
+         typename ACTIVATION = activation::identity_t,
+         typename SHAPE_LIST = default_line_shapes>
+struct dispatched_line_t
+{
+  using input_t = INPUT_T;
+  using output_t = input_t;
+  using koef_t = input_t;
+  using activation_t = ACTIVATION;
+
+  explicit dispatched_line_t ( dynamic_neuron_line_t<input_t> const& line ) noexcept
+    : koefs ( line.koefs_data() )
+    , input_dimension ( line.get_input_dimension() )
+    , line_dimension ( line.size() )
+  {
+    kernel = shape_dispatch_details::find_kernel<input_t, activation_t, SHAPE_LIST> ( simd::get_isa(),
+             input_dimension, line_dimension );
+    path = kernel ? dispatch_path::specialized : dispatch_path::generic;
+
+    if ( !kernel )
+    {
+      kernel = shape_dispatch_details::generic_kernel<input_t, activation_t>::method;
+    }
+  }
+
+  dispatch_path get_path() const noexcept
+  {
+    return path;
+  }
+
+  size_t get_input_dimension() const noexcept
+  {
+    return input_dimension;
+  }
+
+  size_t size() const noexcept
+  {
+    return line_dimension;
+  }
+
+  // writes size () outputs, the koefs of the source line are read in place
+  void apply ( input_t const* input, output_t* output ) const noexcept
+  {
+    kernel ( koefs, input, output, input_dimension, line_dimension );
+  }
+
+private:
+  koef_t const* koefs;
+  size_t input_dimension;
+  size_t line_dimension;
+  shape_dispatch_details::line_kernel_t<input_t> kernel{};
+  dispatch_path path{};
+};
+
+} // namespace nnet
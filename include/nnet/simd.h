@@ -0,0 +1,1042 @@
+#pragma once
+
+#include <nnet/half.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cmath>
+#include <numeric>
+#include <type_traits>
+
+#if defined ( __x86_64__ ) || defined ( __i386__ )
+  #include <immintrin.h>
+  #define NNET_SIMD_X86 1
+#endif
+
+namespace nnet
+{
+
+namespace simd
+{
+
+enum class isa
+{
+  scalar,
+  sse2,
+  avx2,
+  avx512,
+  avx512_vnni
+};
+
+template<typename T>
+using dot_kernel_t = T ( * ) ( T const*, T const*, size_t );
+
+// unsigned 8 bit activations times signed 8 bit koefs, accumulated exactly in int32
+using dot_u8s8_kernel_t = int32_t ( * ) ( uint8_t const*, int8_t const*, size_t );
+
+// float activations times bf16_t or fp16_t koefs, widened to float and accumulated in float
+template<typename HALF_T>
+using dot_half_kernel_t = float ( * ) ( float const*, HALF_T const*, size_t );
+
+// the sum of ( a[i] - b[i] )^2 or of | a[i] - b[i] |
+enum class diff_norm
+{
+  squared,
+  absolute
+};
+
+template<typename T>
+using diff_sum_kernel_t = T ( * ) ( T const*, T const*, size_t );
+
+template<typename T>
+constexpr bool has_diff_sum_kernels()
+{
+  return std::is_same<T, float>::value || std::is_same<T, double>::value;
+}
+
+template<typename T>
+constexpr bool has_dot_kernels()
+{
+  return std::is_same<T, float>::value
+         || std::is_same<T, double>::value
+         || std::is_same<T, int32_t>::value;
+}
+
+namespace simd_details
+{
+
+template<typename T, isa ISA>
+struct dot_traits
+{
+  static T method ( T const* a, T const* b, size_t n ) noexcept
+  {
+    return std::inner_product ( a, a + n, b, T{} );
+  }
+};
+
+template<isa ISA>
+struct dot_u8s8_traits
+{
+  static int32_t method ( uint8_t const* a, int8_t const* b, size_t n ) noexcept
+  {
+    int32_t result{};
+
+    for ( size_t i = 0; i < n; ++i )
+    {
+      result += static_cast<int32_t> ( a[i] ) * static_cast<int32_t> ( b[i] );
+    }
+
+    return result;
+  }
+};
+
+template<typename HALF_T, isa ISA>
+struct dot_half_traits
+{
+  static float method ( float const* a, HALF_T const* b, size_t n ) noexcept
+  {
+    float result{};
+
+    for ( size_t i = 0; i < n; ++i )
+    {
+      result += a[i] * b[i].to_float();
+    }
+
+    return result;
+  }
+};
+
+template<typename T, isa ISA, diff_norm NORM>
+struct diff_sum_traits
+{
+  static T method ( T const* a, T const* b, size_t n ) noexcept
+  {
+    T result{};
+
+    for ( size_t i = 0; i < n; ++i )
+    {
+      auto const d = a[i] - b[i];
+      result += ( NORM == diff_norm::squared ) ? d * d : std::fabs ( d );
+    }
+
+    return result;
+  }
+};
+
+// the stored lanes of a vector summed pairwise, the avx512 kernels use it instead of
+// _mm512_reduce_add_*, which trips a false -Wuninitialized of gcc 12 at -O2
+template<typename T, size_t N>
+inline T sum_lanes ( T const* lanes ) noexcept
+{
+  if constexpr ( N == 1 )
+  {
+    return lanes[0];
+  }
+  else
+  {
+    return sum_lanes < T, N / 2 > ( lanes ) + sum_lanes < T, N / 2 > ( lanes + N / 2 );
+  }
+}
+
+#if defined ( NNET_SIMD_X86 )
+
+//-----------------------------------------------------------------------------
+// sse2
+
+__attribute__ ( ( target ( "sse2" ) ) )
+inline __m128i mullo_epi32_sse2 ( __m128i a, __m128i b ) noexcept
+{
+  // sse2 has no pmulld, the low halves of the unsigned products are the same
+  __m128i const even = _mm_mul_epu32 ( a, b );
+  __m128i const odd = _mm_mul_epu32 ( _mm_srli_epi64 ( a, 32 ), _mm_srli_epi64 ( b, 32 ) );
+
+  return _mm_unpacklo_epi32 ( _mm_shuffle_epi32 ( even, _MM_SHUFFLE ( 0, 0, 2, 0 ) ),
+                              _mm_shuffle_epi32 ( odd, _MM_SHUFFLE ( 0, 0, 2, 0 ) ) );
+}
+
+template<>
+struct dot_traits<float, isa::sse2>
+{
+  __attribute__ ( ( target ( "sse2" ) ) )
+  static float method ( float const* a, float const* b, size_t n ) noexcept
+  {
+    __m128 acc0 = _mm_setzero_ps();
+    __m128 acc1 = _mm_setzero_ps();
+
+    size_t i = 0;
+
+    for ( ; i + 8 <= n; i += 8 )
+    {
+      acc0 = _mm_add_ps ( acc0, _mm_mul_ps ( _mm_loadu_ps ( a + i ), _mm_loadu_ps ( b + i ) ) );
+      acc1 = _mm_add_ps ( acc1, _mm_mul_ps ( _mm_loadu_ps ( a + i + 4 ), _mm_loadu_ps ( b + i + 4 ) ) );
+    }
+
+    alignas ( 16 ) float lanes[4];
+    _mm_store_ps ( lanes, _mm_add_ps ( acc0, acc1 ) );
+
+    float result = ( lanes[0] + lanes[1] ) + ( lanes[2] + lanes[3] );
+
+    for ( ; i < n; ++i )
+    {
+      result += a[i] * b[i];
+    }
+
+    return result;
+  }
+};
+
+template<>
+struct dot_traits<double, isa::sse2>
+{
+  __attribute__ ( ( target ( "sse2" ) ) )
+  static double method ( double const* a, double const* b, size_t n ) noexcept
+  {
+    __m128d acc0 = _mm_setzero_pd();
+    __m128d acc1 = _mm_setzero_pd();
+
+    size_t i = 0;
+
+    for ( ; i + 4 <= n; i += 4 )
+    {
+      acc0 = _mm_add_pd ( acc0, _mm_mul_pd ( _mm_loadu_pd ( a + i ), _mm_loadu_pd ( b + i ) ) );
+      acc1 = _mm_add_pd ( acc1, _mm_mul_pd ( _mm_loadu_pd ( a + i + 2 ), _mm_loadu_pd ( b + i + 2 ) ) );
+    }
+
+    alignas ( 16 ) double lanes[2];
+    _mm_store_pd ( lanes, _mm_add_pd ( acc0, acc1 ) );
+
+    double result = lanes[0] + lanes[1];
+
+    for ( ; i < n; ++i )
+    {
+      result += a[i] * b[i];
+    }
+
+    return result;
+  }
+};
+
+template<>
+struct dot_traits<int32_t, isa::sse2>
+{
+  __attribute__ ( ( target ( "sse2" ) ) )
+  static int32_t method ( int32_t const* a, int32_t const* b, size_t n ) noexcept
+  {
+    __m128i acc = _mm_setzero_si128();
+
+    size_t i = 0;
+
+    for ( ; i + 4 <= n; i += 4 )
+    {
+      __m128i const va = _mm_loadu_si128 ( reinterpret_cast<__m128i const*> ( a + i ) );
+      __m128i const vb = _mm_loadu_si128 ( reinterpret_cast<__m128i const*> ( b + i ) );
+      acc = _mm_add_epi32 ( acc, mullo_epi32_sse2 ( va, vb ) );
+    }
+
+    alignas ( 16 ) int32_t lanes[4];
+    _mm_store_si128 ( reinterpret_cast<__m128i*> ( lanes ), acc );
+
+    int32_t result = ( lanes[0] + lanes[1] ) + ( lanes[2] + lanes[3] );
+
+    for ( ; i < n; ++i )
+    {
+      result += a[i] * b[i];
+    }
+
+    return result;
+  }
+};
+
+//-----------------------------------------------------------------------------
+// avx2
+
+template<>
+struct dot_traits<float, isa::avx2>
+{
+  __attribute__ ( ( target ( "avx2,fma" ) ) )
+  static float method ( float const* a, float const* b, size_t n ) noexcept
+  {
+    __m256 acc0 = _mm256_setzero_ps();
+    __m256 acc1 = _mm256_setzero_ps();
+
+    size_t i = 0;
+
+    for ( ; i + 16 <= n; i += 16 )
+    {
+      acc0 = _mm256_fmadd_ps ( _mm256_loadu_ps ( a + i ), _mm256_loadu_ps ( b + i ), acc0 );
+      acc1 = _mm256_fmadd_ps ( _mm256_loadu_ps ( a + i + 8 ), _mm256_loadu_ps ( b + i + 8 ), acc1 );
+    }
+
+    for ( ; i + 8 <= n; i += 8 )
+    {
+      acc0 = _mm256_fmadd_ps ( _mm256_loadu_ps ( a + i ), _mm256_loadu_ps ( b + i ), acc0 );
+    }
+
+    alignas ( 32 ) float lanes[8];
+    _mm256_store_ps ( lanes, _mm256_add_ps ( acc0, acc1 ) );
+
+    float result = ( ( lanes[0] + lanes[1] ) + ( lanes[2] + lanes[3] ) )
+                   + ( ( lanes[4] + lanes[5] ) + ( lanes[6] + lanes[7] ) );
+
+    for ( ; i < n; ++i )
+    {
+      result += a[i] * b[i];
+    }
+
+    return result;
+  }
+};
+
+template<>
+struct dot_traits<double, isa::avx2>
+{
+  __attribute__ ( ( target ( "avx2,fma" ) ) )
+  static double method ( double const* a, double const* b, size_t n ) noexcept
+  {
+    __m256d acc0 = _mm256_setzero_pd();
+    __m256d acc1 = _mm256_setzero_pd();
+
+    size_t i = 0;
+
+    for ( ; i + 8 <= n; i += 8 )
+    {
+      acc0 = _mm256_fmadd_pd ( _mm256_loadu_pd ( a + i ), _mm256_loadu_pd ( b + i ), acc0 );
+      acc1 = _mm256_fmadd_pd ( _mm256_loadu_pd ( a + i + 4 ), _mm256_loadu_pd ( b + i + 4 ), acc1 );
+    }
+
+    for ( ; i + 4 <= n; i += 4 )
+    {
+      acc0 = _mm256_fmadd_pd ( _mm256_loadu_pd ( a + i ), _mm256_loadu_pd ( b + i ), acc0 );
+    }
+
+    alignas ( 32 ) double lanes[4];
+    _mm256_store_pd ( lanes, _mm256_add_pd ( acc0, acc1 ) );
+
+    double result = ( lanes[0] + lanes[1] ) + ( lanes[2] + lanes[3] );
+
+    for ( ; i < n; ++i )
+    {
+      result += a[i] * b[i];
+    }
+
+    return result;
+  }
+};
+
+template<>
+struct dot_traits<int32_t, isa::avx2>
+{
+  __attribute__ ( ( target ( "avx2" ) ) )
+  static int32_t method ( int32_t const* a, int32_t const* b, size_t n ) noexcept
+  {
+    __m256i acc = _mm256_setzero_si256();
+
+    size_t i = 0;
+
+    for ( ; i + 8 <= n; i += 8 )
+    {
+      __m256i const va = _mm256_loadu_si256 ( reinterpret_cast<__m256i const*> ( a + i ) );
+      __m256i const vb = _mm256_loadu_si256 ( reinterpret_cast<__m256i const*> ( b + i ) );
+      acc = _mm256_add_epi32 ( acc, _mm256_mullo_epi32 ( va, vb ) );
+    }
+
+    alignas ( 32 ) int32_t lanes[8];
+    _mm256_store_si256 ( reinterpret_cast<__m256i*> ( lanes ), acc );
+
+    int32_t result = ( ( lanes[0] + lanes[1] ) + ( lanes[2] + lanes[3] ) )
+                     + ( ( lanes[4] + lanes[5] ) + ( lanes[6] + lanes[7] ) );
+
+    for ( ; i < n; ++i )
+    {
+      result += a[i] * b[i];
+    }
+
+    return result;
+  }
+};
+
+//-----------------------------------------------------------------------------
+// avx512, the tail is handled with masked loads
+
+template<>
+struct dot_traits<float, isa::avx512>
+{
+  __attribute__ ( ( target ( "avx512f" ) ) )
+  static float method ( float const* a, float const* b, size_t n ) noexcept
+  {
+    __m512 acc0 = _mm512_setzero_ps();
+    __m512 acc1 = _mm512_setzero_ps();
+
+    size_t i = 0;
+
+    for ( ; i + 32 <= n; i += 32 )
+    {
+      acc0 = _mm512_fmadd_ps ( _mm512_loadu_ps ( a + i ), _mm512_loadu_ps ( b + i ), acc0 );
+      acc1 = _mm512_fmadd_ps ( _mm512_loadu_ps ( a + i + 16 ), _mm512_loadu_ps ( b + i + 16 ), acc1 );
+    }
+
+    for ( ; i < n; i += 16 )
+    {
+      __mmask16 const mask = ( n - i >= 16 ) ? __mmask16 ( 0xFFFF ) : __mmask16 ( ( 1u << ( n - i ) ) - 1 );
+      acc0 = _mm512_fmadd_ps ( _mm512_maskz_loadu_ps ( mask, a + i ), _mm512_maskz_loadu_ps ( mask, b + i ), acc0 );
+    }
+
+    alignas ( 64 ) float lanes[16];
+    _mm512_store_ps ( lanes, _mm512_add_ps ( acc0, acc1 ) );
+
+    return sum_lanes<float, 16> ( lanes );
+  }
+};
+
+template<>
+struct dot_traits<double, isa::avx512>
+{
+  __attribute__ ( ( target ( "avx512f" ) ) )
+  static double method ( double const* a, double const* b, size_t n ) noexcept
+  {
+    __m512d acc0 = _mm512_setzero_pd();
+    __m512d acc1 = _mm512_setzero_pd();
+
+    size_t i = 0;
+
+    for ( ; i + 16 <= n; i += 16 )
+    {
+      acc0 = _mm512_fmadd_pd ( _mm512_loadu_pd ( a + i ), _mm512_loadu_pd ( b + i ), acc0 );
+      acc1 = _mm512_fmadd_pd ( _mm512_loadu_pd ( a + i + 8 ), _mm512_loadu_pd ( b + i + 8 ), acc1 );
+    }
+
+    for ( ; i < n; i += 8 )
+    {
+      __mmask8 const mask = ( n - i >= 8 ) ? __mmask8 ( 0xFF ) : __mmask8 ( ( 1u << ( n - i ) ) - 1 );
+      acc0 = _mm512_fmadd_pd ( _mm512_maskz_loadu_pd ( mask, a + i ), _mm512_maskz_loadu_pd ( mask, b + i ), acc0 );
+    }
+
+    alignas ( 64 ) double lanes[8];
+    _mm512_store_pd ( lanes, _mm512_add_pd ( acc0, acc1 ) );
+
+    return sum_lanes<double, 8> ( lanes );
+  }
+};
+
+template<>
+struct dot_traits<int32_t, isa::avx512>
+{
+  __attribute__ ( ( target ( "avx512f" ) ) )
+  static int32_t method ( int32_t const* a, int32_t const* b, size_t n ) noexcept
+  {
+    __m512i acc = _mm512_setzero_si512();
+
+    for ( size_t i = 0; i < n; i += 16 )
+    {
+      __mmask16 const mask = ( n - i >= 16 ) ? __mmask16 ( 0xFFFF ) : __mmask16 ( ( 1u << ( n - i ) ) - 1 );
+      __m512i const va = _mm512_maskz_loadu_epi32 ( mask, a + i );
+      __m512i const vb = _mm512_maskz_loadu_epi32 ( mask, b + i );
+      acc = _mm512_add_epi32 ( acc, _mm512_mullo_epi32 ( va, vb ) );
+    }
+
+    alignas ( 64 ) int32_t lanes[16];
+    _mm512_store_si512 ( lanes, acc );
+
+    return sum_lanes<int32_t, 16> ( lanes );
+  }
+};
+
+//-----------------------------------------------------------------------------
+// u8 x s8, pmaddubsw saturates the int16 pair sums, so the bytes are widened
+// to int16 and multiplied with pmaddwd which is exact, vpdpbusd is exact too
+
+template<>
+struct dot_u8s8_traits<isa::sse2>
+{
+  __attribute__ ( ( target ( "sse2" ) ) )
+  static int32_t method ( uint8_t const* a, int8_t const* b, size_t n ) noexcept
+  {
+    __m128i const zero = _mm_setzero_si128();
+    __m128i acc = _mm_setzero_si128();
+
+    size_t i = 0;
+
+    for ( ; i + 16 <= n; i += 16 )
+    {
+      __m128i const va = _mm_loadu_si128 ( reinterpret_cast<__m128i const*> ( a + i ) );
+      __m128i const vb = _mm_loadu_si128 ( reinterpret_cast<__m128i const*> ( b + i ) );
+      __m128i const sign = _mm_cmpgt_epi8 ( zero, vb );
+
+      acc = _mm_add_epi32 ( acc, _mm_madd_epi16 ( _mm_unpacklo_epi8 ( va, zero ), _mm_unpacklo_epi8 ( vb, sign ) ) );
+      acc = _mm_add_epi32 ( acc, _mm_madd_epi16 ( _mm_unpackhi_epi8 ( va, zero ), _mm_unpackhi_epi8 ( vb, sign ) ) );
+    }
+
+    alignas ( 16 ) int32_t lanes[4];
+    _mm_store_si128 ( reinterpret_cast<__m128i*> ( lanes ), acc );
+
+    return ( lanes[0] + lanes[1] ) + ( lanes[2] + lanes[3] )
+           + dot_u8s8_traits<isa::scalar>::method ( a + i, b + i, n - i );
+  }
+};
+
+template<>
+struct dot_u8s8_traits<isa::avx2>
+{
+  __attribute__ ( ( target ( "avx2" ) ) )
+  static int32_t method ( uint8_t const* a, int8_t const* b, size_t n ) noexcept
+  {
+    __m256i acc = _mm256_setzero_si256();
+
+    size_t i = 0;
+
+    for ( ; i + 16 <= n; i += 16 )
+    {
+      __m256i const va = _mm256_cvtepu8_epi16 ( _mm_loadu_si128 ( reinterpret_cast<__m128i const*> ( a + i ) ) );
+      __m256i const vb = _mm256_cvtepi8_epi16 ( _mm_loadu_si128 ( reinterpret_cast<__m128i const*> ( b + i ) ) );
+
+      acc = _mm256_add_epi32 ( acc, _mm256_madd_epi16 ( va, vb ) );
+    }
+
+    alignas ( 32 ) int32_t lanes[8];
+    _mm256_store_si256 ( reinterpret_cast<__m256i*> ( lanes ), acc );
+
+    return ( ( lanes[0] + lanes[1] ) + ( lanes[2] + lanes[3] ) )
+           + ( ( lanes[4] + lanes[5] ) + ( lanes[6] + lanes[7] ) )
+           + dot_u8s8_traits<isa::scalar>::method ( a + i, b + i, n - i );
+  }
+};
+
+template<>
+struct dot_u8s8_traits<isa::avx512> : dot_u8s8_traits<isa::avx2>
+{
+};
+
+template<>
+struct dot_u8s8_traits<isa::avx512_vnni>
+{
+  __attribute__ ( ( target ( "avx512f,avx512bw,avx512vnni" ) ) )
+  static int32_t method ( uint8_t const* a, int8_t const* b, size_t n ) noexcept
+  {
+    __m512i acc = _mm512_setzero_si512();
+
+    for ( size_t i = 0; i < n; i += 64 )
+    {
+      __mmask64 const mask = ( n - i >= 64 ) ? ~__mmask64 ( 0 ) : ( __mmask64 ( 1 ) << ( n - i ) ) - 1;
+
+      acc = _mm512_dpbusd_epi32 ( acc, _mm512_maskz_loadu_epi8 ( mask, a + i ), _mm512_maskz_loadu_epi8 ( mask, b + i ) );
+    }
+
+    alignas ( 64 ) int32_t lanes[16];
+    _mm512_store_si512 ( lanes, acc );
+
+    return sum_lanes<int32_t, 16> ( lanes );
+  }
+};
+
+//-----------------------------------------------------------------------------
+// float x half, bf16 widens with a 16 bit shift, fp16 with vcvtph2ps;
+// vdpbf16ps is not used since it would round the float activations to bf16 too
+
+template<typename HALF_T, isa ISA>
+struct half_load_traits;
+
+template<>
+struct half_load_traits<bf16_t, isa::avx2>
+{
+  __attribute__ ( ( target ( "avx2,fma" ) ) )
+  static __m256 load ( bf16_t const* b ) noexcept
+  {
+    __m128i const halves = _mm_loadu_si128 ( reinterpret_cast<__m128i const*> ( b ) );
+    return _mm256_castsi256_ps ( _mm256_slli_epi32 ( _mm256_cvtepu16_epi32 ( halves ), 16 ) );
+  }
+};
+
+template<>
+struct half_load_traits<fp16_t, isa::avx2>
+{
+  __attribute__ ( ( target ( "avx2,fma,f16c" ) ) )
+  static __m256 load ( fp16_t const* b ) noexcept
+  {
+    return _mm256_cvtph_ps ( _mm_loadu_si128 ( reinterpret_cast<__m128i const*> ( b ) ) );
+  }
+};
+
+template<typename HALF_T>
+struct dot_half_traits<HALF_T, isa::avx2>
+{
+  using load_traits = half_load_traits<HALF_T, isa::avx2>;
+
+  __attribute__ ( ( target ( "avx2,fma,f16c" ) ) )
+  static float method ( float const* a, HALF_T const* b, size_t n ) noexcept
+  {
+    __m256 acc0 = _mm256_setzero_ps();
+    __m256 acc1 = _mm256_setzero_ps();
+
+    size_t i = 0;
+
+    for ( ; i + 16 <= n; i += 16 )
+    {
+      acc0 = _mm256_fmadd_ps ( _mm256_loadu_ps ( a + i ), load_traits::load ( b + i ), acc0 );
+      acc1 = _mm256_fmadd_ps ( _mm256_loadu_ps ( a + i + 8 ), load_traits::load ( b + i + 8 ), acc1 );
+    }
+
+    for ( ; i + 8 <= n; i += 8 )
+    {
+      acc0 = _mm256_fmadd_ps ( _mm256_loadu_ps ( a + i ), load_traits::load ( b + i ), acc0 );
+    }
+
+    alignas ( 32 ) float lanes[8];
+    _mm256_store_ps ( lanes, _mm256_add_ps ( acc0, acc1 ) );
+
+    return ( ( lanes[0] + lanes[1] ) + ( lanes[2] + lanes[3] ) )
+           + ( ( lanes[4] + lanes[5] ) + ( lanes[6] + lanes[7] ) )
+           + dot_half_traits<HALF_T, isa::scalar>::method ( a + i, b + i, n - i );
+  }
+};
+
+template<>
+struct half_load_traits<bf16_t, isa::avx512>
+{
+  __attribute__ ( ( target ( "avx512f" ) ) )
+  static __m512 load ( bf16_t const* b ) noexcept
+  {
+    __m256i const halves = _mm256_loadu_si256 ( reinterpret_cast<__m256i const*> ( b ) );
+    return _mm512_castsi512_ps ( _mm512_slli_epi32 ( _mm512_cvtepu16_epi32 ( halves ), 16 ) );
+  }
+};
+
+template<>
+struct half_load_traits<fp16_t, isa::avx512>
+{
+  __attribute__ ( ( target ( "avx512f" ) ) )
+  static __m512 load ( fp16_t const* b ) noexcept
+  {
+    return _mm512_cvtph_ps ( _mm256_loadu_si256 ( reinterpret_cast<__m256i const*> ( b ) ) );
+  }
+};
+
+template<typename HALF_T>
+struct dot_half_traits<HALF_T, isa::avx512>
+{
+  using load_traits = half_load_traits<HALF_T, isa::avx512>;
+
+  __attribute__ ( ( target ( "avx512f" ) ) )
+  static float method ( float const* a, HALF_T const* b, size_t n ) noexcept
+  {
+    __m512 acc0 = _mm512_setzero_ps();
+    __m512 acc1 = _mm512_setzero_ps();
+
+    size_t i = 0;
+
+    for ( ; i + 32 <= n; i += 32 )
+    {
+      acc0 = _mm512_fmadd_ps ( _mm512_loadu_ps ( a + i ), load_traits::load ( b + i ), acc0 );
+      acc1 = _mm512_fmadd_ps ( _mm512_loadu_ps ( a + i + 16 ), load_traits::load ( b + i + 16 ), acc1 );
+    }
+
+    for ( ; i + 16 <= n; i += 16 )
+    {
+      acc0 = _mm512_fmadd_ps ( _mm512_loadu_ps ( a + i ), load_traits::load ( b + i ), acc0 );
+    }
+
+    alignas ( 64 ) float lanes[16];
+    _mm512_store_ps ( lanes, _mm512_add_ps ( acc0, acc1 ) );
+
+    return sum_lanes<float, 16> ( lanes )
+           + dot_half_traits<HALF_T, isa::scalar>::method ( a + i, b + i, n - i );
+  }
+};
+
+//-----------------------------------------------------------------------------
+// the differences, the absolute value clears the sign bit
+
+template<diff_norm NORM>
+struct diff_sum_traits<float, isa::sse2, NORM>
+{
+  __attribute__ ( ( target ( "sse2" ) ) )
+  static float method ( float const* a, float const* b, size_t n ) noexcept
+  {
+    __m128 const sign = _mm_set1_ps ( -0.0f );
+    __m128 acc0 = _mm_setzero_ps();
+    __m128 acc1 = _mm_setzero_ps();
+
+    size_t i = 0;
+
+    for ( ; i + 8 <= n; i += 8 )
+    {
+      __m128 const d0 = _mm_sub_ps ( _mm_loadu_ps ( a + i ), _mm_loadu_ps ( b + i ) );
+      __m128 const d1 = _mm_sub_ps ( _mm_loadu_ps ( a + i + 4 ), _mm_loadu_ps ( b + i + 4 ) );
+
+      if constexpr ( NORM == diff_norm::squared )
+      {
+        acc0 = _mm_add_ps ( acc0, _mm_mul_ps ( d0, d0 ) );
+        acc1 = _mm_add_ps ( acc1, _mm_mul_ps ( d1, d1 ) );
+      }
+      else
+      {
+        acc0 = _mm_add_ps ( acc0, _mm_andnot_ps ( sign, d0 ) );
+        acc1 = _mm_add_ps ( acc1, _mm_andnot_ps ( sign, d1 ) );
+      }
+    }
+
+    alignas ( 16 ) float lanes[4];
+    _mm_store_ps ( lanes, _mm_add_ps ( acc0, acc1 ) );
+
+    return sum_lanes<float, 4> ( lanes ) + diff_sum_traits<float, isa::scalar, NORM>::method ( a + i, b + i, n - i );
+  }
+};
+
+template<diff_norm NORM>
+struct diff_sum_traits<double, isa::sse2, NORM>
+{
+  __attribute__ ( ( target ( "sse2" ) ) )
+  static double method ( double const* a, double const* b, size_t n ) noexcept
+  {
+    __m128d const sign = _mm_set1_pd ( -0.0 );
+    __m128d acc0 = _mm_setzero_pd();
+    __m128d acc1 = _mm_setzero_pd();
+
+    size_t i = 0;
+
+    for ( ; i + 4 <= n; i += 4 )
+    {
+      __m128d const d0 = _mm_sub_pd ( _mm_loadu_pd ( a + i ), _mm_loadu_pd ( b + i ) );
+      __m128d const d1 = _mm_sub_pd ( _mm_loadu_pd ( a + i + 2 ), _mm_loadu_pd ( b + i + 2 ) );
+
+      if constexpr ( NORM == diff_norm::squared )
+      {
+        acc0 = _mm_add_pd ( acc0, _mm_mul_pd ( d0, d0 ) );
+        acc1 = _mm_add_pd ( acc1, _mm_mul_pd ( d1, d1 ) );
+      }
+      else
+      {
+        acc0 = _mm_add_pd ( acc0, _mm_andnot_pd ( sign, d0 ) );
+        acc1 = _mm_add_pd ( acc1, _mm_andnot_pd ( sign, d1 ) );
+      }
+    }
+
+    alignas ( 16 ) double lanes[2];
+    _mm_store_pd ( lanes, _mm_add_pd ( acc0, acc1 ) );
+
+    return sum_lanes<double, 2> ( lanes ) + diff_sum_traits<double, isa::scalar, NORM>::method ( a + i, b + i, n - i );
+  }
+};
+
+template<diff_norm NORM>
+struct diff_sum_traits<float, isa::avx2, NORM>
+{
+  __attribute__ ( ( target ( "avx2,fma" ) ) )
+  static float method ( float const* a, float const* b, size_t n ) noexcept
+  {
+    __m256 const sign = _mm256_set1_ps ( -0.0f );
+    __m256 acc0 = _mm256_setzero_ps();
+    __m256 acc1 = _mm256_setzero_ps();
+
+    size_t i = 0;
+
+    for ( ; i + 16 <= n; i += 16 )
+    {
+      __m256 const d0 = _mm256_sub_ps ( _mm256_loadu_ps ( a + i ), _mm256_loadu_ps ( b + i ) );
+      __m256 const d1 = _mm256_sub_ps ( _mm256_loadu_ps ( a + i + 8 ), _mm256_loadu_ps ( b + i + 8 ) );
+
+      if constexpr ( NORM == diff_norm::squared )
+      {
+        acc0 = _mm256_fmadd_ps ( d0, d0, acc0 );
+        acc1 = _mm256_fmadd_ps ( d1, d1, acc1 );
+      }
+      else
+      {
+        acc0 = _mm256_add_ps ( acc0, _mm256_andnot_ps ( sign, d0 ) );
+        acc1 = _mm256_add_ps ( acc1, _mm256_andnot_ps ( sign, d1 ) );
+      }
+    }
+
+    alignas ( 32 ) float lanes[8];
+    _mm256_store_ps ( lanes, _mm256_add_ps ( acc0, acc1 ) );
+
+    return sum_lanes<float, 8> ( lanes ) + diff_sum_traits<float, isa::scalar, NORM>::method ( a + i, b + i, n - i );
+  }
+};
+
+template<diff_norm NORM>
+struct diff_sum_traits<double, isa::avx2, NORM>
+{
+  __attribute__ ( ( target ( "avx2,fma" ) ) )
+  static double method ( double const* a, double const* b, size_t n ) noexcept
+  {
+    __m256d const sign = _mm256_set1_pd ( -0.0 );
+    __m256d acc0 = _mm256_setzero_pd();
+    __m256d acc1 = _mm256_setzero_pd();
+
+    size_t i = 0;
+
+    for ( ; i + 8 <= n; i += 8 )
+    {
+      __m256d const d0 = _mm256_sub_pd ( _mm256_loadu_pd ( a + i ), _mm256_loadu_pd ( b + i ) );
+      __m256d const d1 = _mm256_sub_pd ( _mm256_loadu_pd ( a + i + 4 ), _mm256_loadu_pd ( b + i + 4 ) );
+
+      if constexpr ( NORM == diff_norm::squared )
+      {
+        acc0 = _mm256_fmadd_pd ( d0, d0, acc0 );
+        acc1 = _mm256_fmadd_pd ( d1, d1, acc1 );
+      }
+      else
+      {
+        acc0 = _mm256_add_pd ( acc0, _mm256_andnot_pd ( sign, d0 ) );
+        acc1 = _mm256_add_pd ( acc1, _mm256_andnot_pd ( sign, d1 ) );
+      }
+    }
+
+    alignas ( 32 ) double lanes[4];
+    _mm256_store_pd ( lanes, _mm256_add_pd ( acc0, acc1 ) );
+
+    return sum_lanes<double, 4> ( lanes ) + diff_sum_traits<double, isa::scalar, NORM>::method ( a + i, b + i, n - i );
+  }
+};
+
+// the masked tail loads zeros into both operands, so the tail lanes add nothing
+template<diff_norm NORM>
+struct diff_sum_traits<float, isa::avx512, NORM>
+{
+  __attribute__ ( ( target ( "avx512f" ) ) )
+  static float method ( float const* a, float const* b, size_t n ) noexcept
+  {
+    __m512 acc = _mm512_setzero_ps();
+
+    for ( size_t i = 0; i < n; i += 16 )
+    {
+      __mmask16 const mask = ( n - i >= 16 ) ? __mmask16 ( 0xFFFF ) : __mmask16 ( ( 1u << ( n - i ) ) - 1 );
+      __m512 const d = _mm512_sub_ps ( _mm512_maskz_loadu_ps ( mask, a + i ), _mm512_maskz_loadu_ps ( mask, b + i ) );
+
+      if constexpr ( NORM == diff_norm::squared )
+      {
+        acc = _mm512_fmadd_ps ( d, d, acc );
+      }
+      else
+      {
+        acc = _mm512_add_ps ( acc, _mm512_abs_ps ( d ) );
+      }
+    }
+
+    alignas ( 64 ) float lanes[16];
+    _mm512_store_ps ( lanes, acc );
+
+    return sum_lanes<float, 16> ( lanes );
+  }
+};
+
+template<diff_norm NORM>
+struct diff_sum_traits<double, isa::avx512, NORM>
+{
+  __attribute__ ( ( target ( "avx512f" ) ) )
+  static double method ( double const* a, double const* b, size_t n ) noexcept
+  {
+    __m512d acc = _mm512_setzero_pd();
+
+    for ( size_t i = 0; i < n; i += 8 )
+    {
+      __mmask8 const mask = ( n - i >= 8 ) ? __mmask8 ( 0xFF ) : __mmask8 ( ( 1u << ( n - i ) ) - 1 );
+      __m512d const d = _mm512_sub_pd ( _mm512_maskz_loadu_pd ( mask, a + i ), _mm512_maskz_loadu_pd ( mask, b + i ) );
+
+      if constexpr ( NORM == diff_norm::squared )
+      {
+        acc = _mm512_fmadd_pd ( d, d, acc );
+      }
+      else
+      {
+        acc = _mm512_add_pd ( acc, _mm512_abs_pd ( d ) );
+      }
+    }
+
+    alignas ( 64 ) double lanes[8];
+    _mm512_store_pd ( lanes, acc );
+
+    return sum_lanes<double, 8> ( lanes );
+  }
+};
+
+#endif // NNET_SIMD_X86
+
+inline isa detect_isa() noexcept
+{
+#if defined ( NNET_SIMD_X86 )
+  __builtin_cpu_init();
+
+  if ( __builtin_cpu_supports ( "avx512f" ) && __builtin_cpu_supports ( "avx512bw" )
+       && __builtin_cpu_supports ( "avx512vnni" ) )
+  {
+    return isa::avx512_vnni;
+  }
+
+  if ( __builtin_cpu_supports ( "avx512f" ) )
+  {
+    return isa::avx512;
+  }
+
+  if ( __builtin_cpu_supports ( "avx2" ) && __builtin_cpu_supports ( "fma" ) )
+  {
+    return isa::avx2;
+  }
+
+  if ( __builtin_cpu_supports ( "sse2" ) )
+  {
+    return isa::sse2;
+  }
+
+#endif
+
+  return isa::scalar;
+}
+
+// f16c is not implied by the avx2 level
+inline bool supports_f16c() noexcept
+{
+#if defined ( NNET_SIMD_X86 )
+  __builtin_cpu_init();
+  return __builtin_cpu_supports ( "f16c" );
+#else
+  return false;
+#endif
+}
+
+}  // namespace simd_details
+
+// the best instruction set of the running cpu, detected once
+inline isa get_isa() noexcept
+{
+  static isa const detected = simd_details::detect_isa();
+  return detected;
+}
+
+template<typename T>
+dot_kernel_t<T> get_dot_kernel ( isa const instruction_set ) noexcept
+{
+  switch ( instruction_set )
+  {
+  case isa::sse2:
+    return simd_details::dot_traits<T, isa::sse2>::method;
+
+  case isa::avx2:
+    return simd_details::dot_traits<T, isa::avx2>::method;
+
+  case isa::avx512:
+  case isa::avx512_vnni:
+    return simd_details::dot_traits<T, isa::avx512>::method;
+
+  case isa::scalar:
+  default:
+    return simd_details::dot_traits<T, isa::scalar>::method;
+  }
+}
+
+template<typename T>
+T dot ( T const* a, T const* b, size_t n ) noexcept
+{
+  if constexpr ( has_dot_kernels<T>() )
+  {
+    static dot_kernel_t<T> const kernel = get_dot_kernel<T> ( get_isa() );
+    return kernel ( a, b, n );
+  }
+  else
+  {
+    return simd_details::dot_traits<T, isa::scalar>::method ( a, b, n );
+  }
+}
+
+template<typename T, diff_norm NORM>
+diff_sum_kernel_t<T> get_diff_sum_kernel ( isa const instruction_set ) noexcept
+{
+  switch ( instruction_set )
+  {
+  case isa::sse2:
+    return simd_details::diff_sum_traits<T, isa::sse2, NORM>::method;
+
+  case isa::avx2:
+    return simd_details::diff_sum_traits<T, isa::avx2, NORM>::method;
+
+  case isa::avx512:
+  case isa::avx512_vnni:
+    return simd_details::diff_sum_traits<T, isa::avx512, NORM>::method;
+
+  case isa::scalar:
+  default:
+    return simd_details::diff_sum_traits<T, isa::scalar, NORM>::method;
+  }
+}
+
+template<diff_norm NORM, typename T>
+T diff_sum ( T const* a, T const* b, size_t n ) noexcept
+{
+  if constexpr ( has_diff_sum_kernels<T>() )
+  {
+    static diff_sum_kernel_t<T> const kernel = get_diff_sum_kernel<T, NORM> ( get_isa() );
+    return kernel ( a, b, n );
+  }
+  else
+  {
+    return simd_details::diff_sum_traits<T, isa::scalar, NORM>::method ( a, b, n );
+  }
+}
+
+inline dot_u8s8_kernel_t get_dot_u8s8_kernel ( isa const instruction_set ) noexcept
+{
+  switch ( instruction_set )
+  {
+  case isa::sse2:
+    return simd_details::dot_u8s8_traits<isa::sse2>::method;
+
+  case isa::avx2:
+    return simd_details::dot_u8s8_traits<isa::avx2>::method;
+
+  case isa::avx512:
+    return simd_details::dot_u8s8_traits<isa::avx512>::method;
+
+  case isa::avx512_vnni:
+    return simd_details::dot_u8s8_traits<isa::avx512_vnni>::method;
+
+  case isa::scalar:
+  default:
+    return simd_details::dot_u8s8_traits<isa::scalar>::method;
+  }
+}
+
+inline int32_t dot_u8s8 ( uint8_t const* a, int8_t const* b, size_t n ) noexcept
+{
+  static dot_u8s8_kernel_t const kernel = get_dot_u8s8_kernel ( get_isa() );
+  return kernel ( a, b, n );
+}
+
+template<typename HALF_T>
+dot_half_kernel_t<HALF_T> get_dot_half_kernel ( isa const instruction_set ) noexcept
+{
+#if defined ( NNET_SIMD_X86 )
+  switch ( instruction_set )
+  {
+  case isa::avx512:
+  case isa::avx512_vnni:
+    return simd_details::dot_half_traits<HALF_T, isa::avx512>::method;
+
+  case isa::avx2:
+    if ( std::is_same<HALF_T, bf16_t>::value || simd_details::supports_f16c() )
+    {
+      return simd_details::dot_half_traits<HALF_T, isa::avx2>::method;
+    }
+
+    return simd_details::dot_half_traits<HALF_T, isa::scalar>::method;
+
+  case isa::sse2:
+  case isa::scalar:
+  default:
+    return simd_details::dot_half_traits<HALF_T, isa::scalar>::method;
+  }
+#else
+  ( void ) instruction_set;
+  return simd_details::dot_half_traits<HALF_T, isa::scalar>::method;
+#endif
+}
+
+template<typename HALF_T>
+float dot_half ( float const* a, HALF_T const* b, size_t n ) noexcept
+{
+  static dot_half_kernel_t<HALF_T> const kernel = get_dot_half_kernel<HALF_T> ( get_isa() );
+  return kernel ( a, b, n );
+}
+
+}  // namespace simd
+
+} // namespace nnet
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <nnet/neuron_line.h>
+#include <nnet/activation.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <array>
+#include <vector>
+#include <cmath>
+#include <type_traits>
+
+namespace nnet
+{
+
+// pruned counterpart of neuron_line_t, the koefs above the magnitude threshold
+// are kept in CSR form: neuron k owns koefs[row_offsets[k], row_offsets[k + 1])
+template<typename INPUT_T,
+         size_t INPUT_DIMENSION,
+         size_t LINE_DIMENSION,
+         typename ACTIVATION = activation::identity_t>
+struct sparse_neuron_line_t
+{
+  static constexpr size_t const input_dimension = INPUT_DIMENSION;
+  static constexpr size_t const line_dimension = LINE_DIMENSION;
+
+  using activation_t = ACTIVATION;
+  using input_t = INPUT_T;
+  using output_t = input_t;
+  using koef_t = input_t;
+  using index_t = std::conditional_t < ( INPUT_DIMENSION <= UINT16_MAX + 1 ), uint16_t, uint32_t >;
+  using input_array_t = std::array<input_t, INPUT_DIMENSION>;
+  using output_array_t = std::array<output_t, LINE_DIMENSION>;
+
+  sparse_neuron_line_t() = default;
+
+  // the koefs with | koef | <= threshold are dropped
+  template<line_layout LAYOUT>
+  explicit sparse_neuron_line_t ( neuron_line_t<INPUT_T, INPUT_DIMENSION, LINE_DIMENSION, LAYOUT, ACTIVATION> const& line,
+                                  koef_t const threshold = koef_t{} )
+  {
+    using layout_traits = typename neuron_line_t<INPUT_T, INPUT_DIMENSION, LINE_DIMENSION, LAYOUT, ACTIVATION>::layout_traits;
+
+    auto const* const dense = line.koefs_data();
+
+    for ( size_t k = 0; k < LINE_DIMENSION; ++k )
+    {
+      for ( size_t i = 0; i < INPUT_DIMENSION; ++i )
+      {
+        auto const koef = dense[layout_traits::koef_index ( k, i )];
+
+        if ( std::abs ( koef ) > threshold )
+        {
+          koefs.push_back ( koef );
+          columns.push_back ( static_cast<index_t> ( i ) );
+        }
+      }
+
+      row_offsets[k + 1] = static_cast<uint32_t> ( koefs.size() );
+    }
+  }
+
+  size_t size() const noexcept
+  {
+    return LINE_DIMENSION;
+  }
+
+  size_t get_nonzero_count() const noexcept
+  {
+    return koefs.size();
+  }
+
+  void apply ( input_array_t const& input ) noexcept
+  {
+    apply ( input.data(), values.data() );
+  }
+
+  // writes LINE_DIMENSION outputs straight to the caller buffer, the neuron values are left intact
+  void apply ( input_t const* input, output_t* output ) const noexcept
+  {
+    auto const* const koef = koefs.data();
+    auto const* const column = columns.data();
+
+    for ( size_t k = 0; k < LINE_DIMENSION; ++k )
+    {
+      auto p = row_offsets[k];
+      auto const end = row_offsets[k + 1];
+
+      // two accumulators break the dependency chain of the gathered multiply-adds
+      output_t acc0{};
+      output_t acc1{};
+
+      for ( ; p + 1 < end; p += 2 )
+      {
+        acc0 += koef[p] * input[column[p]];
+        acc1 += koef[p + 1] * input[column[p + 1]];
+      }
+
+      if ( p < end )
+      {
+        acc0 += koef[p] * input[column[p]];
+      }
+
+      output[k] = activation_t::apply ( acc0 + acc1 );
+    }
+  }
+
+  // outputs is a row-major count x LINE_DIMENSION buffer, the neuron values are left intact
+  void apply_batch ( input_array_t const* inputs, size_t count, output_t* outputs ) const noexcept
+  {
+    for ( size_t s = 0; s < count; ++s )
+    {
+      apply ( inputs[s].data(), outputs + s * LINE_DIMENSION );
+    }
+  }
+
+  output_array_t const& get_value() const noexcept
+  {
+    return values;
+  }
+
+private:
+  std::vector<koef_t> koefs;
+  std::vector<index_t> columns;
+  std::array<uint32_t, LINE_DIMENSION + 1> row_offsets{};
+  alignas ( 64 ) output_array_t values{};
+};
+
+} // namespace nnet
@@ -2,6 +2,9 @@
 
 #include <type_traits>
 #include <functional>
+#include <algorithm>
+#include <limits>
+#include <cmath>
 
 namespace noptim
 {
@@ -9,13 +12,15 @@ namespace noptim
 enum class find_minimum_method
 {
   dichotomie,
-  gold_ratio
+  gold_ratio,
+  brent
 };
 
 
 struct find_minimum_t
 {
   size_t funct_invocation_count{};
+  size_t iteration_count{};  // the outer steps of the iterative solvers
 };
 
 namespace find_minimum_details
@@ -38,6 +43,7 @@ constexpr double const tau = 0.618;
 constexpr double const tau_compliment = 1.0 - tau;
 
 
+// the type-erased adapter, the solvers take any callable and inline it
 template <typename T>
 using target_function_t = std::function<T ( T ) >;
 
@@ -48,8 +54,9 @@ struct find_minimum_traits;
 template<typename T>
 struct find_minimum_traits<T, find_minimum_method::dichotomie>
 {
+  template<typename FUNCT>
   static T method ( T const xa, T const xb,
-                    T const eps, target_function_t<T> funct,
+                    T const eps, FUNCT& funct,
                     find_minimum_t* statistics )
   {
 
@@ -122,8 +129,9 @@ struct find_minimum_traits<T, find_minimum_method::gold_ratio>
 {
   // taken from:
   // https://math.semestr.ru/optim/golden.php
+  template<typename FUNCT>
   static T method ( T const xa, T const xb,
-                    T const eps, target_function_t<T> funct,
+                    T const eps, FUNCT& funct,
                     find_minimum_t* statistics )
   {
 
@@ -143,7 +151,8 @@ struct find_minimum_traits<T, find_minimum_method::gold_ratio>
 
     while ( x1 - x0 > eps )
     {
-      if ( f0i <= f1i )
+      // a NaN counts as the higher value, with no order between the two the loop would never end
+      if ( f0i <= f1i || std::isnan ( f1i ) )
       {
         // x0 = x0;
         x1 = x1i;
@@ -159,7 +168,7 @@ struct find_minimum_traits<T, find_minimum_method::gold_ratio>
           statistics->funct_invocation_count++;
         }
       }
-      else if ( f0i > f1i )
+      else
       {
         x0 = x0i;
         // x1 = x1;
@@ -182,14 +191,167 @@ struct find_minimum_traits<T, find_minimum_method::gold_ratio>
 
 };
 
+template<typename T>
+struct find_minimum_traits<T, find_minimum_method::brent>
+{
+  // golden section steps mixed with successive parabolic interpolation, taken from:
+  // R. P. Brent, Algorithms for Minimization without Derivatives, 1973, chapter 5
+  template<typename FUNCT>
+  static T method ( T const xa, T const xb,
+                    T const eps, FUNCT& funct,
+                    find_minimum_t* statistics )
+  {
+    static_assert ( std::is_floating_point<T>::value, "The parabolic steps need a floating point T" );
+
+    // ( 3 - sqrt ( 5 ) ) / 2, the golden section step as a fraction of the larger part
+    constexpr T const golden = T ( 0.3819660112501051 );
+    T const sqrt_epsilon = std::sqrt ( std::numeric_limits<T>::epsilon() );
+
+    auto x0 = std::min ( xa, xb );
+    auto x1 = std::max ( xa, xb );
+
+    // x is the best point so far, w the second best and v the previous w
+    auto x = x0 + golden * ( x1 - x0 );
+    auto w = x;
+    auto v = x;
+
+    auto fx = funct ( x );
+    auto fw = fx;
+    auto fv = fx;
+
+    if ( statistics )
+    {
+      statistics->funct_invocation_count++;
+    }
+
+    T d{};
+    T e{};
+
+    for ( ;; )
+    {
+      auto const xm = ( x0 + x1 ) / find_minimum_details::middle_div<T>();
+
+      // the bracket is at most 4 * tol1 wide on exit, so x is within eps of the minimum as long
+      // as eps is above sqrt_epsilon * |x|, the best a smooth minimum can be located in x
+      auto const tol1 = sqrt_epsilon * std::fabs ( x ) + eps / T{4};
+      auto const tol2 = T{2} * tol1;
+
+      if ( std::fabs ( x - xm ) <= tol2 - ( x1 - x0 ) / find_minimum_details::middle_div<T>() )
+      {
+        break;
+      }
+
+      bool golden_step = true;
+
+      if ( std::fabs ( e ) > tol1 )
+      {
+        // the vertex of the parabola through x, w and v as x + p / q
+        auto const r = ( x - w ) * ( fx - fv );
+        auto q = ( x - v ) * ( fx - fw );
+        auto p = ( x - v ) * q - ( x - w ) * r;
+        q = T{2} * ( q - r );
+
+        if ( q > T{} )
+        {
+          p = -p;
+        }
+        else
+        {
+          q = -q;
+        }
+
+        auto const e_before_last = e;
+        e = d;
+
+        // only a step inside the bracket and shorter than half the step before last
+        if ( std::fabs ( p ) < std::fabs ( q * e_before_last / find_minimum_details::middle_div<T>() )
+             && p > q * ( x0 - x ) && p < q * ( x1 - x ) )
+        {
+          d = p / q;
+
+          auto const u = x + d;
+
+          if ( u - x0 < tol2 || x1 - u < tol2 )
+          {
+            d = std::copysign ( tol1, xm - x );
+          }
+
+          golden_step = false;
+        }
+      }
+
+      if ( golden_step )
+      {
+        e = ( x >= xm ) ? x0 - x : x1 - x;
+        d = golden * e;
+      }
+
+      // never closer than tol1 to x, such a step cannot tell the values apart
+      auto const u = ( std::fabs ( d ) >= tol1 ) ? x + d : x + std::copysign ( tol1, d );
+      auto const fu = funct ( u );
+
+      if ( statistics )
+      {
+        statistics->funct_invocation_count++;
+      }
+
+      if ( fu <= fx )
+      {
+        if ( u >= x )
+        {
+          x0 = x;
+        }
+        else
+        {
+          x1 = x;
+        }
+
+        v = w;
+        fv = fw;
+        w = x;
+        fw = fx;
+        x = u;
+        fx = fu;
+      }
+      else
+      {
+        if ( u < x )
+        {
+          x0 = u;
+        }
+        else
+        {
+          x1 = u;
+        }
+
+        if ( fu <= fw || w == x )
+        {
+          v = w;
+          fv = fw;
+          w = u;
+          fw = fu;
+        }
+        else if ( fu <= fv || v == x || v == w )
+        {
+          v = u;
+          fv = fu;
+        }
+      }
+    }
+
+    return x;
+  }
+};
+
 }  // namespace find_minimum_details
 
+// funct is called in place, a std::function is used only when the caller passes one
 template <find_minimum_method METHOD_ENUM,
           typename T,
           typename LOSS_FUNCTION_T = find_minimum_details::target_function_t<T>>
 T find_minimum ( T const xa, T const xb,
                  T const eps,
-                 LOSS_FUNCTION_T& funct,
+                 LOSS_FUNCTION_T&& funct,
                  find_minimum_t* statistics = nullptr )
 {
   return find_minimum_details::find_minimum_traits<T, METHOD_ENUM>::method ( xa, xb, eps, funct, statistics );
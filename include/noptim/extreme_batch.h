@@ -0,0 +1,666 @@
+#pragma once
+
+#include <noptim/extreme.h>
+#include <nnet/simd.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+
+namespace noptim
+{
+
+namespace find_minimum_batch_details
+{
+
+// the problems one at a time through find_minimum, for the cpus and the types without
+// a lockstep kernel; funct sees a single lane
+template<typename T, nnet::simd::isa ISA>
+struct find_minimum_batch_traits
+{
+  template<find_minimum_method METHOD_ENUM, typename FUNCT>
+  static void method ( T const* xa, T const* xb, T const eps, size_t const count,
+                       FUNCT& funct, T* x_min, find_minimum_t* statistics )
+  {
+    for ( size_t p = 0; p < count; ++p )
+    {
+      auto lane_funct = [&funct, p] ( T x )
+      {
+        T f{};
+        funct ( &x, &f, p, size_t{1} );
+        return f;
+      };
+
+      x_min[p] = find_minimum<METHOD_ENUM> ( xa[p], xb[p], eps, lane_funct, statistics ? statistics + p : nullptr );
+    }
+  }
+};
+
+#if defined ( NNET_SIMD_X86 )
+
+// A block of problems per register runs the steps of find_minimum_traits in lockstep:
+// every step compares to masks and blends the new state into the lanes it belongs to, a
+// lane stays active while its bracket is wider than eps and the block ends when none is.
+// The lanes past the count get the empty bracket [0, 0], funct does not see them.
+// The kernels do not fuse the multiplies and the adds, so the double lanes repeat the
+// scalar steps bit for bit.
+
+//-----------------------------------------------------------------------------
+// avx2
+
+template<>
+struct find_minimum_batch_traits<double, nnet::simd::isa::avx2>
+{
+  static constexpr size_t const lanes = 4;
+
+  template<typename FUNCT>
+  __attribute__ ( ( target ( "avx2" ), optimize ( "fp-contract=off" ) ) )
+  static __m256d evaluate ( FUNCT& funct, __m256d const x, size_t const first, size_t const used ) noexcept
+  {
+    alignas ( 32 ) double x_lanes[lanes];
+    alignas ( 32 ) double f_lanes[lanes] = {};
+
+    _mm256_store_pd ( x_lanes, x );
+    funct ( x_lanes, f_lanes, first, used );
+
+    return _mm256_load_pd ( f_lanes );
+  }
+
+  template<find_minimum_method METHOD_ENUM, typename FUNCT>
+  __attribute__ ( ( target ( "avx2" ), optimize ( "fp-contract=off" ) ) )
+  static void method ( double const* xa, double const* xb, double const eps, size_t const count,
+                       FUNCT& funct, double* x_min, find_minimum_t* statistics )
+  {
+    __m256d const eps_v = _mm256_set1_pd ( eps );
+    __m256d const half = _mm256_set1_pd ( 0.5 );
+    __m256d const tau = _mm256_set1_pd ( find_minimum_details::tau );
+    __m256d const tau_compliment = _mm256_set1_pd ( find_minimum_details::tau_compliment );
+
+    for ( size_t first = 0; first < count; first += lanes )
+    {
+      auto const used = std::min ( lanes, count - first );
+      __m256i const used_mask = _mm256_cmpgt_epi64 ( _mm256_set1_epi64x ( static_cast<int64_t> ( used ) ),
+                                                     _mm256_setr_epi64x ( 0, 1, 2, 3 ) );
+
+      __m256d x0 = _mm256_maskload_pd ( xa + first, used_mask );
+      __m256d x1 = _mm256_maskload_pd ( xb + first, used_mask );
+
+      // a compare mask is -1 in every active lane, subtracting it counts the calls
+      __m256i calls;
+
+      if constexpr ( METHOD_ENUM == find_minimum_method::dichotomie )
+      {
+        __m256d x0i = _mm256_mul_pd ( _mm256_add_pd ( x1, x0 ), half );
+        __m256d f0i = evaluate ( funct, x0i, first, used );
+        calls = _mm256_sub_epi64 ( _mm256_setzero_si256(), used_mask );
+
+        for ( ;; )
+        {
+          __m256d const active = _mm256_cmp_pd ( _mm256_sub_pd ( x1, x0 ), eps_v, _CMP_GT_OQ );
+
+          if ( !_mm256_movemask_pd ( active ) )
+          {
+            break;
+          }
+
+          calls = _mm256_sub_epi64 ( calls, _mm256_castpd_si256 ( active ) );
+
+          __m256d const x1i = _mm256_mul_pd ( _mm256_add_pd ( x1, x0i ), half );
+          __m256d const f1i = evaluate ( funct, x1i, first, used );
+
+          __m256d const right = _mm256_and_pd ( active, _mm256_cmp_pd ( f0i, f1i, _CMP_GE_OQ ) );
+          __m256d const second = _mm256_andnot_pd ( right, active );
+
+          x0 = _mm256_blendv_pd ( x0, x0i, right );
+          x0i = _mm256_blendv_pd ( x0i, x1i, right );
+          f0i = _mm256_blendv_pd ( f0i, f1i, right );
+
+          if ( !_mm256_movemask_pd ( second ) )
+          {
+            continue;
+          }
+
+          calls = _mm256_sub_epi64 ( calls, _mm256_castpd_si256 ( second ) );
+
+          __m256d const x2i = _mm256_mul_pd ( _mm256_add_pd ( x0, x0i ), half );
+          __m256d const f2i = evaluate ( funct, x2i, first, used );
+
+          __m256d const take = _mm256_and_pd ( second, _mm256_cmp_pd ( f2i, f0i, _CMP_LE_OQ ) );
+
+          x1 = _mm256_blendv_pd ( x1, x1i, second );
+          x0i = _mm256_blendv_pd ( x0i, x2i, take );
+          f0i = _mm256_blendv_pd ( f0i, f2i, take );
+          x0 = _mm256_blendv_pd ( x0, x2i, _mm256_andnot_pd ( take, second ) );
+        }
+      }
+      else
+      {
+        __m256d x0i = _mm256_add_pd ( x0, _mm256_mul_pd ( tau_compliment, _mm256_sub_pd ( x1, x0 ) ) );
+        __m256d x1i = _mm256_add_pd ( x0, _mm256_mul_pd ( tau, _mm256_sub_pd ( x1, x0 ) ) );
+        __m256d f0i = evaluate ( funct, x0i, first, used );
+        __m256d f1i = evaluate ( funct, x1i, first, used );
+        calls = _mm256_sub_epi64 ( _mm256_setzero_si256(), _mm256_add_epi64 ( used_mask, used_mask ) );
+
+        for ( ;; )
+        {
+          __m256d const active = _mm256_cmp_pd ( _mm256_sub_pd ( x1, x0 ), eps_v, _CMP_GT_OQ );
+
+          if ( !_mm256_movemask_pd ( active ) )
+          {
+            break;
+          }
+
+          calls = _mm256_sub_epi64 ( calls, _mm256_castpd_si256 ( active ) );
+
+          // the left part [x0, x1i] is kept when f0i <= f1i or f1i is NaN, the right one [x0i, x1] otherwise
+          __m256d const left = _mm256_and_pd ( active, _mm256_or_pd ( _mm256_cmp_pd ( f0i, f1i, _CMP_LE_OQ ),
+                                                                      _mm256_cmp_pd ( f1i, f1i, _CMP_UNORD_Q ) ) );
+          __m256d const right = _mm256_andnot_pd ( left, active );
+
+          x1 = _mm256_blendv_pd ( x1, x1i, left );
+          x0 = _mm256_blendv_pd ( x0, x0i, right );
+
+          __m256d const xe = _mm256_add_pd ( x0, _mm256_mul_pd ( _mm256_blendv_pd ( tau, tau_compliment, left ),
+                                                                   _mm256_sub_pd ( x1, x0 ) ) );
+          __m256d const fe = evaluate ( funct, xe, first, used );
+
+          __m256d const next_x0i = _mm256_blendv_pd ( _mm256_blendv_pd ( x0i, x1i, right ), xe, left );
+          __m256d const next_x1i = _mm256_blendv_pd ( _mm256_blendv_pd ( x1i, x0i, left ), xe, right );
+          __m256d const next_f0i = _mm256_blendv_pd ( _mm256_blendv_pd ( f0i, f1i, right ), fe, left );
+          __m256d const next_f1i = _mm256_blendv_pd ( _mm256_blendv_pd ( f1i, f0i, left ), fe, right );
+
+          x0i = next_x0i;
+          x1i = next_x1i;
+          f0i = next_f0i;
+          f1i = next_f1i;
+        }
+      }
+
+      _mm256_maskstore_pd ( x_min + first, used_mask, _mm256_mul_pd ( _mm256_add_pd ( x0, x1 ), half ) );
+
+      if ( statistics )
+      {
+        alignas ( 32 ) int64_t call_lanes[lanes];
+        _mm256_store_si256 ( reinterpret_cast<__m256i*> ( call_lanes ), calls );
+
+        for ( size_t l = 0; l < used; ++l )
+        {
+          statistics[first + l].funct_invocation_count += static_cast<size_t> ( call_lanes[l] );
+        }
+      }
+    }
+  }
+};
+
+template<>
+struct find_minimum_batch_traits<float, nnet::simd::isa::avx2>
+{
+  static constexpr size_t const lanes = 8;
+
+  template<typename FUNCT>
+  __attribute__ ( ( target ( "avx2" ), optimize ( "fp-contract=off" ) ) )
+  static __m256 evaluate ( FUNCT& funct, __m256 const x, size_t const first, size_t const used ) noexcept
+  {
+    alignas ( 32 ) float x_lanes[lanes];
+    alignas ( 32 ) float f_lanes[lanes] = {};
+
+    _mm256_store_ps ( x_lanes, x );
+    funct ( x_lanes, f_lanes, first, used );
+
+    return _mm256_load_ps ( f_lanes );
+  }
+
+  template<find_minimum_method METHOD_ENUM, typename FUNCT>
+  __attribute__ ( ( target ( "avx2" ), optimize ( "fp-contract=off" ) ) )
+  static void method ( float const* xa, float const* xb, float const eps, size_t const count,
+                       FUNCT& funct, float* x_min, find_minimum_t* statistics )
+  {
+    __m256 const eps_v = _mm256_set1_ps ( eps );
+    __m256 const half = _mm256_set1_ps ( 0.5f );
+    __m256 const tau = _mm256_set1_ps ( static_cast<float> ( find_minimum_details::tau ) );
+    __m256 const tau_compliment = _mm256_set1_ps ( static_cast<float> ( find_minimum_details::tau_compliment ) );
+
+    for ( size_t first = 0; first < count; first += lanes )
+    {
+      auto const used = std::min ( lanes, count - first );
+      __m256i const used_mask = _mm256_cmpgt_epi32 ( _mm256_set1_epi32 ( static_cast<int32_t> ( used ) ),
+                                                     _mm256_setr_epi32 ( 0, 1, 2, 3, 4, 5, 6, 7 ) );
+
+      __m256 x0 = _mm256_maskload_ps ( xa + first, used_mask );
+      __m256 x1 = _mm256_maskload_ps ( xb + first, used_mask );
+
+      __m256i calls;
+
+      if constexpr ( METHOD_ENUM == find_minimum_method::dichotomie )
+      {
+        __m256 x0i = _mm256_mul_ps ( _mm256_add_ps ( x1, x0 ), half );
+        __m256 f0i = evaluate ( funct, x0i, first, used );
+        calls = _mm256_sub_epi32 ( _mm256_setzero_si256(), used_mask );
+
+        for ( ;; )
+        {
+          __m256 const active = _mm256_cmp_ps ( _mm256_sub_ps ( x1, x0 ), eps_v, _CMP_GT_OQ );
+
+          if ( !_mm256_movemask_ps ( active ) )
+          {
+            break;
+          }
+
+          calls = _mm256_sub_epi32 ( calls, _mm256_castps_si256 ( active ) );
+
+          __m256 const x1i = _mm256_mul_ps ( _mm256_add_ps ( x1, x0i ), half );
+          __m256 const f1i = evaluate ( funct, x1i, first, used );
+
+          __m256 const right = _mm256_and_ps ( active, _mm256_cmp_ps ( f0i, f1i, _CMP_GE_OQ ) );
+          __m256 const second = _mm256_andnot_ps ( right, active );
+
+          x0 = _mm256_blendv_ps ( x0, x0i, right );
+          x0i = _mm256_blendv_ps ( x0i, x1i, right );
+          f0i = _mm256_blendv_ps ( f0i, f1i, right );
+
+          if ( !_mm256_movemask_ps ( second ) )
+          {
+            continue;
+          }
+
+          calls = _mm256_sub_epi32 ( calls, _mm256_castps_si256 ( second ) );
+
+          __m256 const x2i = _mm256_mul_ps ( _mm256_add_ps ( x0, x0i ), half );
+          __m256 const f2i = evaluate ( funct, x2i, first, used );
+
+          __m256 const take = _mm256_and_ps ( second, _mm256_cmp_ps ( f2i, f0i, _CMP_LE_OQ ) );
+
+          x1 = _mm256_blendv_ps ( x1, x1i, second );
+          x0i = _mm256_blendv_ps ( x0i, x2i, take );
+          f0i = _mm256_blendv_ps ( f0i, f2i, take );
+          x0 = _mm256_blendv_ps ( x0, x2i, _mm256_andnot_ps ( take, second ) );
+        }
+      }
+      else
+      {
+        __m256 x0i = _mm256_add_ps ( x0, _mm256_mul_ps ( tau_compliment, _mm256_sub_ps ( x1, x0 ) ) );
+        __m256 x1i = _mm256_add_ps ( x0, _mm256_mul_ps ( tau, _mm256_sub_ps ( x1, x0 ) ) );
+        __m256 f0i = evaluate ( funct, x0i, first, used );
+        __m256 f1i = evaluate ( funct, x1i, first, used );
+        calls = _mm256_sub_epi32 ( _mm256_setzero_si256(), _mm256_add_epi32 ( used_mask, used_mask ) );
+
+        for ( ;; )
+        {
+          __m256 const active = _mm256_cmp_ps ( _mm256_sub_ps ( x1, x0 ), eps_v, _CMP_GT_OQ );
+
+          if ( !_mm256_movemask_ps ( active ) )
+          {
+            break;
+          }
+
+          calls = _mm256_sub_epi32 ( calls, _mm256_castps_si256 ( active ) );
+
+          __m256 const left = _mm256_and_ps ( active, _mm256_or_ps ( _mm256_cmp_ps ( f0i, f1i, _CMP_LE_OQ ),
+                                                                     _mm256_cmp_ps ( f1i, f1i, _CMP_UNORD_Q ) ) );
+          __m256 const right = _mm256_andnot_ps ( left, active );
+
+          x1 = _mm256_blendv_ps ( x1, x1i, left );
+          x0 = _mm256_blendv_ps ( x0, x0i, right );
+
+          __m256 const xe = _mm256_add_ps ( x0, _mm256_mul_ps ( _mm256_blendv_ps ( tau, tau_compliment, left ),
+                                                                _mm256_sub_ps ( x1, x0 ) ) );
+          __m256 const fe = evaluate ( funct, xe, first, used );
+
+          __m256 const next_x0i = _mm256_blendv_ps ( _mm256_blendv_ps ( x0i, x1i, right ), xe, left );
+          __m256 const next_x1i = _mm256_blendv_ps ( _mm256_blendv_ps ( x1i, x0i, left ), xe, right );
+          __m256 const next_f0i = _mm256_blendv_ps ( _mm256_blendv_ps ( f0i, f1i, right ), fe, left );
+          __m256 const next_f1i = _mm256_blendv_ps ( _mm256_blendv_ps ( f1i, f0i, left ), fe, right );
+
+          x0i = next_x0i;
+          x1i = next_x1i;
+          f0i = next_f0i;
+          f1i = next_f1i;
+        }
+      }
+
+      _mm256_maskstore_ps ( x_min + first, used_mask, _mm256_mul_ps ( _mm256_add_ps ( x0, x1 ), half ) );
+
+      if ( statistics )
+      {
+        alignas ( 32 ) int32_t call_lanes[lanes];
+        _mm256_store_si256 ( reinterpret_cast<__m256i*> ( call_lanes ), calls );
+
+        for ( size_t l = 0; l < used; ++l )
+        {
+          statistics[first + l].funct_invocation_count += static_cast<size_t> ( call_lanes[l] );
+        }
+      }
+    }
+  }
+};
+
+//-----------------------------------------------------------------------------
+// avx512, the compares give mask registers and the blends are masked moves
+
+template<>
+struct find_minimum_batch_traits<double, nnet::simd::isa::avx512>
+{
+  static constexpr size_t const lanes = 8;
+
+  template<typename FUNCT>
+  __attribute__ ( ( target ( "avx512f" ), optimize ( "fp-contract=off" ) ) )
+  static __m512d evaluate ( FUNCT& funct, __m512d const x, size_t const first, size_t const used ) noexcept
+  {
+    alignas ( 64 ) double x_lanes[lanes];
+    alignas ( 64 ) double f_lanes[lanes] = {};
+
+    _mm512_store_pd ( x_lanes, x );
+    funct ( x_lanes, f_lanes, first, used );
+
+    return _mm512_load_pd ( f_lanes );
+  }
+
+  template<find_minimum_method METHOD_ENUM, typename FUNCT>
+  __attribute__ ( ( target ( "avx512f" ), optimize ( "fp-contract=off" ) ) )
+  static void method ( double const* xa, double const* xb, double const eps, size_t const count,
+                       FUNCT& funct, double* x_min, find_minimum_t* statistics )
+  {
+    __m512d const eps_v = _mm512_set1_pd ( eps );
+    __m512d const half = _mm512_set1_pd ( 0.5 );
+    __m512d const tau = _mm512_set1_pd ( find_minimum_details::tau );
+    __m512d const tau_compliment = _mm512_set1_pd ( find_minimum_details::tau_compliment );
+    __m512i const one = _mm512_set1_epi64 ( 1 );
+
+    for ( size_t first = 0; first < count; first += lanes )
+    {
+      auto const used = std::min ( lanes, count - first );
+      __mmask8 const used_mask = __mmask8 ( ( 1u << used ) - 1 );
+
+      __m512d x0 = _mm512_maskz_loadu_pd ( used_mask, xa + first );
+      __m512d x1 = _mm512_maskz_loadu_pd ( used_mask, xb + first );
+
+      __m512i calls;
+
+      if constexpr ( METHOD_ENUM == find_minimum_method::dichotomie )
+      {
+        __m512d x0i = _mm512_mul_pd ( _mm512_add_pd ( x1, x0 ), half );
+        __m512d f0i = evaluate ( funct, x0i, first, used );
+        calls = _mm512_maskz_mov_epi64 ( used_mask, one );
+
+        for ( ;; )
+        {
+          __mmask8 const active = _mm512_cmp_pd_mask ( _mm512_sub_pd ( x1, x0 ), eps_v, _CMP_GT_OQ );
+
+          if ( !active )
+          {
+            break;
+          }
+
+          calls = _mm512_mask_add_epi64 ( calls, active, calls, one );
+
+          __m512d const x1i = _mm512_mul_pd ( _mm512_add_pd ( x1, x0i ), half );
+          __m512d const f1i = evaluate ( funct, x1i, first, used );
+
+          __mmask8 const right = active & _mm512_cmp_pd_mask ( f0i, f1i, _CMP_GE_OQ );
+          __mmask8 const second = active & ~right;
+
+          x0 = _mm512_mask_mov_pd ( x0, right, x0i );
+          x0i = _mm512_mask_mov_pd ( x0i, right, x1i );
+          f0i = _mm512_mask_mov_pd ( f0i, right, f1i );
+
+          if ( !second )
+          {
+            continue;
+          }
+
+          calls = _mm512_mask_add_epi64 ( calls, second, calls, one );
+
+          __m512d const x2i = _mm512_mul_pd ( _mm512_add_pd ( x0, x0i ), half );
+          __m512d const f2i = evaluate ( funct, x2i, first, used );
+
+          __mmask8 const take = second & _mm512_cmp_pd_mask ( f2i, f0i, _CMP_LE_OQ );
+
+          x1 = _mm512_mask_mov_pd ( x1, second, x1i );
+          x0i = _mm512_mask_mov_pd ( x0i, take, x2i );
+          f0i = _mm512_mask_mov_pd ( f0i, take, f2i );
+          x0 = _mm512_mask_mov_pd ( x0, second & ~take, x2i );
+        }
+      }
+      else
+      {
+        __m512d x0i = _mm512_add_pd ( x0, _mm512_mul_pd ( tau_compliment, _mm512_sub_pd ( x1, x0 ) ) );
+        __m512d x1i = _mm512_add_pd ( x0, _mm512_mul_pd ( tau, _mm512_sub_pd ( x1, x0 ) ) );
+        __m512d f0i = evaluate ( funct, x0i, first, used );
+        __m512d f1i = evaluate ( funct, x1i, first, used );
+        calls = _mm512_maskz_mov_epi64 ( used_mask, _mm512_add_epi64 ( one, one ) );
+
+        for ( ;; )
+        {
+          __mmask8 const active = _mm512_cmp_pd_mask ( _mm512_sub_pd ( x1, x0 ), eps_v, _CMP_GT_OQ );
+
+          if ( !active )
+          {
+            break;
+          }
+
+          calls = _mm512_mask_add_epi64 ( calls, active, calls, one );
+
+          __mmask8 const left = active & ( _mm512_cmp_pd_mask ( f0i, f1i, _CMP_LE_OQ )
+                                           | _mm512_cmp_pd_mask ( f1i, f1i, _CMP_UNORD_Q ) );
+          __mmask8 const right = active & ~left;
+
+          x1 = _mm512_mask_mov_pd ( x1, left, x1i );
+          x0 = _mm512_mask_mov_pd ( x0, right, x0i );
+
+          __m512d const xe = _mm512_add_pd ( x0, _mm512_mul_pd ( _mm512_mask_blend_pd ( left, tau, tau_compliment ),
+                                                                  _mm512_sub_pd ( x1, x0 ) ) );
+          __m512d const fe = evaluate ( funct, xe, first, used );
+
+          __m512d const next_x0i = _mm512_mask_mov_pd ( _mm512_mask_mov_pd ( x0i, right, x1i ), left, xe );
+          __m512d const next_x1i = _mm512_mask_mov_pd ( _mm512_mask_mov_pd ( x1i, left, x0i ), right, xe );
+          __m512d const next_f0i = _mm512_mask_mov_pd ( _mm512_mask_mov_pd ( f0i, right, f1i ), left, fe );
+          __m512d const next_f1i = _mm512_mask_mov_pd ( _mm512_mask_mov_pd ( f1i, left, f0i ), right, fe );
+
+          x0i = next_x0i;
+          x1i = next_x1i;
+          f0i = next_f0i;
+          f1i = next_f1i;
+        }
+      }
+
+      _mm512_mask_storeu_pd ( x_min + first, used_mask, _mm512_mul_pd ( _mm512_add_pd ( x0, x1 ), half ) );
+
+      if ( statistics )
+      {
+        alignas ( 64 ) int64_t call_lanes[lanes];
+        _mm512_store_si512 ( call_lanes, calls );
+
+        for ( size_t l = 0; l < used; ++l )
+        {
+          statistics[first + l].funct_invocation_count += static_cast<size_t> ( call_lanes[l] );
+        }
+      }
+    }
+  }
+};
+
+template<>
+struct find_minimum_batch_traits<float, nnet::simd::isa::avx512>
+{
+  static constexpr size_t const lanes = 16;
+
+  template<typename FUNCT>
+  __attribute__ ( ( target ( "avx512f" ), optimize ( "fp-contract=off" ) ) )
+  static __m512 evaluate ( FUNCT& funct, __m512 const x, size_t const first, size_t const used ) noexcept
+  {
+    alignas ( 64 ) float x_lanes[lanes];
+    alignas ( 64 ) float f_lanes[lanes] = {};
+
+    _mm512_store_ps ( x_lanes, x );
+    funct ( x_lanes, f_lanes, first, used );
+
+    return _mm512_load_ps ( f_lanes );
+  }
+
+  template<find_minimum_method METHOD_ENUM, typename FUNCT>
+  __attribute__ ( ( target ( "avx512f" ), optimize ( "fp-contract=off" ) ) )
+  static void method ( float const* xa, float const* xb, float const eps, size_t const count,
+                       FUNCT& funct, float* x_min, find_minimum_t* statistics )
+  {
+    __m512 const eps_v = _mm512_set1_ps ( eps );
+    __m512 const half = _mm512_set1_ps ( 0.5f );
+    __m512 const tau = _mm512_set1_ps ( static_cast<float> ( find_minimum_details::tau ) );
+    __m512 const tau_compliment = _mm512_set1_ps ( static_cast<float> ( find_minimum_details::tau_compliment ) );
+    __m512i const one = _mm512_set1_epi32 ( 1 );
+
+    for ( size_t first = 0; first < count; first += lanes )
+    {
+      auto const used = std::min ( lanes, count - first );
+      __mmask16 const used_mask = __mmask16 ( ( 1u << used ) - 1 );
+
+      __m512 x0 = _mm512_maskz_loadu_ps ( used_mask, xa + first );
+      __m512 x1 = _mm512_maskz_loadu_ps ( used_mask, xb + first );
+
+      __m512i calls;
+
+      if constexpr ( METHOD_ENUM == find_minimum_method::dichotomie )
+      {
+        __m512 x0i = _mm512_mul_ps ( _mm512_add_ps ( x1, x0 ), half );
+        __m512 f0i = evaluate ( funct, x0i, first, used );
+        calls = _mm512_maskz_mov_epi32 ( used_mask, one );
+
+        for ( ;; )
+        {
+          __mmask16 const active = _mm512_cmp_ps_mask ( _mm512_sub_ps ( x1, x0 ), eps_v, _CMP_GT_OQ );
+
+          if ( !active )
+          {
+            break;
+          }
+
+          calls = _mm512_mask_add_epi32 ( calls, active, calls, one );
+
+          __m512 const x1i = _mm512_mul_ps ( _mm512_add_ps ( x1, x0i ), half );
+          __m512 const f1i = evaluate ( funct, x1i, first, used );
+
+          __mmask16 const right = active & _mm512_cmp_ps_mask ( f0i, f1i, _CMP_GE_OQ );
+          __mmask16 const second = active & ~right;
+
+          x0 = _mm512_mask_mov_ps ( x0, right, x0i );
+          x0i = _mm512_mask_mov_ps ( x0i, right, x1i );
+          f0i = _mm512_mask_mov_ps ( f0i, right, f1i );
+
+          if ( !second )
+          {
+            continue;
+          }
+
+          calls = _mm512_mask_add_epi32 ( calls, second, calls, one );
+
+          __m512 const x2i = _mm512_mul_ps ( _mm512_add_ps ( x0, x0i ), half );
+          __m512 const f2i = evaluate ( funct, x2i, first, used );
+
+          __mmask16 const take = second & _mm512_cmp_ps_mask ( f2i, f0i, _CMP_LE_OQ );
+
+          x1 = _mm512_mask_mov_ps ( x1, second, x1i );
+          x0i = _mm512_mask_mov_ps ( x0i, take, x2i );
+          f0i = _mm512_mask_mov_ps ( f0i, take, f2i );
+          x0 = _mm512_mask_mov_ps ( x0, second & ~take, x2i );
+        }
+      }
+      else
+      {
+        __m512 x0i = _mm512_add_ps ( x0, _mm512_mul_ps ( tau_compliment, _mm512_sub_ps ( x1, x0 ) ) );
+        __m512 x1i = _mm512_add_ps ( x0, _mm512_mul_ps ( tau, _mm512_sub_ps ( x1, x0 ) ) );
+        __m512 f0i = evaluate ( funct, x0i, first, used );
+        __m512 f1i = evaluate ( funct, x1i, first, used );
+        calls = _mm512_maskz_mov_epi32 ( used_mask, _mm512_add_epi32 ( one, one ) );
+
+        for ( ;; )
+        {
+          __mmask16 const active = _mm512_cmp_ps_mask ( _mm512_sub_ps ( x1, x0 ), eps_v, _CMP_GT_OQ );
+
+          if ( !active )
+          {
+            break;
+          }
+
+          calls = _mm512_mask_add_epi32 ( calls, active, calls, one );
+
+          __mmask16 const left = active & ( _mm512_cmp_ps_mask ( f0i, f1i, _CMP_LE_OQ )
+                                            | _mm512_cmp_ps_mask ( f1i, f1i, _CMP_UNORD_Q ) );
+          __mmask16 const right = active & ~left;
+
+          x1 = _mm512_mask_mov_ps ( x1, left, x1i );
+          x0 = _mm512_mask_mov_ps ( x0, right, x0i );
+
+          __m512 const xe = _mm512_add_ps ( x0, _mm512_mul_ps ( _mm512_mask_blend_ps ( left, tau, tau_compliment ),
+                                                                _mm512_sub_ps ( x1, x0 ) ) );
+          __m512 const fe = evaluate ( funct, xe, first, used );
+
+          __m512 const next_x0i = _mm512_mask_mov_ps ( _mm512_mask_mov_ps ( x0i, right, x1i ), left, xe );
+          __m512 const next_x1i = _mm512_mask_mov_ps ( _mm512_mask_mov_ps ( x1i, left, x0i ), right, xe );
+          __m512 const next_f0i = _mm512_mask_mov_ps ( _mm512_mask_mov_ps ( f0i, right, f1i ), left, fe );
+          __m512 const next_f1i = _mm512_mask_mov_ps ( _mm512_mask_mov_ps ( f1i, left, f0i ), right, fe );
+
+          x0i = next_x0i;
+          x1i = next_x1i;
+          f0i = next_f0i;
+          f1i = next_f1i;
+        }
+      }
+
+      _mm512_mask_storeu_ps ( x_min + first, used_mask, _mm512_mul_ps ( _mm512_add_ps ( x0, x1 ), half ) );
+
+      if ( statistics )
+      {
+        alignas ( 64 ) int32_t call_lanes[lanes];
+        _mm512_store_si512 ( call_lanes, calls );
+
+        for ( size_t l = 0; l < used; ++l )
+        {
+          statistics[first + l].funct_invocation_count += static_cast<size_t> ( call_lanes[l] );
+        }
+      }
+    }
+  }
+};
+
+#endif // NNET_SIMD_X86
+
+}  // namespace find_minimum_batch_details
+
+// count independent minimizations over [xa[p], xb[p]], run in lockstep a block of problems
+// per register on the avx2 and avx512 cpus; funct ( x, f, first, lanes ) sets f[l] to the
+// target of the problem first + l at x[l] for every l < lanes. x_min[p] and statistics[p]
+// ( when given, one per problem ) are those of find_minimum<METHOD_ENUM> on the problem p
+// alone, bit for bit for a double T. The dichotomie and gold_ratio methods only
+template <find_minimum_method METHOD_ENUM,
+          typename T,
+          typename BATCH_FUNCTION_T>
+void find_minimum_batch ( T const* xa, T const* xb,
+                          T const eps,
+                          size_t const count,
+                          BATCH_FUNCTION_T&& funct,
+                          T* x_min,
+                          find_minimum_t* statistics = nullptr )
+{
+  static_assert ( METHOD_ENUM == find_minimum_method::dichotomie || METHOD_ENUM == find_minimum_method::gold_ratio,
+                  "The lockstep steps exist for dichotomie and gold_ratio" );
+
+  using nnet::simd::isa;
+  using find_minimum_batch_details::find_minimum_batch_traits;
+
+  switch ( nnet::simd::get_isa() )
+  {
+  case isa::avx2:
+    find_minimum_batch_traits<T, isa::avx2>::template method<METHOD_ENUM> ( xa, xb, eps, count, funct, x_min, statistics );
+    break;
+
+  case isa::avx512:
+  case isa::avx512_vnni:
+    find_minimum_batch_traits<T, isa::avx512>::template method<METHOD_ENUM> ( xa, xb, eps, count, funct, x_min, statistics );
+    break;
+
+  default:
+    find_minimum_batch_traits<T, isa::scalar>::template method<METHOD_ENUM> ( xa, xb, eps, count, funct, x_min, statistics );
+    break;
+  }
+}
+
+}  // namespace noptim
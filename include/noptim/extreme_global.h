@@ -0,0 +1,179 @@
+#pragma once
+
+#include <noptim/extreme.h>
+#include <utils/thread_pool.h>
+
+#include <cstddef>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+
+namespace noptim
+{
+
+template<typename T>
+struct local_minimum_t
+{
+  T x{};
+  T value{};
+};
+
+// the best of the refined minima, local_minima holds all of them by ascending value
+template<typename T>
+struct global_minimum_t
+{
+  T x{};
+  T value{};
+  std::vector<local_minimum_t<T>> local_minima;
+
+  bool is_valid() const noexcept
+  {
+    return !local_minima.empty();
+  }
+};
+
+namespace find_global_minimum_details
+{
+
+// the grid points no higher than their neighbours, a plateau gives its first point only;
+// a NaN point is never a minimum and is higher than any neighbour
+template<typename T>
+std::vector<size_t> grid_minima ( std::vector<T> const& values )
+{
+  std::vector<size_t> result;
+  auto const last = values.size() - 1;
+
+  for ( size_t i = 0; i <= last; ++i )
+  {
+    if ( std::isnan ( values[i] ) )
+    {
+      continue;
+    }
+
+    bool const below_left = ( i == 0 ) || std::isnan ( values[i - 1] ) || values[i] < values[i - 1];
+    bool const below_right = ( i == last ) || std::isnan ( values[i + 1] ) || values[i] <= values[i + 1];
+
+    if ( below_left && below_right )
+    {
+      result.push_back ( i );
+    }
+  }
+
+  return result;
+}
+
+}  // namespace find_global_minimum_details
+
+// find_minimum for a multimodal funct: grid_size points of [xa, xb] are evaluated on the pool,
+// then the refine_count lowest grid minima are refined by METHOD_ENUM concurrently, each on
+// [x[i - 1], x[i + 1]]; every task calls its own copy of funct, so a stateful funct is safe
+// as long as its copies are independent. The caller picks the pool, a funct running a wide
+// line of its own keeps the default pool for it. statistics, when given, counts all the evaluations
+template <find_minimum_method METHOD_ENUM,
+          typename T,
+          typename LOSS_FUNCTION_T>
+global_minimum_t<T> find_global_minimum ( T const xa, T const xb,
+    T const eps,
+    size_t const grid_size,
+    size_t const refine_count,
+    LOSS_FUNCTION_T const& funct,
+    thread_pool_utils::thread_pool_t& pool,
+    find_minimum_t* statistics = nullptr )
+{
+  global_minimum_t<T> result;
+
+  if ( !( xb > xa ) || !refine_count )
+  {
+    return result;
+  }
+
+  auto const point_count = std::max ( grid_size, size_t{3} );
+  auto const grid_step = ( xb - xa ) / static_cast<T> ( point_count - 1 );
+
+  auto const grid_x = [xa, xb, grid_step, point_count] ( size_t const i )
+  {
+    return ( i == point_count - 1 ) ? xb : xa + grid_step * static_cast<T> ( i );
+  };
+
+  std::vector<T> values ( point_count );
+  auto const grid_chunk = std::max ( size_t{1}, point_count / ( 4 * pool.get_thread_count() ) );
+
+  pool.parallel_for ( 0, point_count, grid_chunk, [&funct, &values, &grid_x] ( size_t begin, size_t end )
+  {
+    auto local_funct = funct;
+
+    for ( auto i = begin; i < end; ++i )
+    {
+      values[i] = local_funct ( grid_x ( i ) );
+    }
+  } );
+
+  auto candidates = find_global_minimum_details::grid_minima ( values );
+
+  std::sort ( candidates.begin(), candidates.end(), [&values] ( size_t const lhs, size_t const rhs )
+  {
+    return values[lhs] < values[rhs];
+  } );
+
+  // a funct with no number on the grid has no minimum to refine
+  if ( candidates.empty() )
+  {
+    if ( statistics )
+    {
+      statistics->funct_invocation_count += point_count;
+    }
+
+    return result;
+  }
+
+  candidates.resize ( std::min ( candidates.size(), refine_count ) );
+
+  result.local_minima.resize ( candidates.size() );
+  std::vector<find_minimum_t> refine_statistics ( candidates.size() );
+
+  pool.parallel_for ( 0, candidates.size(), 1, [&] ( size_t begin, size_t end )
+  {
+    auto local_funct = funct;
+
+    for ( auto c = begin; c < end; ++c )
+    {
+      auto const i = candidates[c];
+      auto const x0 = grid_x ( ( i == 0 ) ? 0 : i - 1 );
+      auto const x1 = grid_x ( std::min ( i + 1, point_count - 1 ) );
+
+      auto& minimum = result.local_minima[c];
+      minimum.x = find_minimum<METHOD_ENUM> ( x0, x1, eps, local_funct, &refine_statistics[c] );
+      minimum.value = local_funct ( minimum.x );
+
+      // the refined point never loses to the grid point it started from, nor ends on a NaN
+      if ( !( minimum.value <= values[i] ) )
+      {
+        minimum.x = grid_x ( i );
+        minimum.value = values[i];
+      }
+    }
+  } );
+
+  std::sort ( result.local_minima.begin(), result.local_minima.end(),
+              [] ( local_minimum_t<T> const & lhs, local_minimum_t<T> const & rhs )
+  {
+    return lhs.value < rhs.value;
+  } );
+
+  result.x = result.local_minima.front().x;
+  result.value = result.local_minima.front().value;
+
+  if ( statistics )
+  {
+    statistics->funct_invocation_count += point_count + candidates.size();
+
+    for ( auto const& refine_stat : refine_statistics )
+    {
+      statistics->funct_invocation_count += refine_stat.funct_invocation_count;
+    }
+  }
+
+  return result;
+}
+
+}  // namespace noptim
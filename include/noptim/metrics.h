@@ -1,5 +1,14 @@
 #pragma once
 
+#include <nnet/simd.h>
+#include <utils/thread_pool.h>
+
+#include <cstddef>
+#include <cmath>
+#include <array>
+#include <vector>
+#include <algorithm>
+
 namespace noptim
 {
 
@@ -21,16 +30,258 @@ OUTPUT_T neuron_line_loss (
 {
   OUTPUT_T result{};
 
-  auto const* neuron_ptr = neuron_line.data();
-  auto const* expected_value_ptr = expected_value.data();
-
-  for ( size_t i = 0; i < neuron_line.size(); ++i, ++neuron_ptr, ++expected_value_ptr )
+  for ( size_t i = 0; i < neuron_line.size(); ++i )
   {
-    result += neuron_loss<OUTPUT_T> ( *neuron_ptr, *expected_value_ptr );
+    result += neuron_loss<OUTPUT_T> ( neuron_line[i], expected_value[i] );
   }
 
   return result;
 }
 
+//-----------------------------------------------------------------------------
+
+enum class loss_method
+{
+  mse,
+  mae,
+  huber,
+  cross_entropy
+};
+
+struct loss_parameters_t
+{
+  double huber_delta{1.0};
+
+  // the cross entropy outputs are clamped to [epsilon, 1 - epsilon]
+  double epsilon{1e-7};
+
+  // the rows are reduced in chunks across the pool when it is given
+  thread_pool_utils::thread_pool_t* pool{};
+  size_t chunk_rows{1024};
+};
+
+namespace metrics_details
+{
+
+// the loss of one output y against the expected t and its derivative by y
+template<loss_method METHOD_ENUM>
+struct loss_traits;
+
+template<>
+struct loss_traits<loss_method::mse>
+{
+  template<typename T>
+  static T loss ( T const y, T const t, [[maybe_unused]] T const delta, [[maybe_unused]] T const eps ) noexcept
+  {
+    return ( y - t ) * ( y - t );
+  }
+
+  template<typename T>
+  static T gradient ( T const y, T const t, [[maybe_unused]] T const delta, [[maybe_unused]] T const eps ) noexcept
+  {
+    return T{2} * ( y - t );
+  }
+};
+
+template<>
+struct loss_traits<loss_method::mae>
+{
+  template<typename T>
+  static T loss ( T const y, T const t, [[maybe_unused]] T const delta, [[maybe_unused]] T const eps ) noexcept
+  {
+    return std::fabs ( y - t );
+  }
+
+  template<typename T>
+  static T gradient ( T const y, T const t, [[maybe_unused]] T const delta, [[maybe_unused]] T const eps ) noexcept
+  {
+    return static_cast<T> ( ( y > t ) - ( y < t ) );
+  }
+};
+
+template<>
+struct loss_traits<loss_method::huber>
+{
+  template<typename T>
+  static T loss ( T const y, T const t, T const delta, [[maybe_unused]] T const eps ) noexcept
+  {
+    auto const r = std::fabs ( y - t );
+    return ( r <= delta ) ? T{0.5} * r * r : delta * ( r - T{0.5} * delta );
+  }
+
+  template<typename T>
+  static T gradient ( T const y, T const t, T const delta, [[maybe_unused]] T const eps ) noexcept
+  {
+    return std::min ( std::max ( y - t, -delta ), delta );
+  }
+};
+
+// binary cross entropy, y and t are probabilities
+template<>
+struct loss_traits<loss_method::cross_entropy>
+{
+  template<typename T>
+  static T loss ( T const y, T const t, [[maybe_unused]] T const delta, T const eps ) noexcept
+  {
+    auto const p = std::min ( std::max ( y, eps ), T{1} - eps );
+    return -( t * std::log ( p ) + ( T{1} - t ) * std::log ( T{1} - p ) );
+  }
+
+  template<typename T>
+  static T gradient ( T const y, T const t, [[maybe_unused]] T const delta, T const eps ) noexcept
+  {
+    auto const p = std::min ( std::max ( y, eps ), T{1} - eps );
+    return ( p - t ) / ( p * ( T{1} - p ) );
+  }
+};
+
+// mse and mae are summed by the simd::diff_sum kernels; the other losses call std::log or
+// std::fabs per element and stay scalar, with 8 partial sums to keep the rounding error down
+template<loss_method METHOD_ENUM>
+struct loss_diff_norm;
+
+template<>
+struct loss_diff_norm<loss_method::mse>
+{
+  static constexpr auto const norm = nnet::simd::diff_norm::squared;
+};
+
+template<>
+struct loss_diff_norm<loss_method::mae>
+{
+  static constexpr auto const norm = nnet::simd::diff_norm::absolute;
+};
+
+template<loss_method METHOD_ENUM, typename T>
+constexpr bool has_loss_kernel()
+{
+  return ( METHOD_ENUM == loss_method::mse || METHOD_ENUM == loss_method::mae ) && nnet::simd::has_diff_sum_kernels<T>();
+}
+
+constexpr size_t const lanes = 8;
+
+template<typename T>
+T sum_lanes ( std::array<T, lanes> const& acc ) noexcept
+{
+  return ( ( acc[0] + acc[1] ) + ( acc[2] + acc[3] ) ) + ( ( acc[4] + acc[5] ) + ( acc[6] + acc[7] ) );
+}
+
+// the sum of the losses of n outputs, gradient receives scale times the derivatives if given
+template<loss_method METHOD_ENUM, typename T>
+T sum_loss ( T const* y, T const* t, size_t const n, T const delta, T const eps,
+             T* gradient, T const scale ) noexcept
+{
+  using traits = loss_traits<METHOD_ENUM>;
+
+  if constexpr ( has_loss_kernel<METHOD_ENUM, T>() )
+  {
+    if ( gradient )
+    {
+      for ( size_t i = 0; i < n; ++i )
+      {
+        gradient[i] = scale * traits::gradient ( y[i], t[i], delta, eps );
+      }
+    }
+
+    return nnet::simd::diff_sum<loss_diff_norm<METHOD_ENUM>::norm> ( y, t, n );
+  }
+
+  std::array<T, lanes> acc{};
+
+  size_t i = 0;
+
+  for ( ; i + lanes <= n; i += lanes )
+  {
+    for ( size_t l = 0; l < lanes; ++l )
+    {
+      acc[l] += traits::loss ( y[i + l], t[i + l], delta, eps );
+    }
+
+    if ( gradient )
+    {
+      for ( size_t l = 0; l < lanes; ++l )
+      {
+        gradient[i + l] = scale * traits::gradient ( y[i + l], t[i + l], delta, eps );
+      }
+    }
+  }
+
+  for ( ; i < n; ++i )
+  {
+    acc[i % lanes] += traits::loss ( y[i], t[i], delta, eps );
+
+    if ( gradient )
+    {
+      gradient[i] = scale * traits::gradient ( y[i], t[i], delta, eps );
+    }
+  }
+
+  return sum_lanes ( acc );
+}
+
+template<loss_method METHOD_ENUM, typename T>
+T mean_loss ( T const* outputs, T const* expected, size_t const count, size_t const dimension,
+              T* gradient, loss_parameters_t const& parameters )
+{
+  auto const n = count * dimension;
+
+  if ( n == 0 )
+  {
+    return T{};
+  }
+
+  auto const delta = static_cast<T> ( parameters.huber_delta );
+  auto const eps = static_cast<T> ( parameters.epsilon );
+  auto const scale = T{1} / static_cast<T> ( n );
+  auto const chunk_rows = std::max ( parameters.chunk_rows, size_t{1} );
+
+  if ( !parameters.pool || count <= chunk_rows )
+  {
+    return scale * sum_loss<METHOD_ENUM> ( outputs, expected, n, delta, eps, gradient, scale );
+  }
+
+  // one partial sum per chunk added in order, so the result does not depend on the scheduling
+  std::vector<T> partial_sums ( ( count + chunk_rows - 1 ) / chunk_rows );
+
+  parameters.pool->parallel_for ( 0, partial_sums.size(), 1, [&] ( size_t begin, size_t end )
+  {
+    for ( size_t c = begin; c < end; ++c )
+    {
+      auto const offset = c * chunk_rows * dimension;
+      auto const size = ( std::min ( ( c + 1 ) * chunk_rows, count ) - c * chunk_rows ) * dimension;
+
+      partial_sums[c] = sum_loss<METHOD_ENUM> ( outputs + offset, expected + offset, size, delta, eps,
+                        gradient ? gradient + offset : nullptr, scale );
+    }
+  } );
+
+  T result{};
+
+  for ( auto const partial_sum : partial_sums )
+  {
+    result += partial_sum;
+  }
+
+  return scale * result;
+}
+
+}  // namespace metrics_details
+
+// the mean loss over a row-major count x dimension buffer of outputs against the expected ones
+template<loss_method METHOD_ENUM, typename T>
+T batch_loss ( T const* outputs, T const* expected, size_t const count, size_t const dimension,
+               loss_parameters_t const& parameters = loss_parameters_t() )
+{
+  return metrics_details::mean_loss<METHOD_ENUM, T> ( outputs, expected, count, dimension, nullptr, parameters );
+}
+
+// batch_loss and its gradient by the outputs in the same pass, gradient is a count x dimension buffer
+template<loss_method METHOD_ENUM, typename T>
+T batch_loss_gradient ( T const* outputs, T const* expected, size_t const count, size_t const dimension,
+                        T* gradient, loss_parameters_t const& parameters = loss_parameters_t() )
+{
+  return metrics_details::mean_loss<METHOD_ENUM> ( outputs, expected, count, dimension, gradient, parameters );
+}
+
 } // namespace noptim
 
@@ -8,35 +8,81 @@
 #include <functional>
 #include <type_traits>
 #include <cmath>
+#include <limits>
+#include <algorithm>
 
 namespace noptim
 {
 
+enum class descent_method
+{
+  steepest,
+  conjugate_gradient
+};
+
+namespace quick_descent_details
+{
+
+// the sufficient decrease of the Armijo condition
+constexpr double const armijo_koef = 1e-4;
+
+template<descent_method DESCENT_ENUM>
+struct descent_traits;
+
+template<>
+struct descent_traits<descent_method::steepest>
+{
+  // the factor of the previous direction added to the antigradient
+  template<typename T>
+  static T beta ( T const /*gradient_norm2*/, T const /*previous_gradient_norm2*/, T const /*gradient_dot_previous*/ ) noexcept
+  {
+    return T{};
+  }
+};
+
+template<>
+struct descent_traits<descent_method::conjugate_gradient>
+{
+  // Polak-Ribiere, clamped at zero so a bad direction falls back to the antigradient
+  template<typename T>
+  static T beta ( T const gradient_norm2, T const previous_gradient_norm2, T const gradient_dot_previous ) noexcept
+  {
+    return ( previous_gradient_norm2 > T{} )
+           ? std::max ( T{}, ( gradient_norm2 - gradient_dot_previous ) / previous_gradient_norm2 )
+           : T{};
+  }
+};
+
+}  // namespace quick_descent_details
+
+// FUNCT is stored and called as is, so a lambda or a functor is inlined into the
+// partial minimizations; quick_descent below keeps the std::function flavour
 template<find_minimum_method METHOD_ENUM,
+         typename FUNCT,
          typename RET_TYPE,
          typename ... ARGS>
-struct quick_descent
+struct basic_quick_descent
 {
   static constexpr auto find_minimum_method = METHOD_ENUM;
   using funct_ret_t = RET_TYPE;
   using funct_arg_t = RET_TYPE;
   using funct_args_t = tuple_utils::funct_args_t<ARGS... >;
-  using target_function_t = tuple_utils::target_function_t<funct_ret_t, ARGS... >;
+  using target_function_t = FUNCT;
 
   using funct_gradient_t = funct_args_t;
 
   static constexpr size_t const funct_args_count = std::tuple_size<funct_args_t>::value;
 
-  quick_descent ( funct_arg_t const& step,
-                  funct_arg_t const& eps,
-                  funct_args_t const& min_point,
-                  funct_args_t const& max_point,
-                  target_function_t funct )
+  basic_quick_descent ( funct_arg_t const& step,
+                        funct_arg_t const& eps,
+                        funct_args_t const& min_point,
+                        funct_args_t const& max_point,
+                        target_function_t funct )
     : step ( step )
     , eps ( eps )
     , min_point ( min_point )
     , max_point ( max_point )
-    , funct ( funct )
+    , funct ( std::move ( funct ) )
   {
     static_assert ( std::is_arithmetic<funct_ret_t>::value, "RET_TYPE should have an arithmetic type" );
     static_assert ( std::is_arithmetic<funct_arg_t>::value, "RET_TYPE should have an arithmetic type" );
@@ -45,12 +91,105 @@ struct quick_descent
 
   funct_gradient_t get_gradient ( funct_args_t const& args ) const
   {
-    return get_gradient_impl ( args, std::make_index_sequence<quick_descent::funct_args_count>() );
+    return get_gradient_impl ( args, std::make_index_sequence<basic_quick_descent::funct_args_count>() );
   }
 
   funct_args_t find_minimum ( noptim::find_minimum_t* statistics = nullptr ) const
   {
-    return find_minimum_impl ( statistics, std::make_index_sequence<quick_descent::funct_args_count>() );
+    return find_minimum_impl ( statistics, std::make_index_sequence<basic_quick_descent::funct_args_count>() );
+  }
+
+  // the sweep of find_minimum refined by DESCENT_ENUM steps: each step minimizes along the
+  // direction inside the box with find_minimum on METHOD_ENUM, then backtracks until the
+  // Armijo condition holds; stops when the gradient norm or the step is below eps, or after
+  // max_iteration_count steps. The gradient is the central difference over step,
+  // one-sided at the bounds of the box
+  template<descent_method DESCENT_ENUM = descent_method::conjugate_gradient>
+  funct_args_t find_minimum_iterative ( size_t const max_iteration_count,
+                                        noptim::find_minimum_t* statistics = nullptr ) const
+  {
+    using traits = quick_descent_details::descent_traits<DESCENT_ENUM>;
+    using indexes_t = std::make_index_sequence<basic_quick_descent::funct_args_count>;
+
+    auto point = find_minimum ( statistics );
+    auto value = funct ( point );
+    count_invocations ( statistics, 1 );
+
+    auto gradient = get_central_gradient ( point, statistics, indexes_t() );
+    funct_gradient_t previous_gradient{};
+    funct_gradient_t direction{};
+
+    for ( size_t iteration = 0; iteration < max_iteration_count; ++iteration )
+    {
+      auto const gradient_norm2 = dot ( gradient, gradient, indexes_t() );
+
+      if ( std::sqrt ( gradient_norm2 ) <= eps )
+      {
+        break;
+      }
+
+      if ( statistics )
+      {
+        statistics->iteration_count++;
+      }
+
+      auto const beta = traits::beta ( gradient_norm2, dot ( previous_gradient, previous_gradient, indexes_t() ),
+                                       dot ( gradient, previous_gradient, indexes_t() ) );
+
+      direction = clip_direction ( point, combine ( -1, gradient, beta, direction, indexes_t() ), indexes_t() );
+
+      // not a descent direction, restart from the antigradient
+      if ( !( dot ( gradient, direction, indexes_t() ) < funct_arg_t{} ) )
+      {
+        direction = clip_direction ( point, combine ( -1, gradient, 0, direction, indexes_t() ), indexes_t() );
+      }
+
+      auto const slope = dot ( gradient, direction, indexes_t() );
+      auto const direction_norm = std::sqrt ( dot ( direction, direction, indexes_t() ) );
+
+      // the antigradient points out of the box, the point is a minimum on the box
+      if ( !( slope < funct_arg_t{} ) )
+      {
+        break;
+      }
+
+      auto line_function = [this, &point, &direction] ( funct_arg_t t )->funct_ret_t
+      {
+        return funct ( combine ( 1, point, t, direction, indexes_t() ) );
+      };
+
+      auto t = noptim::find_minimum<find_minimum_method> ( funct_arg_t{}, get_max_step ( point, direction, indexes_t() ),
+               eps / direction_norm, line_function, statistics );
+      auto next_value = line_function ( t );
+      count_invocations ( statistics, 1 );
+
+      // the line minimum of a non unimodal slice may miss the sufficient decrease, backtrack
+      while ( next_value > value + funct_arg_t ( quick_descent_details::armijo_koef ) * t * slope
+              && t * direction_norm > eps )
+      {
+        t /= 2;
+        next_value = line_function ( t );
+        count_invocations ( statistics, 1 );
+      }
+
+      if ( !( next_value < value ) )
+      {
+        break;
+      }
+
+      point = combine ( 1, point, t, direction, indexes_t() );
+      value = next_value;
+
+      previous_gradient = gradient;
+      gradient = get_central_gradient ( point, statistics, indexes_t() );
+
+      if ( t * direction_norm <= eps )
+      {
+        break;
+      }
+    }
+
+    return point;
   }
 
 private:
@@ -120,14 +259,141 @@ private:
     return result;
   }
 
+  static void count_invocations ( noptim::find_minimum_t* statistics, size_t const count ) noexcept
+  {
+    if ( statistics )
+    {
+      statistics->funct_invocation_count += count;
+    }
+  }
+
+  // ( f ( upper ) - f ( lower ) ) / ( upper - lower ) along the coordinate Index, [lower, upper]
+  // is [x - step, x + step] clipped to the box: central inside, one-sided at an active bound,
+  // so funct is never probed outside the box; 0 for a box flat along the coordinate
+  template<size_t Index>
+  funct_arg_t get_partial_derivative ( funct_args_t const& args, noptim::find_minimum_t* statistics ) const
+  {
+    using coordinate_t = std::tuple_element_t<Index, funct_args_t>;
+
+    funct_args_t lower{args};
+    funct_args_t upper{args};
+
+    std::get<Index> ( lower ) = std::max<coordinate_t> ( std::get<Index> ( args ) - step, std::get<Index> ( min_point ) );
+    std::get<Index> ( upper ) = std::min<coordinate_t> ( std::get<Index> ( args ) + step, std::get<Index> ( max_point ) );
+
+    auto const width = static_cast<funct_arg_t> ( std::get<Index> ( upper ) - std::get<Index> ( lower ) );
+
+    if ( !( width > funct_arg_t{} ) )
+    {
+      return funct_arg_t{};
+    }
+
+    count_invocations ( statistics, 2 );
+
+    return ( funct ( upper ) - funct ( lower ) ) / width;
+  }
+
+  template<size_t ... Indexes>
+  funct_gradient_t get_central_gradient ( funct_args_t const& args, noptim::find_minimum_t* statistics,
+                                          std::integer_sequence<size_t, Indexes...> ) const
+  {
+    funct_gradient_t result{};
+
+    ( ( std::get<Indexes> ( result ) = get_partial_derivative<Indexes> ( args, statistics ) ), ... );
+
+    return result;
+  }
+
+  template<size_t ... Indexes>
+  static funct_arg_t dot ( funct_args_t const& a, funct_args_t const& b, std::integer_sequence<size_t, Indexes...> )
+  {
+    funct_arg_t result{};
+
+    ( ( result += std::get<Indexes> ( a ) * std::get<Indexes> ( b ) ), ... );
+
+    return result;
+  }
+
+  // ka * a + kb * b
+  template<size_t ... Indexes>
+  static funct_args_t combine ( funct_arg_t const ka, funct_args_t const& a,
+                                funct_arg_t const kb, funct_args_t const& b,
+                                std::integer_sequence<size_t, Indexes...> )
+  {
+    funct_args_t result{};
+
+    ( ( std::get<Indexes> ( result ) = ka * std::get<Indexes> ( a ) + kb * std::get<Indexes> ( b ) ), ... );
+
+    return result;
+  }
+
+  // the direction components leaving the box at a bound the point sits on are dropped
+  template<size_t ... Indexes>
+  funct_args_t clip_direction ( funct_args_t const& args, funct_args_t direction,
+                                std::integer_sequence<size_t, Indexes...> ) const
+  {
+    ( ( std::get<Indexes> ( direction ) =
+          ( ( std::get<Indexes> ( args ) <= std::get<Indexes> ( min_point ) && std::get<Indexes> ( direction ) < 0 )
+            || ( std::get<Indexes> ( args ) >= std::get<Indexes> ( max_point ) && std::get<Indexes> ( direction ) > 0 ) )
+          ? 0 : std::get<Indexes> ( direction ) ), ... );
+
+    return direction;
+  }
+
+  // the largest t keeping args + t * direction inside the box
+  template<size_t ... Indexes>
+  funct_arg_t get_max_step ( funct_args_t const& args, funct_args_t const& direction,
+                             std::integer_sequence<size_t, Indexes...> ) const
+  {
+    auto result = std::numeric_limits<funct_arg_t>::max();
+
+    auto const limit = [&result] ( auto const x, auto const d, auto const lower, auto const upper )
+    {
+      if ( d > 0 )
+      {
+        result = std::min<funct_arg_t> ( result, ( upper - x ) / d );
+      }
+      else if ( d < 0 )
+      {
+        result = std::min<funct_arg_t> ( result, ( lower - x ) / d );
+      }
+    };
+
+    ( limit ( std::get<Indexes> ( args ), std::get<Indexes> ( direction ),
+              std::get<Indexes> ( min_point ), std::get<Indexes> ( max_point ) ), ... );
+
+    return std::max ( result, funct_arg_t{} );
+  }
+
 private:
   funct_arg_t const step;
   funct_arg_t const eps;
   funct_args_t const min_point;
   funct_args_t const max_point;
-  target_function_t funct;
+
+  // the const methods call it, as std::function::operator () does
+  mutable target_function_t funct;
 };
 
+template<find_minimum_method METHOD_ENUM,
+         typename RET_TYPE,
+         typename ... ARGS>
+using quick_descent = basic_quick_descent<METHOD_ENUM, tuple_utils::target_function_t<RET_TYPE, ARGS... >, RET_TYPE, ARGS...>;
+
+template<find_minimum_method METHOD_ENUM,
+         typename RET_TYPE,
+         typename ... ARGS,
+         typename FUNCT>
+auto make_quick_descent ( RET_TYPE const& step,
+                          RET_TYPE const& eps,
+                          tuple_utils::funct_args_t<ARGS...> const& min_point,
+                          tuple_utils::funct_args_t<ARGS...> const& max_point,
+                          FUNCT&& funct )
+{
+  return basic_quick_descent<METHOD_ENUM, std::decay_t<FUNCT>, RET_TYPE, ARGS...> ( step, eps, min_point, max_point,
+         std::forward<FUNCT> ( funct ) );
+}
+
 
 
 } // namespace noptim
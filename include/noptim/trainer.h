@@ -0,0 +1,225 @@
+#pragma once
+
+#include <nnet/backprop.h>
+
+#include <cstddef>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include <type_traits>
+
+namespace noptim
+{
+
+enum class train_method
+{
+  sgd,
+  momentum,
+  adam
+};
+
+struct train_parameters_t
+{
+  double learning_rate{0.01};
+  double momentum{0.9};
+  double beta1{0.9};
+  double beta2{0.999};
+  double epsilon{1e-8};
+  size_t batch_size{16};
+};
+
+struct train_statistics_t
+{
+  size_t epoch_count{};
+  size_t step_count{};
+  double loss{};
+};
+
+namespace trainer_details
+{
+
+// w -= update ( g ), g is the mean gradient over the minibatch,
+// m and v are the per-koef optimizer states, step starts from 1
+template<train_method METHOD_ENUM>
+struct optimizer_traits;
+
+template<>
+struct optimizer_traits<train_method::sgd>
+{
+  static constexpr size_t const state_count = 0;
+
+  template<typename T>
+  static void method ( T* w, T const* g, [[maybe_unused]] T* m, [[maybe_unused]] T* v, size_t const n,
+                       train_parameters_t const& parameters, [[maybe_unused]] size_t const step ) noexcept
+  {
+    auto const rate = static_cast<T> ( parameters.learning_rate );
+
+    for ( size_t i = 0; i < n; ++i )
+    {
+      w[i] -= rate * g[i];
+    }
+  }
+};
+
+template<>
+struct optimizer_traits<train_method::momentum>
+{
+  static constexpr size_t const state_count = 1;
+
+  template<typename T>
+  static void method ( T* w, T const* g, T* m, [[maybe_unused]] T* v, size_t const n,
+                       train_parameters_t const& parameters, [[maybe_unused]] size_t const step ) noexcept
+  {
+    auto const rate = static_cast<T> ( parameters.learning_rate );
+    auto const mju = static_cast<T> ( parameters.momentum );
+
+    for ( size_t i = 0; i < n; ++i )
+    {
+      m[i] = mju * m[i] + g[i];
+      w[i] -= rate * m[i];
+    }
+  }
+};
+
+template<>
+struct optimizer_traits<train_method::adam>
+{
+  static constexpr size_t const state_count = 2;
+
+  template<typename T>
+  static void method ( T* w, T const* g, T* m, T* v, size_t const n,
+                       train_parameters_t const& parameters, size_t const step ) noexcept
+  {
+    auto const beta1 = static_cast<T> ( parameters.beta1 );
+    auto const beta2 = static_cast<T> ( parameters.beta2 );
+    auto const eps = static_cast<T> ( parameters.epsilon );
+
+    // the bias corrections are folded into the step size
+    auto const correction1 = 1.0 - std::pow ( parameters.beta1, static_cast<double> ( step ) );
+    auto const correction2 = 1.0 - std::pow ( parameters.beta2, static_cast<double> ( step ) );
+    auto const rate = static_cast<T> ( parameters.learning_rate * std::sqrt ( correction2 ) / correction1 );
+
+    for ( size_t i = 0; i < n; ++i )
+    {
+      m[i] = beta1 * m[i] + ( T{1} - beta1 ) * g[i];
+      v[i] = beta2 * v[i] + ( T{1} - beta2 ) * g[i] * g[i];
+      w[i] -= rate * m[i] / ( std::sqrt ( v[i] ) + eps );
+    }
+  }
+};
+
+}  // namespace trainer_details
+
+// minibatch trainer on the squared error loss used by noptim::neuron_line_loss,
+// MODEL_T is either nnet::neuron_line_t or nnet::neuron_network_t
+template<train_method METHOD_ENUM, typename MODEL_T>
+struct trainer
+{
+  static constexpr auto train_method = METHOD_ENUM;
+
+  using backprop_t = nnet::backprop_t<MODEL_T>;
+  using input_array_t = typename backprop_t::input_array_t;
+  using output_array_t = typename backprop_t::output_array_t;
+  using output_t = typename backprop_t::output_t;
+  using optimizer_traits = trainer_details::optimizer_traits<METHOD_ENUM>;
+
+  static_assert ( std::is_floating_point<output_t>::value, "Only floating point models can be trained" );
+
+  trainer ( MODEL_T& model, train_parameters_t const& parameters )
+    : model ( model )
+    , parameters ( parameters )
+  {
+    size_t koef_count = 0;
+
+    backprop.for_each_koefs ( model, [&koef_count] ( auto*, auto*, size_t size )
+    {
+      koef_count += size;
+    } );
+
+    m.resize ( optimizer_traits::state_count > 0 ? koef_count : 0 );
+    v.resize ( optimizer_traits::state_count > 1 ? koef_count : 0 );
+  }
+
+  // one optimizer step over count samples, returns their summed loss
+  double train_batch ( input_array_t const* inputs, output_array_t const* expected_values, size_t const count )
+  {
+    backprop.zero_gradient();
+
+    double loss{};
+
+    for ( size_t s = 0; s < count; ++s )
+    {
+      backprop.forward ( model, inputs[s] );
+
+      auto const& value = backprop.get_value();
+
+      output_array_t output_gradient;
+
+      for ( size_t k = 0; k < value.size(); ++k )
+      {
+        auto const error = value[k] - expected_values[s][k];
+        loss += static_cast<double> ( error * error );
+        output_gradient[k] = output_t{2} * error;
+      }
+
+      backprop.backward ( model, inputs[s], output_gradient.data() );
+    }
+
+    ++step_count;
+
+    auto const scale = output_t{1} / static_cast<output_t> ( std::max ( count, size_t{1} ) );
+
+    size_t offset = 0;
+
+    backprop.for_each_koefs ( model, [this, &offset, scale] ( auto* koefs, auto* gradient, size_t size )
+    {
+      for ( size_t i = 0; i < size; ++i )
+      {
+        gradient[i] *= scale;
+      }
+
+      optimizer_traits::method ( koefs, gradient,
+                                 m.empty() ? nullptr : m.data() + offset,
+                                 v.empty() ? nullptr : v.data() + offset,
+                                 size, parameters, step_count );
+      offset += size;
+    } );
+
+    return loss;
+  }
+
+  // one pass over the data set in minibatches, returns the mean loss per sample
+  double train_epoch ( input_array_t const* inputs, output_array_t const* expected_values, size_t const count,
+                       train_statistics_t* statistics = nullptr )
+  {
+    auto const batch_size = std::max ( parameters.batch_size, size_t{1} );
+
+    double loss{};
+
+    for ( size_t s = 0; s < count; s += batch_size )
+    {
+      loss += train_batch ( inputs + s, expected_values + s, std::min ( batch_size, count - s ) );
+    }
+
+    loss /= static_cast<double> ( std::max ( count, size_t{1} ) );
+
+    if ( statistics )
+    {
+      statistics->epoch_count++;
+      statistics->step_count = step_count;
+      statistics->loss = loss;
+    }
+
+    return loss;
+  }
+
+private:
+  MODEL_T& model;
+  train_parameters_t const parameters;
+  backprop_t backprop{};
+  std::vector<output_t> m;
+  std::vector<output_t> v;
+  size_t step_count{};
+};
+
+} // namespace noptim
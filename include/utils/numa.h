@@ -0,0 +1,406 @@
+#pragma once
+
+#include <utils/thread_pool.h>
+
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <memory>
+#include <fstream>
+#include <thread>
+#include <new>
+#include <type_traits>
+#include <algorithm>
+
+namespace numa_utils
+{
+
+struct numa_node_t
+{
+  size_t id;
+  size_t memory_node;  // the kernel node the memory of this node is bound to
+  std::vector<size_t> cpus;
+};
+
+namespace numa_details
+{
+
+static constexpr size_t const huge_page_size = size_t{1} << 21;
+
+// the bits of mbind(2), not every toolchain ships numaif.h
+static constexpr int const mpol_bind = 2;
+static constexpr unsigned const mpol_mf_move = 1u << 1;
+
+// the sysfs cpulist format, "0-3,8,10-11"
+inline std::vector<size_t> parse_cpu_list ( std::string const& text )
+{
+  std::vector<size_t> result;
+  size_t pos = 0;
+
+  while ( pos < text.size() )
+  {
+    auto const end = std::min ( text.find ( ',', pos ), text.size() );
+    auto const item = text.substr ( pos, end - pos );
+    pos = end + 1;
+
+    if ( item.empty() || item[0] < '0' || item[0] > '9' )
+    {
+      continue;
+    }
+
+    auto const dash = item.find ( '-' );
+    auto const first = std::strtoul ( item.c_str(), nullptr, 10 );
+    auto const last = ( dash == std::string::npos ) ? first : std::strtoul ( item.c_str() + dash + 1, nullptr, 10 );
+
+    for ( auto cpu = first; cpu <= last; ++cpu )
+    {
+      result.push_back ( cpu );
+    }
+  }
+
+  return result;
+}
+
+inline std::string read_line ( std::string const& path )
+{
+  std::ifstream file ( path );
+  std::string line;
+  std::getline ( file, line );
+  return line;
+}
+
+inline std::vector<size_t> allowed_cpus()
+{
+  std::vector<size_t> result;
+  cpu_set_t set;
+  CPU_ZERO ( &set );
+
+  if ( sched_getaffinity ( 0, sizeof ( set ), &set ) == 0 )
+  {
+    for ( size_t cpu = 0; cpu < CPU_SETSIZE; ++cpu )
+    {
+      if ( CPU_ISSET ( cpu, &set ) )
+      {
+        result.push_back ( cpu );
+      }
+    }
+  }
+
+  if ( result.empty() )
+  {
+    result.push_back ( 0 );
+  }
+
+  return result;
+}
+
+inline size_t& current_node()
+{
+  static thread_local size_t node = 0;
+  return node;
+}
+
+}  // namespace numa_details
+
+// the nodes with the cpus this process may run on; NNET_FAKE_NUMA=N splits the cpus
+// into N fake nodes like numa=fake, so the replicated paths run on any box
+struct numa_topology_t
+{
+  std::vector<numa_node_t> nodes;
+
+  static numa_topology_t detect()
+  {
+    if ( auto const* fake_count = std::getenv ( "NNET_FAKE_NUMA" ) )
+    {
+      auto const count = std::strtoul ( fake_count, nullptr, 10 );
+
+      if ( count > 0 )
+      {
+        return fake ( count );
+      }
+    }
+
+    auto const allowed = numa_details::allowed_cpus();
+    numa_topology_t result;
+
+    for ( auto const node : numa_details::parse_cpu_list ( numa_details::read_line ( "/sys/devices/system/node/online" ) ) )
+    {
+      auto const path = "/sys/devices/system/node/node" + std::to_string ( node ) + "/cpulist";
+      numa_node_t entry{result.nodes.size(), node, {}};
+
+      for ( auto const cpu : numa_details::parse_cpu_list ( numa_details::read_line ( path ) ) )
+      {
+        if ( std::find ( allowed.cbegin(), allowed.cend(), cpu ) != allowed.cend() )
+        {
+          entry.cpus.push_back ( cpu );
+        }
+      }
+
+      if ( !entry.cpus.empty() )
+      {
+        result.nodes.push_back ( std::move ( entry ) );
+      }
+    }
+
+    // no sysfs, a single node with all the allowed cpus
+    if ( result.nodes.empty() )
+    {
+      result.nodes.push_back ( numa_node_t{0, 0, allowed} );
+    }
+
+    return result;
+  }
+
+  // node_count nodes over the allowed cpus in contiguous blocks, the nodes share cpus
+  // when there are fewer cpus than nodes; the memory stays on the first real node
+  static numa_topology_t fake ( size_t const node_count )
+  {
+    auto const allowed = numa_details::allowed_cpus();
+    auto const count = std::max ( node_count, size_t{1} );
+    numa_topology_t result;
+
+    for ( size_t n = 0; n < count; ++n )
+    {
+      numa_node_t entry{n, 0, {}};
+      auto const first = n * allowed.size() / count;
+      auto const last = std::max ( ( n + 1 ) * allowed.size() / count, first + 1 );
+
+      for ( auto i = first; i < last; ++i )
+      {
+        entry.cpus.push_back ( allowed[i % allowed.size()] );
+      }
+
+      result.nodes.push_back ( std::move ( entry ) );
+    }
+
+    return result;
+  }
+
+  size_t get_node_count() const noexcept
+  {
+    return nodes.size();
+  }
+
+  size_t get_cpu_count() const noexcept
+  {
+    size_t result = 0;
+
+    for ( auto const& node : nodes )
+    {
+      result += node.cpus.size();
+    }
+
+    return result;
+  }
+};
+
+// the node the calling thread was pinned to, 0 for the threads never pinned
+inline size_t get_current_node() noexcept
+{
+  return numa_details::current_node();
+}
+
+// pins the calling thread to one cpu, the cpus are taken node by node so the consecutive
+// slots fill a node before the next one; false when the affinity could not be set,
+// the thread still reports the node then so it keeps using the same replica
+inline bool pin_current_thread ( numa_topology_t const& topology, size_t slot )
+{
+  slot %= std::max ( topology.get_cpu_count(), size_t{1} );
+
+  for ( auto const& node : topology.nodes )
+  {
+    if ( slot < node.cpus.size() )
+    {
+      numa_details::current_node() = node.id;
+
+      cpu_set_t set;
+      CPU_ZERO ( &set );
+      CPU_SET ( node.cpus[slot], &set );
+
+      return pthread_setaffinity_np ( pthread_self(), sizeof ( set ), &set ) == 0;
+    }
+
+    slot -= node.cpus.size();
+  }
+
+  return false;
+}
+
+// one worker per cpu pinned in slot order, the calling thread takes part in the work
+// as slot 0 and is pinned here as well, so it should be the thread calling parallel_for
+inline std::unique_ptr<thread_pool_utils::thread_pool_t> make_pinned_pool ( numa_topology_t const& topology,
+    size_t const thread_count = 0 )
+{
+  pin_current_thread ( topology, 0 );
+
+  return std::make_unique<thread_pool_utils::thread_pool_t> (
+           thread_count ? thread_count : std::max ( topology.get_cpu_count(), size_t{1} ),
+           [topology] ( size_t slot )
+  {
+    pin_current_thread ( topology, slot );
+  } );
+}
+
+// anonymous memory of one node: mbind when the kernel allows it, first-touch by a thread
+// of the node otherwise, and transparent huge pages on request
+struct numa_buffer_t
+{
+  numa_buffer_t ( size_t const bytes, size_t const memory_node, bool const huge_pages = false ) noexcept
+  {
+    auto const page = huge_pages ? numa_details::huge_page_size : static_cast<size_t> ( sysconf ( _SC_PAGESIZE ) );
+    size = ( std::max ( bytes, size_t{1} ) + page - 1 ) / page * page;
+
+    // the extra page aligns the data to a huge page boundary
+    mapped_size = size + ( huge_pages ? page : 0 );
+    mapped = mmap ( nullptr, mapped_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0 );
+
+    if ( mapped == MAP_FAILED )
+    {
+      mapped = nullptr;
+      return;
+    }
+
+    auto const address = reinterpret_cast<uintptr_t> ( mapped );
+    data = reinterpret_cast<void*> ( ( address + page - 1 ) / page * page );
+
+    if ( huge_pages )
+    {
+      huge = madvise ( data, size, MADV_HUGEPAGE ) == 0;
+    }
+
+    if ( memory_node < 8 * sizeof ( unsigned long ) )
+    {
+      unsigned long mask = 1ul << memory_node;
+      bound = syscall ( SYS_mbind, data, size, numa_details::mpol_bind, &mask,
+                        8 * sizeof ( mask ) + 1, numa_details::mpol_mf_move ) == 0;
+    }
+  }
+
+  numa_buffer_t ( numa_buffer_t const& ) = delete;
+  numa_buffer_t& operator= ( numa_buffer_t const& ) = delete;
+
+  numa_buffer_t ( numa_buffer_t&& other ) noexcept
+    : mapped ( other.mapped )
+    , mapped_size ( other.mapped_size )
+    , data ( other.data )
+    , size ( other.size )
+    , bound ( other.bound )
+    , huge ( other.huge )
+  {
+    other.mapped = nullptr;
+    other.data = nullptr;
+  }
+
+  ~numa_buffer_t()
+  {
+    if ( mapped )
+    {
+      munmap ( mapped, mapped_size );
+    }
+  }
+
+  bool is_valid() const noexcept
+  {
+    return data != nullptr;
+  }
+
+  bool is_bound() const noexcept
+  {
+    return bound;
+  }
+
+  bool has_huge_pages() const noexcept
+  {
+    return huge;
+  }
+
+  void* get_data() const noexcept
+  {
+    return data;
+  }
+
+  size_t get_size() const noexcept
+  {
+    return size;
+  }
+
+private:
+  void* mapped{};
+  size_t mapped_size{};
+  void* data{};
+  size_t size{};
+  bool bound{};
+  bool huge{};
+};
+
+// a read-only copy of T on every node, each copy is written by a thread pinned to its node;
+// get_local () gives the copy of the node the calling thread is pinned to
+template<typename T>
+struct replicated_t
+{
+  static_assert ( std::is_trivially_copyable<T>::value, "The replicas are plain copies" );
+
+  replicated_t ( T const& source, numa_topology_t const& topology, bool const huge_pages = false )
+  {
+    size_t slot = 0;
+
+    for ( auto const& node : topology.nodes )
+    {
+      buffers.emplace_back ( sizeof ( T ), node.memory_node, huge_pages );
+      auto& buffer = buffers.back();
+
+      if ( buffer.is_valid() )
+      {
+        std::thread ( [&topology, &source, &buffer, slot]
+        {
+          pin_current_thread ( topology, slot );
+          new ( buffer.get_data() ) T ( source );
+        } ).join();
+      }
+
+      slot += node.cpus.size();
+    }
+  }
+
+  bool is_valid() const noexcept
+  {
+    return !buffers.empty() && std::all_of ( buffers.cbegin(), buffers.cend(), [] ( numa_buffer_t const & buffer )
+    {
+      return buffer.is_valid();
+    } );
+  }
+
+  size_t get_replica_count() const noexcept
+  {
+    return buffers.size();
+  }
+
+  numa_buffer_t const& get_buffer ( size_t const node ) const noexcept
+  {
+    return buffers[node];
+  }
+
+  T const& get ( size_t const node ) const noexcept
+  {
+    return *std::launder ( static_cast<T const*> ( buffers[node].get_data() ) );
+  }
+
+  T const& get_local() const noexcept
+  {
+    auto const node = get_current_node();
+    return get ( node < buffers.size() ? node : 0 );
+  }
+
+private:
+  std::vector<numa_buffer_t> buffers;
+};
+
+}  // namespace numa_utils
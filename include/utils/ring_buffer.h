@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstddef>
+#include <array>
+#include <atomic>
+
+namespace ring_buffer_utils
+{
+
+// bounded lock-free multi-producer single-consumer queue, every cell carries a sequence
+// number telling whether it is free for the push of a lap or full for the pop of it
+template<typename T, size_t CAPACITY>
+struct mpsc_ring_buffer_t
+{
+  static_assert ( CAPACITY >= 2 && ( CAPACITY & ( CAPACITY - 1 ) ) == 0, "CAPACITY should be a power of two" );
+
+  static constexpr size_t const capacity = CAPACITY;
+
+  mpsc_ring_buffer_t() noexcept
+  {
+    for ( size_t i = 0; i < CAPACITY; ++i )
+    {
+      cells[i].sequence.store ( i, std::memory_order_relaxed );
+    }
+  }
+
+  mpsc_ring_buffer_t ( mpsc_ring_buffer_t const& ) = delete;
+  mpsc_ring_buffer_t& operator= ( mpsc_ring_buffer_t const& ) = delete;
+
+  // false if the queue is full, any thread may push
+  bool try_push ( T const& value ) noexcept
+  {
+    auto position = tail.load ( std::memory_order_relaxed );
+
+    for ( ;; )
+    {
+      auto& cell = cells[position & ( CAPACITY - 1 )];
+      auto const sequence = cell.sequence.load ( std::memory_order_acquire );
+      auto const difference = static_cast<std::ptrdiff_t> ( sequence - position );
+
+      if ( difference == 0 )
+      {
+        if ( tail.compare_exchange_weak ( position, position + 1, std::memory_order_relaxed ) )
+        {
+          cell.value = value;
+          cell.sequence.store ( position + 1, std::memory_order_release );
+          return true;
+        }
+      }
+      else if ( difference < 0 )
+      {
+        return false;
+      }
+      else
+      {
+        position = tail.load ( std::memory_order_relaxed );
+      }
+    }
+  }
+
+  // false if the queue is empty, only the consumer thread may pop
+  bool try_pop ( T& value ) noexcept
+  {
+    auto& cell = cells[head & ( CAPACITY - 1 )];
+
+    if ( cell.sequence.load ( std::memory_order_acquire ) != head + 1 )
+    {
+      return false;
+    }
+
+    value = cell.value;
+    cell.sequence.store ( head + CAPACITY, std::memory_order_release );
+    ++head;
+
+    return true;
+  }
+
+  bool empty() const noexcept
+  {
+    return cells[head & ( CAPACITY - 1 )].sequence.load ( std::memory_order_acquire ) != head + 1;
+  }
+
+private:
+  struct cell_t
+  {
+    std::atomic<size_t> sequence;
+    T value;
+  };
+
+  std::array<cell_t, CAPACITY> cells;
+
+  // the producers and the consumer indexes live on their own cache lines
+  alignas ( 64 ) std::atomic<size_t> tail{};
+  alignas ( 64 ) size_t head{};
+};
+
+}  // namespace ring_buffer_utils
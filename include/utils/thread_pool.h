@@ -0,0 +1,199 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include <thread>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <algorithm>
+
+namespace thread_pool_utils
+{
+
+// persistent workers running one parallel_for at a time,
+// the calling thread takes part in the work as well;
+// worker_init ( i ) runs once on the worker i, 1 .. thread_count - 1, before any work
+struct thread_pool_t
+{
+  explicit thread_pool_t ( size_t const thread_count = std::max ( std::thread::hardware_concurrency(), 1u ),
+                           std::function<void ( size_t ) > const& worker_init = {} )
+  {
+    for ( size_t i = 1; i < thread_count; ++i )
+    {
+      workers.emplace_back ( [this, i, worker_init]
+      {
+        if ( worker_init )
+        {
+          worker_init ( i );
+        }
+
+        worker_loop();
+      } );
+    }
+  }
+
+  thread_pool_t ( thread_pool_t const& ) = delete;
+  thread_pool_t& operator= ( thread_pool_t const& ) = delete;
+
+  ~thread_pool_t()
+  {
+    {
+      std::lock_guard<std::mutex> lock ( mutex );
+      stopping = true;
+    }
+
+    work_available.notify_all();
+
+    for ( auto& worker : workers )
+    {
+      worker.join();
+    }
+  }
+
+  size_t get_thread_count() const noexcept
+  {
+    return workers.size() + 1;
+  }
+
+  // calls funct ( chunk_begin, chunk_end ) for consecutive chunks of [begin, end) and returns when all are done,
+  // the callable is not copied so no allocation happens per call; a call made from inside a chunk of
+  // this pool runs its chunks inline on the calling thread, the workers are busy with the outer call
+  template<typename FUNCT>
+  void parallel_for ( size_t const begin, size_t const end, size_t const chunk_size, FUNCT const& funct )
+  {
+    if ( begin >= end )
+    {
+      return;
+    }
+
+    if ( current_pool() == this )
+    {
+      auto const step = std::max ( chunk_size, size_t{1} );
+
+      for ( auto chunk_begin = begin; chunk_begin < end; )
+      {
+        auto const chunk_end = std::min ( chunk_begin + step, end );
+        funct ( chunk_begin, chunk_end );
+        chunk_begin = chunk_end;
+      }
+
+      return;
+    }
+
+    std::unique_lock<std::mutex> call_lock ( call_mutex );
+
+    {
+      std::lock_guard<std::mutex> lock ( mutex );
+      job = &funct;
+      job_invoke = [] ( void const* context, size_t chunk_begin, size_t chunk_end )
+      {
+        ( *static_cast<FUNCT const*> ( context ) ) ( chunk_begin, chunk_end );
+      };
+      job_end = end;
+      job_chunk = std::max ( chunk_size, size_t{1} );
+      next_index = begin;
+      pending_chunks = ( end - begin + job_chunk - 1 ) / job_chunk;
+      ++generation;
+    }
+
+    work_available.notify_all();
+
+    run_chunks();
+
+    std::unique_lock<std::mutex> lock ( mutex );
+    work_done.wait ( lock, [this]
+    {
+      return pending_chunks == 0;
+    } );
+
+    job = nullptr;
+  }
+
+  static thread_pool_t& get_default_pool()
+  {
+    static thread_pool_t pool;
+    return pool;
+  }
+
+private:
+  // the pool whose chunk the calling thread is running, if any
+  static thread_pool_t const*& current_pool() noexcept
+  {
+    static thread_local thread_pool_t const* pool = nullptr;
+    return pool;
+  }
+
+  void run_chunks()
+  {
+    std::unique_lock<std::mutex> lock ( mutex );
+
+    while ( job && next_index < job_end )
+    {
+      auto const chunk_begin = next_index;
+      auto const chunk_end = std::min ( chunk_begin + job_chunk, job_end );
+      auto const* const context = job;
+      auto const invoke = job_invoke;
+
+      next_index = chunk_end;
+
+      lock.unlock();
+
+      auto* const outer_pool = current_pool();
+      current_pool() = this;
+      invoke ( context, chunk_begin, chunk_end );
+      current_pool() = outer_pool;
+
+      lock.lock();
+
+      if ( --pending_chunks == 0 )
+      {
+        work_done.notify_all();
+      }
+    }
+  }
+
+  void worker_loop()
+  {
+    size_t seen_generation = 0;
+
+    for ( ;; )
+    {
+      {
+        std::unique_lock<std::mutex> lock ( mutex );
+        work_available.wait ( lock, [this, seen_generation]
+        {
+          return stopping || generation != seen_generation;
+        } );
+
+        if ( stopping )
+        {
+          return;
+        }
+
+        seen_generation = generation;
+      }
+
+      run_chunks();
+    }
+  }
+
+private:
+  std::vector<std::thread> workers;
+
+  std::mutex call_mutex;
+  std::mutex mutex;
+  std::condition_variable work_available;
+  std::condition_variable work_done;
+
+  void const* job{};
+  void ( *job_invoke ) ( void const*, size_t, size_t ) {};
+  size_t job_end{};
+  size_t job_chunk{};
+  size_t next_index{};
+  size_t pending_chunks{};
+  size_t generation{};
+  bool stopping{};
+};
+
+}  // namespace thread_pool_utils
@@ -0,0 +1,67 @@
+#include <benchapp/bench_lines.h>
+#include <benchapp/bench_utils.h>
+
+#include <nnet/dynamic_line.h>
+#include <nnet/shape_dispatch.h>
+
+#include <cstdio>
+#include <cmath>
+#include <vector>
+
+namespace
+{
+
+constexpr size_t repeat = 200000;
+
+volatile float g_sink;
+
+// the same runtime shape bound to its compiled kernel and, with an empty shape list, to the generic one
+template<size_t INPUT_DIMENSION, size_t LINE_DIMENSION>
+void bench_shape_dispatch()
+{
+  nnet::arena_t arena ( nnet::dynamic_neuron_line_t<float>::required_bytes ( INPUT_DIMENSION, LINE_DIMENSION ) );
+  nnet::dynamic_neuron_line_t<float> line ( INPUT_DIMENSION, LINE_DIMENSION, arena );
+
+  for ( size_t i = 0; i < INPUT_DIMENSION * LINE_DIMENSION; ++i )
+  {
+    line.koefs_data() [i] = std::sin ( static_cast<float> ( i ) );
+  }
+
+  std::vector<float> input ( INPUT_DIMENSION );
+  std::vector<float> output ( LINE_DIMENSION );
+
+  for ( size_t i = 0; i < INPUT_DIMENSION; ++i )
+  {
+    input[i] = std::cos ( static_cast<float> ( i ) );
+  }
+
+  nnet::dispatched_line_t<float> const specialized ( line );
+  nnet::dispatched_line_t<float, nnet::activation::identity_t, nnet::line_shape_list_t<>> const generic ( line );
+
+  char name[64];
+
+  std::snprintf ( name, sizeof ( name ), "dispatched_line_t %zux%zu, specialized", INPUT_DIMENSION, LINE_DIMENSION );
+  bench_utils::report ( name, bench_utils::measure_ns ( repeat, [&specialized, &input, &output]
+  {
+    specialized.apply ( input.data(), output.data() );
+    g_sink = output[0];
+  } ) );
+
+  std::snprintf ( name, sizeof ( name ), "dispatched_line_t %zux%zu, generic", INPUT_DIMENSION, LINE_DIMENSION );
+  bench_utils::report ( name, bench_utils::measure_ns ( repeat, [&generic, &input, &output]
+  {
+    generic.apply ( input.data(), output.data() );
+    g_sink = output[0];
+  } ) );
+}
+
+} // namespace anonymous
+
+void bench_lines()
+{
+  std::printf ( "lines: one apply of a runtime-shaped line\n" );
+
+  bench_shape_dispatch<16, 16>();
+  bench_shape_dispatch<64, 64>();
+  bench_shape_dispatch<128, 64>();
+}
@@ -0,0 +1,87 @@
+#include <benchapp/bench_numa.h>
+#include <benchapp/bench_utils.h>
+
+#include <nnet/neuron_line.h>
+#include <nnet/numa_line.h>
+#include <utils/numa.h>
+
+#include <cstdio>
+#include <cmath>
+#include <array>
+#include <memory>
+
+namespace
+{
+
+constexpr size_t input_dimension = 1024;
+constexpr size_t line_dimension = 2048;
+constexpr size_t repeat = 200;
+
+using line_t = nnet::neuron_line_t<float, input_dimension, line_dimension>;
+
+template<typename LINE_T>
+void bench_line ( char const* name, LINE_T const& line, line_t::input_array_t const& input, line_t::output_array_t& output )
+{
+  auto const ns = bench_utils::measure_ns ( repeat, [&line, &input, &output]
+  {
+    line.apply ( input.data(), output.data() );
+  } );
+
+  bench_utils::report ( name, ns, "apply" );
+  std::printf ( "  %-48s %14.2f GB/s\n", "", sizeof ( line_t::koef_matrix_t ) / ns );
+}
+
+} // namespace anonymous
+
+// run with NNET_FAKE_NUMA=N to split a single-node box into N nodes
+void bench_numa()
+{
+  auto const topology = numa_utils::numa_topology_t::detect();
+
+  std::printf ( "numa: %zu nodes, %zu cpus, %zu x %zu float line\n",
+                topology.get_node_count(), topology.get_cpu_count(), line_dimension, input_dimension );
+
+  auto line = std::make_unique<line_t>();
+
+  for ( size_t k = 0; k < line_dimension; ++k )
+  {
+    line_t::neuron_t::koef_array_t koefs{};
+
+    for ( size_t i = 0; i < input_dimension; ++i )
+    {
+      koefs[i] = std::sin ( static_cast<float> ( k * input_dimension + i ) );
+    }
+
+    line->set_koefs ( k, koefs );
+  }
+
+  line_t::input_array_t input{};
+
+  for ( size_t i = 0; i < input_dimension; ++i )
+  {
+    input[i] = std::cos ( static_cast<float> ( i ) );
+  }
+
+  auto output = std::make_unique<line_t::output_array_t>();
+
+  bench_line ( "neuron_line_t::apply, default pool", *line, input, *output );
+
+  auto const pool = numa_utils::make_pinned_pool ( topology );
+
+  for ( auto const huge_pages : {false, true} )
+  {
+    nnet::numa_line_t<line_t> numa_line ( *line, *pool, topology, huge_pages );
+
+    if ( !numa_line.is_valid() )
+    {
+      std::printf ( "  the replicas could not be allocated\n" );
+      continue;
+    }
+
+    std::printf ( "  replicas: %zu, node 0 bound: %d, huge pages: %d\n",
+                  numa_line.get_replica_count(), numa_line.is_bound ( 0 ), numa_line.has_huge_pages ( 0 ) );
+
+    bench_line ( huge_pages ? "numa_line_t::apply, pinned, huge pages" : "numa_line_t::apply, pinned",
+                 numa_line, input, *output );
+  }
+}
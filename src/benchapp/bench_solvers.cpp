@@ -0,0 +1,249 @@
+#include <benchapp/bench_solvers.h>
+#include <benchapp/bench_utils.h>
+
+#include <noptim/extreme.h>
+#include <noptim/extreme_batch.h>
+#include <noptim/extreme_global.h>
+#include <noptim/quick_descent.h>
+#include <integ/integral.h>
+#include <diffsolve/diffsolve.h>
+#include <utils/target_functions.h>
+#include <utils/thread_pool.h>
+
+#include <cstdio>
+#include <cmath>
+#include <vector>
+#include <thread>
+#include <algorithm>
+
+namespace
+{
+
+constexpr size_t repeat = 2000;
+
+volatile double g_sink;
+
+void bench_find_minimum()
+{
+  using noptim::find_minimum_method;
+
+  target_function_utils::test_function_parabola_t my_f;
+  noptim::find_minimum_details::target_function_t<double> erased_f = my_f;
+
+  constexpr double const eps = 1e-9;
+
+  noptim::find_minimum_t stat;
+  noptim::find_minimum<find_minimum_method::gold_ratio> ( my_f.xa, my_f.xb, eps, my_f, &stat );
+  auto const evaluations = static_cast<double> ( stat.funct_invocation_count );
+
+  bench_utils::report ( "find_minimum, gold_ratio, functor", bench_utils::measure_ns ( repeat, [&my_f]
+  {
+    g_sink = noptim::find_minimum<find_minimum_method::gold_ratio> ( my_f.xa, my_f.xb, eps, my_f );
+  } ) / evaluations, "eval" );
+
+  bench_utils::report ( "find_minimum, gold_ratio, std::function", bench_utils::measure_ns ( repeat, [&my_f, &erased_f]
+  {
+    g_sink = noptim::find_minimum<find_minimum_method::gold_ratio> ( my_f.xa, my_f.xb, eps, erased_f );
+  } ) / evaluations, "eval" );
+}
+
+// many parabolas with their own roots, scalar one after another and in lockstep lanes
+void bench_find_minimum_batch()
+{
+  using noptim::find_minimum_method;
+
+  constexpr size_t count = 4096;
+  constexpr double const eps = 1e-6;
+
+  std::vector<double> xa ( count );
+  std::vector<double> xb ( count );
+  std::vector<double> roots ( count );
+  std::vector<double> x_min ( count );
+
+  for ( size_t p = 0; p < count; ++p )
+  {
+    roots[p] = std::sin ( static_cast<double> ( p ) );
+    xa[p] = roots[p] - 2.0;
+    xb[p] = roots[p] + 3.0;
+  }
+
+  auto const batch_funct = [&roots] ( double const * x, double * f, size_t first, size_t lanes )
+  {
+    for ( size_t l = 0; l < lanes; ++l )
+    {
+      auto const d = x[l] - roots[first + l];
+      f[l] = 3.0 * d * d + 1.0;
+    }
+  };
+
+  bench_utils::report ( "find_minimum, gold_ratio, scalar", bench_utils::measure_ns ( repeat / 100, [&]
+  {
+    for ( size_t p = 0; p < count; ++p )
+    {
+      x_min[p] = noptim::find_minimum<find_minimum_method::gold_ratio> ( xa[p], xb[p], eps, [&roots, p] ( double x )
+      {
+        auto const d = x - roots[p];
+        return 3.0 * d * d + 1.0;
+      } );
+    }
+  } ) / count, "problem" );
+
+  bench_utils::report ( "find_minimum_batch, gold_ratio", bench_utils::measure_ns ( repeat / 100, [&]
+  {
+    noptim::find_minimum_batch<find_minimum_method::gold_ratio> ( xa.data(), xb.data(), eps, count, batch_funct,
+        x_min.data() );
+  } ) / count, "problem" );
+
+  g_sink = x_min[count / 2];
+}
+
+// a wavy target made expensive on purpose, the wall-clock time should drop with the threads
+void bench_find_global_minimum()
+{
+  using noptim::find_minimum_method;
+
+  auto const funct = [] ( double x )
+  {
+    double result = 0.1 * x * x;
+
+    for ( int k = 1; k <= 64; ++k )
+    {
+      result += std::sin ( k * x ) / ( k * k );
+    }
+
+    return result;
+  };
+
+  auto const hardware_threads = std::max ( std::thread::hardware_concurrency(), 1u );
+
+  for ( size_t thread_count = 1; ; thread_count = std::min<size_t> ( 2 * thread_count, hardware_threads ) )
+  {
+    thread_pool_utils::thread_pool_t pool ( thread_count );
+
+    char name[64];
+    std::snprintf ( name, sizeof ( name ), "find_global_minimum, brent, %zu threads", thread_count );
+
+    bench_utils::report ( name, bench_utils::measure_ns ( repeat / 100, [&funct, &pool]
+    {
+      g_sink = noptim::find_global_minimum<find_minimum_method::brent> ( -10.0, 10.0, 1e-9, 4096, 16, funct, pool ).x;
+    } ) );
+
+    if ( thread_count == hardware_threads )
+    {
+      break;
+    }
+  }
+}
+
+void bench_quick_descent()
+{
+  using noptim::find_minimum_method;
+  using funct_args_t = tuple_utils::funct_args_t<double, double>;
+
+  target_function_utils::test_function_parabola_t my_f;
+
+  funct_args_t const min_point = {my_f.xa, my_f.ya};
+  funct_args_t const max_point = {my_f.xb, my_f.yb};
+
+  noptim::quick_descent<find_minimum_method::gold_ratio, double, double, double> erased_qd ( my_f.h, my_f.eps,
+      min_point, max_point, my_f );
+  auto const typed_qd = noptim::make_quick_descent<find_minimum_method::gold_ratio> ( my_f.h, my_f.eps,
+                        min_point, max_point, my_f );
+
+  noptim::find_minimum_t stat;
+  typed_qd.find_minimum ( &stat );
+  auto const evaluations = static_cast<double> ( stat.funct_invocation_count );
+
+  bench_utils::report ( "quick_descent, make_quick_descent", bench_utils::measure_ns ( repeat, [&typed_qd]
+  {
+    g_sink = std::get<0> ( typed_qd.find_minimum() );
+  } ) / evaluations, "eval" );
+
+  bench_utils::report ( "quick_descent, std::function", bench_utils::measure_ns ( repeat, [&erased_qd]
+  {
+    g_sink = std::get<0> ( erased_qd.find_minimum() );
+  } ) / evaluations, "eval" );
+}
+
+void bench_integral()
+{
+  using integral::integral_method;
+
+  static constexpr double const step = 1e-4;
+  static constexpr double const from = 0.0;
+  static constexpr double const to = 1.0;
+
+  auto const my_funct = [] ( double t )
+  {
+    return 3.0 * t * t + 1.0;
+  };
+
+  integral::integral<integral_method::trapezoid, double, double> erased_integr ( step, my_funct );
+  auto typed_integr = integral::make_integral<integral_method::trapezoid, double> ( step, my_funct );
+
+  auto const evaluations = std::floor ( ( to - from ) / step ) + 2.0;
+
+  bench_utils::report ( "integral, make_integral", bench_utils::measure_ns ( repeat / 10, [&typed_integr]
+  {
+    g_sink = typed_integr.from_to ( from, to );
+  } ) / evaluations, "eval" );
+
+  bench_utils::report ( "integral, std::function", bench_utils::measure_ns ( repeat / 10, [&erased_integr]
+  {
+    g_sink = erased_integr.from_to ( from, to );
+  } ) / evaluations, "eval" );
+}
+
+void bench_diffsolve()
+{
+  using diffsolve::diffsolve_method;
+  using funct_args_t = tuple_utils::funct_args_t<double, double>;
+
+  static constexpr double const step = 1e-4;
+  static constexpr double const t1 = 1.0;
+  constexpr double const w = 3.0;
+
+  funct_args_t const y0{0.0, w};
+
+  auto const my_f1 = [] ( double, funct_args_t const & x )
+  {
+    return std::get<1> ( x );
+  };
+
+  auto const my_f2 = [] ( double, funct_args_t const & x )
+  {
+    return -w * w * std::get<0> ( x );
+  };
+
+  using erased_diffsolve_t = diffsolve::diffsolve<diffsolve_method::runge_kutta_4th, 2, double, double, double>;
+
+  erased_diffsolve_t const erased_ds ( step, y0, erased_diffsolve_t::target_function_array_t{my_f1, my_f2} );
+  auto const typed_ds = diffsolve::make_diffsolve<diffsolve_method::runge_kutta_4th> ( step, y0, my_f1, my_f2 );
+
+  // 4 stages for each of the 2 equations per step
+  auto const evaluations = std::ceil ( t1 / step ) * 8.0;
+
+  bench_utils::report ( "diffsolve, runge_kutta_4th, make_diffsolve", bench_utils::measure_ns ( repeat / 100, [&typed_ds, &y0]
+  {
+    g_sink = std::get<0> ( typed_ds.from_too ( 0.0, t1, y0 ) );
+  } ) / evaluations, "eval" );
+
+  bench_utils::report ( "diffsolve, runge_kutta_4th, std::function", bench_utils::measure_ns ( repeat / 100, [&erased_ds, &y0]
+  {
+    g_sink = std::get<0> ( erased_ds.from_too ( 0.0, t1, y0 ) );
+  } ) / evaluations, "eval" );
+}
+
+} // namespace anonymous
+
+void bench_solvers()
+{
+  std::printf ( "solvers: the cost of one target function evaluation\n" );
+
+  bench_find_minimum();
+  bench_find_minimum_batch();
+  bench_find_global_minimum();
+  bench_quick_descent();
+  bench_integral();
+  bench_diffsolve();
+}
@@ -0,0 +1,14 @@
+#include <benchapp/bench_numa.h>
+#include <benchapp/bench_solvers.h>
+#include <benchapp/bench_lines.h>
+
+int main ( [[maybe_unused]]int argc, [[maybe_unused]]char* argv[] )
+{
+  bench_numa();
+
+  bench_solvers();
+
+  bench_lines();
+
+  return 0;
+}
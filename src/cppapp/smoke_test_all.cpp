@@ -1,6 +1,17 @@
 #include <cppapp/smoke_test_all.h>
 
 #include <cppapp/smoke_test_neuron.h>
+#include <cppapp/smoke_test_simd.h>
+#include <cppapp/smoke_test_neuron_network.h>
+#include <cppapp/smoke_test_conv1d.h>
+#include <cppapp/smoke_test_recurrent.h>
+#include <cppapp/smoke_test_trainer.h>
+#include <cppapp/smoke_test_metrics.h>
+#include <cppapp/smoke_test_dynamic_line.h>
+#include <cppapp/smoke_test_model_file.h>
+#include <cppapp/smoke_test_inference_pipeline.h>
+#include <cppapp/smoke_test_thread_pool.h>
+#include <cppapp/smoke_test_numa.h>
 #include <cppapp/smoke_test_find_minimum.h>
 #include <cppapp/smoke_test_quick_descent.h>
 #include <cppapp/smoke_test_diffsolve.h>
@@ -8,8 +19,30 @@
 
 void test_all_the_components()
 {
+  test_simd();
+
   test_neuron();
 
+  test_neuron_network();
+
+  test_conv1d();
+
+  test_recurrent();
+
+  test_trainer();
+
+  test_metrics();
+
+  test_dynamic_line();
+
+  test_model_file();
+
+  test_inference_pipeline();
+
+  test_thread_pool();
+
+  test_numa();
+
   test_find_minimum();
 
   test_quick_descent();
@@ -0,0 +1,141 @@
+#include <cppapp/smoke_test_conv1d.h>
+
+#include <nnet/conv1d_line.h>
+#include <nnet/neuron_line.h>
+
+#include <cassert>
+#include <algorithm>
+#include <array>
+#include <vector>
+
+namespace
+{
+
+template<typename CONV_T>
+void set_test_koefs ( CONV_T& conv )
+{
+  for ( size_t o = 0; o < CONV_T::output_channels; ++o )
+  {
+    typename CONV_T::koef_array_t koefs{};
+
+    for ( size_t j = 0; j < CONV_T::window_size; ++j )
+    {
+      koefs[j] = static_cast<int> ( ( o * 5 + j * 3 ) % 7 ) - 3;
+    }
+
+    conv.set_koefs ( o, koefs );
+  }
+}
+
+template<size_t KERNEL_WIDTH, size_t STRIDE>
+void smoke_test_conv1d_X()
+{
+  constexpr size_t input_channels = 3;
+  constexpr size_t output_channels = 2;
+  constexpr size_t length = 17;
+
+  using my_conv_t = nnet::conv1d_line_t<int, input_channels, output_channels, KERNEL_WIDTH, STRIDE, nnet::activation::relu_t>;
+
+  my_conv_t conv;
+  set_test_koefs ( conv );
+
+  std::vector<int> input ( length * input_channels );
+
+  for ( size_t i = 0; i < input.size(); ++i )
+  {
+    input[i] = static_cast<int> ( i * 7 % 11 ) - 5;
+  }
+
+  constexpr size_t positions = my_conv_t::output_length ( length );
+
+  static_assert ( positions == ( length - KERNEL_WIDTH ) / STRIDE + 1 );
+
+  std::vector<int> output ( positions * output_channels );
+
+  conv.apply ( input.data(), length, output.data() );
+
+  // the textbook convolution
+  for ( size_t p = 0; p < positions; ++p )
+  {
+    for ( size_t o = 0; o < output_channels; ++o )
+    {
+      int sum = 0;
+
+      for ( size_t k = 0; k < KERNEL_WIDTH; ++k )
+      {
+        for ( size_t c = 0; c < input_channels; ++c )
+        {
+          sum += conv.koefs_data() [o * my_conv_t::window_size + k * input_channels + c]
+                 * input[ ( p * STRIDE + k ) * input_channels + c];
+        }
+      }
+
+      assert ( nnet::activation::relu_t::apply ( sum ) == output[p * output_channels + o] );
+    }
+  }
+
+  // the stream yields the same outputs one sample at a time, twice to check the reset
+  typename my_conv_t::stream_context_t context;
+
+  for ( int pass = 0; pass < 2; ++pass )
+  {
+    context.reset();
+
+    size_t p = 0;
+
+    for ( size_t t = 0; t < length; ++t )
+    {
+      if ( conv.push ( input.data() + t * input_channels, context ) )
+      {
+        assert ( t == p * STRIDE + KERNEL_WIDTH - 1 );
+        assert ( std::equal ( context.get_value().cbegin(), context.get_value().cend(),
+                              output.cbegin() + p * output_channels ) );
+        ++p;
+      }
+    }
+
+    assert ( positions == p );
+  }
+}
+
+void smoke_test_conv1d_window()
+{
+  // a single window is a neuron line over the flattened [time][channel] window
+  using my_conv_t = nnet::conv1d_line_t<int, 2, 3, 4>;
+  using my_neuron_line_t = nnet::neuron_line_t<int, my_conv_t::window_size, 3>;
+
+  my_conv_t conv;
+  my_neuron_line_t neuron_line;
+
+  set_test_koefs ( conv );
+
+  for ( size_t o = 0; o < 3; ++o )
+  {
+    typename my_neuron_line_t::neuron_t::koef_array_t koefs{};
+    std::copy ( conv.koefs_data() + o * my_conv_t::window_size, conv.koefs_data() + ( o + 1 ) * my_conv_t::window_size,
+                koefs.begin() );
+
+    neuron_line.set_koefs ( o, koefs );
+  }
+
+  constexpr my_neuron_line_t::input_array_t const window = {1, -1, 2, 0, 3, 1, -2, 4};
+
+  my_conv_t::output_array_t output{};
+
+  conv.apply ( window.data(), 4, output.data() );
+  neuron_line.apply ( window );
+
+  assert ( neuron_line.get_value() == output );
+}
+
+} // namespace anonymous
+
+void test_conv1d()
+{
+  smoke_test_conv1d_X<3, 1>();
+  smoke_test_conv1d_X<4, 2>();
+  smoke_test_conv1d_X<3, 3>();
+  smoke_test_conv1d_X<2, 3>();
+
+  smoke_test_conv1d_window();
+}
@@ -69,6 +69,14 @@ void smoke_test_X_rank_1 ( ARG_TYPE h_in, ARG_TYPE eps_in )
   my_funct_args_t const expected_end_value = { A * exp ( a * t1 ) };
 
   assert ( fabs ( tuple_utils::get_normus<my_funct_ret_t> ( end_value, expected_end_value ) ) < eps );
+
+  // the same system with the lambda in a std::tuple
+  auto const typed_ds = diffsolve::make_diffsolve<METHOD_ENUM> ( h, y0, my_f );
+
+  static_assert ( decltype ( typed_ds ) ::system_rank == system_rank, "One right-hand side per equation" );
+
+  assert ( typed_ds.evaluate_gradient ( t0, y0 ) == gradient_value );
+  assert ( typed_ds.from_too ( t0, t1, y0 ) == end_value );
 }
 
 template<diffsolve::diffsolve_method METHOD_ENUM, typename ARG_TYPE>
@@ -0,0 +1,276 @@
+#include <cppapp/smoke_test_dynamic_line.h>
+
+#include <nnet/arena.h>
+#include <nnet/dynamic_line.h>
+#include <nnet/shape_dispatch.h>
+#include <nnet/neuron_line.h>
+#include <nnet/neuron_network.h>
+
+#include <cassert>
+#include <cstdint>
+#include <cmath>
+#include <array>
+
+namespace
+{
+
+template<typename LINE_T>
+void set_test_koefs ( LINE_T& line, nnet::dynamic_neuron_line_t<double>& dynamic_line, size_t const seed )
+{
+  for ( size_t i = 0; i < LINE_T::line_dimension; ++i )
+  {
+    typename LINE_T::neuron_t::koef_array_t koefs{};
+
+    for ( size_t j = 0; j < LINE_T::input_dimension; ++j )
+    {
+      koefs[j] = 0.25 * ( static_cast<double> ( ( i * 3 + j * 5 + seed ) % 9 ) - 4.0 );
+    }
+
+    line.set_koefs ( i, koefs );
+    dynamic_line.set_koefs ( i, koefs.data() );
+  }
+}
+
+void smoke_test_arena()
+{
+  nnet::arena_t arena ( 100 );
+
+  assert ( 128 == arena.get_capacity() );
+
+  auto* const a = arena.allocate<double> ( 3 );
+  auto* const b = arena.allocate<char> ( 1 );
+
+  assert ( a && b );
+  assert ( reinterpret_cast<uintptr_t> ( a ) % nnet::arena_t::alignment == 0 );
+  assert ( reinterpret_cast<uintptr_t> ( b ) % nnet::arena_t::alignment == 0 );
+  assert ( 0.0 == a[0] && 0 == b[0] );
+  assert ( nullptr == arena.allocate<char> ( 1 ) );
+
+  arena.reset();
+
+  assert ( 0 == arena.get_used() );
+  assert ( arena.allocate<char> ( 128 ) );
+}
+
+void smoke_test_dynamic_network()
+{
+  using my_line_1_t = nnet::neuron_line_t<double, 4, 6, nnet::line_layout::row_major, nnet::activation::tanh_t>;
+  using my_line_2_t = nnet::neuron_line_t<double, 6, 5, nnet::line_layout::row_major, nnet::activation::tanh_t>;
+  using my_line_3_t = nnet::neuron_line_t<double, 5, 2>;
+  using my_network_t = nnet::neuron_network_t<my_line_1_t, my_line_2_t, my_line_3_t>;
+  using my_dynamic_network_t = nnet::dynamic_network_t<double, nnet::activation::tanh_t, nnet::activation::identity_t>;
+
+  // the shape is known only at run time
+  std::array<size_t, 4> const dimensions = {4, 6, 5, 2};
+
+  auto const required_bytes = my_dynamic_network_t::required_bytes ( dimensions.data(), dimensions.size() );
+
+  nnet::arena_t arena ( required_bytes );
+
+  my_dynamic_network_t dynamic_network ( arena, dimensions.data(), dimensions.size() );
+
+  assert ( dynamic_network.is_valid() );
+  assert ( 3 == dynamic_network.get_line_count() );
+  assert ( 2 == dynamic_network.size() );
+  assert ( arena.get_used() == arena.get_capacity() );
+
+  my_network_t network;
+
+  set_test_koefs ( network.get_line<0>(), dynamic_network.get_line ( 0 ), 1 );
+  set_test_koefs ( network.get_line<1>(), dynamic_network.get_line ( 1 ), 2 );
+  set_test_koefs ( network.get_line<2>(), dynamic_network.get_line ( 2 ), 3 );
+
+  constexpr my_network_t::input_array_t const inputs = {0.5, -1.0, 0.25, 2.0};
+
+  network.apply ( inputs );
+  dynamic_network.apply ( inputs.data() );
+
+  for ( size_t i = 0; i < dynamic_network.size(); ++i )
+  {
+    assert ( network.get_value() [i] == dynamic_network.get_value() [i] );
+  }
+
+  // an undersized arena is reported instead of overflowing
+  nnet::arena_t small_arena ( required_bytes / 2 );
+
+  my_dynamic_network_t invalid_network ( small_arena, dimensions.data(), dimensions.size() );
+
+  assert ( !invalid_network.is_valid() );
+  assert ( 0 == invalid_network.size() );
+
+  invalid_network.apply ( inputs.data() );
+
+  assert ( nullptr == invalid_network.get_value() );
+
+  // a single dimension gives no lines at all
+  my_dynamic_network_t empty_network ( arena, dimensions.data(), 1 );
+
+  assert ( !empty_network.is_valid() );
+  assert ( 0 == empty_network.get_line_count() );
+  assert ( 0 == empty_network.size() );
+
+  empty_network.apply ( inputs.data() );
+}
+
+void smoke_test_dynamic_line()
+{
+  nnet::arena_t arena ( nnet::dynamic_neuron_line_t<int>::required_bytes ( 3, 2 ) );
+
+  nnet::dynamic_neuron_line_t<int> line ( 3, 2, arena );
+
+  std::array<int, 3> const koefs = {1, 2, 3};
+  std::array<int, 3> const inputs = {1, 1, -1};
+
+  line.set_koefs ( 0, koefs.data() );
+  line.set_koefs ( 1, koefs.data() );
+
+  line.apply<nnet::activation::relu_t> ( inputs.data() );
+
+  assert ( line.is_valid() );
+  assert ( 0 == line.get_value() [0] && 0 == line.get_value() [1] );
+
+  line.apply ( inputs.data() );
+
+  assert ( 0 == line.get_value() [0] );
+}
+
+template<size_t INPUT_DIMENSION, size_t LINE_DIMENSION, typename SHAPE_LIST = nnet::default_line_shapes>
+nnet::dispatch_path smoke_test_dispatched_line_X()
+{
+  using my_neuron_line_t =
+    nnet::neuron_line_t<int, INPUT_DIMENSION, LINE_DIMENSION, nnet::line_layout::row_major, nnet::activation::relu_t>;
+  using my_dispatched_line_t = nnet::dispatched_line_t<int, nnet::activation::relu_t, SHAPE_LIST>;
+
+  // the shape is known only at run time
+  nnet::arena_t arena ( nnet::dynamic_neuron_line_t<int>::required_bytes ( INPUT_DIMENSION, LINE_DIMENSION ) );
+  nnet::dynamic_neuron_line_t<int> dynamic_line ( INPUT_DIMENSION, LINE_DIMENSION, arena );
+
+  my_neuron_line_t neuron_line;
+
+  for ( size_t i = 0; i < LINE_DIMENSION; ++i )
+  {
+    typename my_neuron_line_t::neuron_t::koef_array_t koefs{};
+
+    for ( size_t j = 0; j < INPUT_DIMENSION; ++j )
+    {
+      koefs[j] = static_cast<int> ( ( i * 3 + j * 5 ) % 9 ) - 4;
+    }
+
+    neuron_line.set_koefs ( i, koefs );
+    dynamic_line.set_koefs ( i, koefs.data() );
+  }
+
+  typename my_neuron_line_t::input_array_t input{};
+
+  for ( size_t j = 0; j < INPUT_DIMENSION; ++j )
+  {
+    input[j] = static_cast<int> ( j % 7 ) - 3;
+  }
+
+  my_dispatched_line_t const dispatched_line ( dynamic_line );
+
+  assert ( INPUT_DIMENSION == dispatched_line.get_input_dimension() );
+  assert ( LINE_DIMENSION == dispatched_line.size() );
+
+  typename my_neuron_line_t::output_array_t output{};
+
+  dispatched_line.apply ( input.data(), output.data() );
+  neuron_line.apply ( input );
+
+  assert ( neuron_line.get_value() == output );
+
+  return dispatched_line.get_path();
+}
+
+// the blocked kernels sum in another order than the generic one, the outputs agree up to rounding
+template<typename T, size_t INPUT_DIMENSION, size_t LINE_DIMENSION>
+void smoke_test_dispatched_line_float_X()
+{
+  using my_shapes = nnet::line_shape_list_t<nnet::line_shape_t<INPUT_DIMENSION, LINE_DIMENSION>>;
+
+  nnet::arena_t arena ( nnet::dynamic_neuron_line_t<T>::required_bytes ( INPUT_DIMENSION, LINE_DIMENSION ) );
+  nnet::dynamic_neuron_line_t<T> dynamic_line ( INPUT_DIMENSION, LINE_DIMENSION, arena );
+
+  for ( size_t i = 0; i < INPUT_DIMENSION * LINE_DIMENSION; ++i )
+  {
+    dynamic_line.koefs_data() [i] = std::sin ( static_cast<T> ( i ) );
+  }
+
+  std::array<T, INPUT_DIMENSION> input{};
+
+  for ( size_t j = 0; j < INPUT_DIMENSION; ++j )
+  {
+    input[j] = std::cos ( static_cast<T> ( j ) );
+  }
+
+  nnet::dispatched_line_t<T, nnet::activation::tanh_t, my_shapes> const specialized ( dynamic_line );
+  nnet::dispatched_line_t<T, nnet::activation::tanh_t, nnet::line_shape_list_t<>> const generic ( dynamic_line );
+
+  assert ( nnet::dispatch_path::specialized == specialized.get_path() );
+  assert ( nnet::dispatch_path::generic == generic.get_path() );
+
+  std::array<T, LINE_DIMENSION> specialized_output{};
+  std::array<T, LINE_DIMENSION> generic_output{};
+
+  specialized.apply ( input.data(), specialized_output.data() );
+  generic.apply ( input.data(), generic_output.data() );
+
+  for ( size_t k = 0; k < LINE_DIMENSION; ++k )
+  {
+    assert ( std::fabs ( specialized_output[k] - generic_output[k] ) < T ( 1e-4 ) );
+  }
+
+  // the kernels of the lower instruction sets the cpu runs as well
+  for ( auto const instruction_set : {nnet::simd::isa::scalar, nnet::simd::isa::sse2, nnet::simd::isa::avx2} )
+  {
+    if ( instruction_set > nnet::simd::get_isa() )
+    {
+      continue;
+    }
+
+    auto const kernel = nnet::shape_dispatch_details::find_kernel<T, nnet::activation::tanh_t, my_shapes> (
+                          instruction_set, INPUT_DIMENSION, LINE_DIMENSION );
+
+    assert ( kernel );
+
+    kernel ( dynamic_line.koefs_data(), input.data(), specialized_output.data(), INPUT_DIMENSION, LINE_DIMENSION );
+
+    for ( size_t k = 0; k < LINE_DIMENSION; ++k )
+    {
+      assert ( std::fabs ( specialized_output[k] - generic_output[k] ) < T ( 1e-4 ) );
+    }
+  }
+}
+
+void smoke_test_dispatched_line()
+{
+  assert ( nnet::dispatch_path::specialized == ( smoke_test_dispatched_line_X<8, 8>() ) );
+  assert ( nnet::dispatch_path::specialized == ( smoke_test_dispatched_line_X<128, 64>() ) );
+  assert ( nnet::dispatch_path::generic == ( smoke_test_dispatched_line_X<7, 5>() ) );
+
+  // the caller's own shapes
+  using my_shapes = nnet::line_shape_list_t<nnet::line_shape_t<7, 5>>;
+
+  assert ( nnet::dispatch_path::specialized == ( smoke_test_dispatched_line_X<7, 5, my_shapes>() ) );
+  assert ( nnet::dispatch_path::generic == ( smoke_test_dispatched_line_X<8, 8, my_shapes>() ) );
+
+  // whole blocks of rows and vectors, a row tail, leftover rows and a line shorter than a vector
+  smoke_test_dispatched_line_float_X<float, 64, 16>();
+  smoke_test_dispatched_line_float_X<float, 21, 7>();
+  smoke_test_dispatched_line_float_X<float, 5, 3>();
+  smoke_test_dispatched_line_float_X<double, 64, 16>();
+  smoke_test_dispatched_line_float_X<double, 13, 6>();
+}
+
+} // namespace anonymous
+
+void test_dynamic_line()
+{
+  smoke_test_arena();
+
+  smoke_test_dynamic_line();
+
+  smoke_test_dynamic_network();
+
+  smoke_test_dispatched_line();
+}
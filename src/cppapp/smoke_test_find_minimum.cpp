@@ -1,12 +1,19 @@
 #include <cppapp/smoke_test_find_minimum.h>
 
 #include <noptim/extreme.h>
+#include <noptim/extreme_batch.h>
+#include <noptim/extreme_global.h>
 
+#include <nnet/neuron_line.h>
+
+#include <utils/thread_pool.h>
 #include <utils/tuple_utils.h>
 #include <utils/target_functions.h>
 
 #include <cassert>
 #include <cmath>
+#include <vector>
+#include <memory>
 
 namespace
 {
@@ -47,6 +54,249 @@ void smoke_test_find_minimum_gold_ratio()
   smoke_test_find_minimum_X<noptim::find_minimum_method::gold_ratio> ( 14, 17 );
 }
 
+void smoke_test_find_minimum_brent()
+{
+  smoke_test_find_minimum_X<noptim::find_minimum_method::brent> ( 6, 8 );
+
+  // a tight tolerance costs a few parabolic steps more, the golden section needs 33 calls here
+  target_function_utils::test_function_qubic_t my_f;
+  constexpr double const eps = 1e-6;
+
+  noptim::find_minimum_t stat;
+  auto const x_min = noptim::find_minimum<noptim::find_minimum_method::brent> ( my_f.xa, my_f.xb, eps, my_f, &stat );
+
+  assert ( fabs ( x_min - my_f.expected_x_min ) <= eps );
+  assert ( 11 == stat.funct_invocation_count );
+}
+
+// a lambda, a functor and the std::function adapter take the same path
+template<noptim::find_minimum_method METHOD_ENUM>
+void smoke_test_find_minimum_callable()
+{
+  target_function_utils::test_function_parabola_t my_f;
+  noptim::find_minimum_details::target_function_t<double> erased_f = my_f;
+
+  noptim::find_minimum_t functor_stat;
+  noptim::find_minimum_t erased_stat;
+  noptim::find_minimum_t lambda_stat;
+
+  auto const functor_x_min = noptim::find_minimum<METHOD_ENUM> ( my_f.xa, my_f.xb, my_f.eps, my_f, &functor_stat );
+  auto const erased_x_min = noptim::find_minimum<METHOD_ENUM> ( my_f.xa, my_f.xb, my_f.eps, erased_f, &erased_stat );
+  auto const lambda_x_min = noptim::find_minimum<METHOD_ENUM> ( my_f.xa, my_f.xb, my_f.eps, [&my_f] ( double x )
+  {
+    return my_f ( x );
+  }, &lambda_stat );
+
+  assert ( functor_x_min == erased_x_min );
+  assert ( functor_x_min == lambda_x_min );
+  assert ( functor_stat.funct_invocation_count == erased_stat.funct_invocation_count );
+  assert ( functor_stat.funct_invocation_count == lambda_stat.funct_invocation_count );
+}
+
+// parabolas with their own roots and brackets, the count is not a multiple of the lanes;
+// every kernel the cpu runs is checked, find_minimum_batch picks one of them
+template<noptim::find_minimum_method METHOD_ENUM, typename T, nnet::simd::isa ISA>
+void smoke_test_find_minimum_batch_X()
+{
+  if ( ISA > nnet::simd::get_isa() )
+  {
+    return;
+  }
+
+  constexpr size_t count = 37;
+  constexpr T eps = T ( 0.001 );
+
+  std::vector<T> xa ( count );
+  std::vector<T> xb ( count );
+  std::vector<T> roots ( count );
+  std::vector<T> scales ( count );
+
+  for ( size_t p = 0; p < count; ++p )
+  {
+    roots[p] = T ( 0.37 ) * static_cast<T> ( p ) - T ( 3 );
+    scales[p] = T ( 1 ) + static_cast<T> ( p % 5 );
+    xa[p] = roots[p] - T ( 1 ) - static_cast<T> ( p % 3 );
+    xb[p] = roots[p] + T ( 2 ) + static_cast<T> ( p % 7 ) / T ( 4 );
+  }
+
+  auto batch_funct = [&roots, &scales] ( T const * x, T * f, size_t first, size_t lanes )
+  {
+    for ( size_t l = 0; l < lanes; ++l )
+    {
+      auto const d = x[l] - roots[first + l];
+      f[l] = scales[first + l] * d * d + T ( 1 );
+    }
+  };
+
+  std::vector<T> x_min ( count );
+  std::vector<noptim::find_minimum_t> stat ( count );
+
+  noptim::find_minimum_batch_details::find_minimum_batch_traits<T, ISA>::template method<METHOD_ENUM> (
+    xa.data(), xb.data(), eps, count, batch_funct, x_min.data(), stat.data() );
+
+  for ( size_t p = 0; p < count; ++p )
+  {
+    auto funct = [&roots, &scales, p] ( T x )
+    {
+      auto const d = x - roots[p];
+      return scales[p] * d * d + T ( 1 );
+    };
+
+    noptim::find_minimum_t single_stat;
+    auto const single_x_min = noptim::find_minimum<METHOD_ENUM> ( xa[p], xb[p], eps, funct, &single_stat );
+
+    assert ( fabs ( x_min[p] - roots[p] ) <= eps );
+    assert ( stat[p].funct_invocation_count > 0 );
+
+    // the double lanes repeat the scalar steps exactly
+    if constexpr ( std::is_same<T, double>::value )
+    {
+      assert ( x_min[p] == single_x_min );
+      assert ( stat[p].funct_invocation_count == single_stat.funct_invocation_count );
+    }
+  }
+}
+
+template<noptim::find_minimum_method METHOD_ENUM, typename T>
+void smoke_test_find_minimum_batch()
+{
+  smoke_test_find_minimum_batch_X<METHOD_ENUM, T, nnet::simd::isa::scalar>();
+  smoke_test_find_minimum_batch_X<METHOD_ENUM, T, nnet::simd::isa::avx2>();
+  smoke_test_find_minimum_batch_X<METHOD_ENUM, T, nnet::simd::isa::avx512>();
+
+  // the public entry on the detected cpu
+  T const xa[] = { T ( -1 ), T ( 0 ) };
+  T const xb[] = { T ( 3 ), T ( 5 ) };
+  T x_min[2] = {};
+
+  noptim::find_minimum_batch<METHOD_ENUM> ( xa, xb, T ( 0.001 ), 2, [] ( T const * x, T * f, size_t first, size_t lanes )
+  {
+    for ( size_t l = 0; l < lanes; ++l )
+    {
+      auto const d = x[l] - static_cast<T> ( first + l ) - T ( 1 );
+      f[l] = d * d;
+    }
+  }, x_min );
+
+  assert ( fabs ( x_min[0] - T ( 1 ) ) <= T ( 0.001 ) );
+  assert ( fabs ( x_min[1] - T ( 2 ) ) <= T ( 0.001 ) );
+}
+
+// a double well tilted to the left, the right well is a local minimum only;
+// the functor counts its own calls, so every task has to run its own copy
+template<noptim::find_minimum_method METHOD_ENUM>
+void smoke_test_find_global_minimum()
+{
+  struct double_well_t
+  {
+    double operator() ( double x )
+    {
+      ++call_count;
+      return ( x * x - 1.0 ) * ( x * x - 1.0 ) + 0.3 * x;
+    }
+
+    size_t call_count{};
+  };
+
+  constexpr double eps = 1e-6;
+
+  thread_pool_utils::thread_pool_t pool ( 3 );
+  noptim::find_minimum_t stat;
+
+  auto const result = noptim::find_global_minimum<METHOD_ENUM> ( -2.0, 2.0, eps, 41, 4, double_well_t{}, pool, &stat );
+
+  assert ( result.is_valid() );
+  assert ( result.local_minima.size() == 2 );
+  assert ( result.x == result.local_minima[0].x );
+  assert ( result.value <= result.local_minima[1].value );
+  assert ( stat.funct_invocation_count > 41 + 2 );
+
+  // the stationary points solve 4 x ( x * x - 1 ) + 0.3 = 0
+  auto const slope = [] ( double x )
+  {
+    return 4.0 * x * ( x * x - 1.0 ) + 0.3;
+  };
+
+  assert ( result.x < 0.0 );
+  assert ( fabs ( slope ( result.x ) ) < 1e-3 );
+  assert ( result.local_minima[1].x > 0.0 );
+  assert ( fabs ( slope ( result.local_minima[1].x ) ) < 1e-3 );
+
+  // a single refinement keeps the best grid minimum only
+  auto const best_only = noptim::find_global_minimum<METHOD_ENUM> ( -2.0, 2.0, eps, 41, 1, double_well_t{}, pool );
+
+  assert ( best_only.local_minima.size() == 1 );
+  assert ( fabs ( best_only.x - result.x ) <= eps );
+
+  // an empty bracket has no minimum
+  assert ( !noptim::find_global_minimum<METHOD_ENUM> ( 1.0, 1.0, eps, 41, 4, double_well_t{}, pool ).is_valid() );
+
+  // the NaN grid points are higher than any number, a funct with NaN only has no minimum
+  auto const nan_left = [] ( double x )
+  {
+    return ( x < 0.1 ) ? std::nan ( "" ) : x;
+  };
+
+  auto const right_of_nan = noptim::find_global_minimum<METHOD_ENUM> ( 0.0, 1.0, eps, 3, 4, nan_left, pool );
+
+  assert ( right_of_nan.is_valid() );
+  assert ( right_of_nan.x >= 0.1 && right_of_nan.x <= 0.5 );
+  assert ( !std::isnan ( right_of_nan.value ) );
+
+  noptim::find_minimum_t nan_stat;
+
+  assert ( !noptim::find_global_minimum<METHOD_ENUM> ( 0.0, 1.0, eps, 3, 4, [] ( double )
+  {
+    return std::nan ( "" );
+  }, pool, &nan_stat ).is_valid() );
+  assert ( nan_stat.funct_invocation_count == 3 );
+}
+
+// the target runs a wide line, which splits itself across the default pool from inside the chunks
+void smoke_test_find_global_minimum_wide_line()
+{
+  constexpr size_t input_dimension = 1024;
+  constexpr size_t line_dimension = 256;
+
+  using my_neuron_line_t = nnet::neuron_line_t<float, input_dimension, line_dimension>;
+
+  static_assert ( input_dimension * line_dimension >= nnet::neuron_line_details::parallel_threshold );
+
+  auto const neuron_line = std::make_shared<my_neuron_line_t>();
+
+  for ( size_t i = 0; i < line_dimension; ++i )
+  {
+    my_neuron_line_t::neuron_t::koef_array_t koefs{};
+    koefs[0] = 1.0f;
+    neuron_line->set_koefs ( i, koefs );
+  }
+
+  // every output is x, so the target is ( x - 0.3 )^2 through a full line run
+  auto const funct = [neuron_line] ( float x )
+  {
+    my_neuron_line_t::input_array_t input{};
+    my_neuron_line_t::output_array_t output{};
+
+    input[0] = x;
+    neuron_line->apply ( input.data(), output.data() );
+
+    return ( output[line_dimension - 1] - 0.3f ) * ( output[line_dimension - 1] - 0.3f );
+  };
+
+  constexpr float eps = 1e-3f;
+
+  thread_pool_utils::thread_pool_t pool ( 2 );
+
+  for ( auto* const search_pool : {&pool, &thread_pool_utils::thread_pool_t::get_default_pool()} )
+  {
+    auto const result = noptim::find_global_minimum<noptim::find_minimum_method::gold_ratio> ( 0.0f, 1.0f, eps, 16, 2,
+                        funct, *search_pool );
+
+    assert ( result.is_valid() );
+    assert ( fabs ( result.x - 0.3f ) <= eps );
+  }
+}
+
 } // namespace anonymous
 
 void test_find_minimum()
@@ -54,4 +304,24 @@ void test_find_minimum()
   smoke_test_find_minimum_dichotomie();
 
   smoke_test_find_minimum_gold_ratio();
+
+  smoke_test_find_minimum_brent();
+
+  smoke_test_find_minimum_callable<noptim::find_minimum_method::dichotomie>();
+
+  smoke_test_find_minimum_callable<noptim::find_minimum_method::gold_ratio>();
+
+  smoke_test_find_minimum_batch<noptim::find_minimum_method::dichotomie, double>();
+
+  smoke_test_find_minimum_batch<noptim::find_minimum_method::gold_ratio, double>();
+
+  smoke_test_find_minimum_batch<noptim::find_minimum_method::dichotomie, float>();
+
+  smoke_test_find_minimum_batch<noptim::find_minimum_method::gold_ratio, float>();
+
+  smoke_test_find_global_minimum<noptim::find_minimum_method::gold_ratio>();
+
+  smoke_test_find_global_minimum<noptim::find_minimum_method::brent>();
+
+  smoke_test_find_global_minimum_wide_line();
 }
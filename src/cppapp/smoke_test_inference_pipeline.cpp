@@ -0,0 +1,206 @@
+#include <cppapp/smoke_test_inference_pipeline.h>
+
+#include <utils/ring_buffer.h>
+#include <nnet/inference_pipeline.h>
+#include <nnet/neuron_line.h>
+#include <nnet/neuron_network.h>
+
+#include <cassert>
+#include <array>
+#include <vector>
+#include <thread>
+
+namespace
+{
+
+void smoke_test_ring_buffer()
+{
+  ring_buffer_utils::mpsc_ring_buffer_t<int, 4> ring_buffer;
+
+  int value{};
+
+  assert ( ring_buffer.empty() );
+  assert ( !ring_buffer.try_pop ( value ) );
+
+  // a few laps around the ring
+  for ( int lap = 0; lap < 3; ++lap )
+  {
+    for ( int i = 0; i < 4; ++i )
+    {
+      assert ( ring_buffer.try_push ( lap * 10 + i ) );
+    }
+
+    assert ( !ring_buffer.try_push ( -1 ) );
+
+    for ( int i = 0; i < 4; ++i )
+    {
+      assert ( ring_buffer.try_pop ( value ) );
+      assert ( lap * 10 + i == value );
+    }
+
+    assert ( ring_buffer.empty() );
+  }
+}
+
+void smoke_test_concurrent_ring_buffer()
+{
+  constexpr int const producer_count = 4;
+  constexpr int const push_count = 10000;
+
+  ring_buffer_utils::mpsc_ring_buffer_t<int, 64> ring_buffer;
+
+  std::vector<std::thread> producers;
+
+  for ( int p = 0; p < producer_count; ++p )
+  {
+    producers.emplace_back ( [&ring_buffer, p]
+    {
+      for ( int i = 0; i < push_count; ++i )
+      {
+        while ( !ring_buffer.try_push ( p * push_count + i ) )
+        {
+          std::this_thread::yield();
+        }
+      }
+    } );
+  }
+
+  // every producer's values come out in its own order
+  std::array<int, producer_count> next{};
+
+  for ( int received = 0; received < producer_count * push_count; )
+  {
+    int value{};
+
+    if ( ring_buffer.try_pop ( value ) )
+    {
+      auto const p = value / push_count;
+
+      assert ( next[p] == value % push_count );
+
+      next[p]++;
+      received++;
+    }
+    else
+    {
+      std::this_thread::yield();
+    }
+  }
+
+  for ( auto& producer : producers )
+  {
+    producer.join();
+  }
+
+  assert ( ring_buffer.empty() );
+}
+
+template<typename MODEL_T>
+void run_pipeline ( MODEL_T& model, MODEL_T& reference_model )
+{
+  constexpr size_t const producer_count = 3;
+  constexpr size_t const sample_count = 200;
+
+  using pipeline_t = nnet::inference_pipeline_t<MODEL_T, 8, 16>;
+
+  auto const make_input = [] ( size_t p, size_t s )
+  {
+    typename MODEL_T::input_array_t input{};
+
+    for ( size_t j = 0; j < input.size(); ++j )
+    {
+      input[j] = static_cast<int> ( ( p * 7 + s * 3 + j ) % 11 ) - 5;
+    }
+
+    return input;
+  };
+
+  std::vector<typename pipeline_t::completion_t> completions ( producer_count * sample_count );
+
+  {
+    pipeline_t pipeline ( model, std::chrono::microseconds ( 200 ) );
+
+    std::vector<std::thread> producers;
+
+    for ( size_t p = 0; p < producer_count; ++p )
+    {
+      producers.emplace_back ( [&pipeline, &completions, &make_input, p]
+      {
+        for ( size_t s = 0; s < sample_count; ++s )
+        {
+          while ( !pipeline.submit ( make_input ( p, s ), completions[p * sample_count + s] ) )
+          {
+            std::this_thread::yield();
+          }
+        }
+      } );
+    }
+
+    for ( auto& producer : producers )
+    {
+      producer.join();
+    }
+
+    assert ( pipeline.get_batch_count() <= pipeline.get_sample_count() );
+  }
+
+  // the pipeline drains the queue before it stops
+  for ( size_t p = 0; p < producer_count; ++p )
+  {
+    for ( size_t s = 0; s < sample_count; ++s )
+    {
+      auto const& completion = completions[p * sample_count + s];
+
+      assert ( completion.is_ready() );
+
+      reference_model.apply ( make_input ( p, s ) );
+
+      assert ( reference_model.get_value() == completion.get_value() );
+    }
+  }
+}
+
+void smoke_test_pipeline()
+{
+  using my_line_t = nnet::neuron_line_t<int, 6, 4, nnet::line_layout::row_major, nnet::activation::relu_t>;
+  using my_network_t = nnet::neuron_network_t<my_line_t, nnet::neuron_line_t<int, 4, 3>>;
+
+  my_line_t line;
+  my_network_t network;
+
+  for ( size_t i = 0; i < my_line_t::line_dimension; ++i )
+  {
+    my_line_t::neuron_t::koef_array_t koefs{};
+
+    for ( size_t j = 0; j < my_line_t::input_dimension; ++j )
+    {
+      koefs[j] = static_cast<int> ( ( i * 5 + j ) % 7 ) - 3;
+    }
+
+    line.set_koefs ( i, koefs );
+    network.get_line<0>().set_koefs ( i, koefs );
+  }
+
+  for ( size_t i = 0; i < 3; ++i )
+  {
+    network.get_line<1>().set_koefs ( i, {static_cast<int> ( i ), 1, -1, 2} );
+  }
+
+  // the line runs batched, the network sample by sample
+  auto reference_line = line;
+  auto reference_network = network;
+
+  run_pipeline ( line, reference_line );
+  run_pipeline ( network, reference_network );
+}
+
+} // namespace anonymous
+
+void test_inference_pipeline()
+{
+  smoke_test_ring_buffer();
+
+  smoke_test_concurrent_ring_buffer();
+
+  smoke_test_pipeline();
+}
@@ -36,6 +36,11 @@ void smoke_test_X ( ARG_TYPE const h_in, ARG_TYPE const eps_in )
   my_ret_type_t const integral_value = integr.from_to ( a, b );
 
   assert ( fabs ( integral_value - expected_integral_value ) < eps );
+
+  // the same sum with the lambda stored as is
+  auto typed_integr = integral::make_integral<METHOD_ENUM, RET_TYPE> ( h, my_funct );
+
+  assert ( typed_integr.from_to ( a, b ) == integral_value );
 }
 
 void smoke_test_rectangle()
@@ -0,0 +1,141 @@
+#include <cppapp/smoke_test_metrics.h>
+
+#include <noptim/metrics.h>
+#include <nnet/neuron_line.h>
+#include <utils/thread_pool.h>
+
+#include <cassert>
+#include <cmath>
+#include <array>
+#include <vector>
+
+namespace
+{
+
+bool is_close ( double const value, double const expected_value, double const eps )
+{
+  return std::fabs ( value - expected_value ) <= eps * ( 1.0 + std::fabs ( expected_value ) );
+}
+
+template<noptim::loss_method METHOD_ENUM>
+void smoke_test_batch_loss_X ( double const expected_loss )
+{
+  constexpr size_t count = 3;
+  constexpr size_t dimension = 3;
+
+  // the probabilities suit the cross entropy too
+  constexpr std::array<double, count* dimension> const outputs = {0.1, 0.5, 0.9, 0.2, 0.4, 0.6, 0.7, 0.3, 0.5};
+  constexpr std::array<double, count* dimension> const expected = {0.0, 1.0, 1.0, 0.0, 0.0, 1.0, 1.0, 0.0, 0.5};
+
+  noptim::loss_parameters_t parameters;
+  parameters.huber_delta = 0.45;
+
+  assert ( is_close ( noptim::batch_loss<METHOD_ENUM> ( outputs.data(), expected.data(), count, dimension, parameters ),
+                      expected_loss, 1e-12 ) );
+
+  std::array<double, count* dimension> gradient{};
+
+  assert ( is_close ( noptim::batch_loss_gradient<METHOD_ENUM> ( outputs.data(), expected.data(), count, dimension,
+                      gradient.data(), parameters ), expected_loss, 1e-12 ) );
+
+  // the central differences of the mean loss
+  for ( size_t i = 0; i < outputs.size(); ++i )
+  {
+    constexpr double const h = 1e-6;
+
+    auto shifted = outputs;
+
+    shifted[i] = outputs[i] + h;
+    auto const loss_plus = noptim::batch_loss<METHOD_ENUM> ( shifted.data(), expected.data(), count, dimension, parameters );
+
+    shifted[i] = outputs[i] - h;
+    auto const loss_minus = noptim::batch_loss<METHOD_ENUM> ( shifted.data(), expected.data(), count, dimension, parameters );
+
+    assert ( is_close ( gradient[i], ( loss_plus - loss_minus ) / ( 2.0 * h ), 1e-5 ) );
+  }
+}
+
+template<noptim::loss_method METHOD_ENUM>
+void smoke_test_parallel_loss_X()
+{
+  constexpr size_t count = 1001;
+  constexpr size_t dimension = 7;
+
+  std::vector<float> outputs ( count * dimension );
+  std::vector<float> expected ( count * dimension );
+
+  for ( size_t i = 0; i < outputs.size(); ++i )
+  {
+    outputs[i] = 0.5f + 0.45f * std::sin ( static_cast<float> ( i ) );
+    expected[i] = ( i % 3 == 0 ) ? 1.0f : 0.0f;
+  }
+
+  std::vector<float> gradient ( outputs.size() );
+  std::vector<float> parallel_gradient ( outputs.size() );
+
+  auto const loss = noptim::batch_loss_gradient<METHOD_ENUM> ( outputs.data(), expected.data(), count, dimension,
+                    gradient.data() );
+
+  thread_pool_utils::thread_pool_t pool ( 4 );
+
+  noptim::loss_parameters_t parameters;
+  parameters.pool = &pool;
+  parameters.chunk_rows = 64;
+
+  auto const parallel_loss = noptim::batch_loss_gradient<METHOD_ENUM> ( outputs.data(), expected.data(), count, dimension,
+                             parallel_gradient.data(), parameters );
+
+  assert ( is_close ( parallel_loss, loss, 1e-5 ) );
+  assert ( parallel_gradient == gradient );
+
+  // the chunks are summed in order, so the parallel result is reproducible
+  assert ( parallel_loss == noptim::batch_loss<METHOD_ENUM> ( outputs.data(), expected.data(), count, dimension,
+           parameters ) );
+}
+
+void smoke_test_line_loss()
+{
+  using my_neuron_line_t = nnet::neuron_line_t<double, 3, 2>;
+
+  my_neuron_line_t neuron_line;
+
+  neuron_line.set_koefs ( 0, {1.0, 2.0, 3.0} );
+  neuron_line.set_koefs ( 1, {-1.0, 0.5, 0.0} );
+
+  std::array<my_neuron_line_t::input_array_t, 2> const inputs = {{{1.0, 0.0, -1.0}, {0.5, 0.5, 0.5}}};
+  std::array<my_neuron_line_t::output_array_t, 2> const expected = {{{-1.0, 0.0}, {3.0, 1.0}}};
+
+  std::array<double, 4> outputs{};
+
+  neuron_line.apply_batch ( inputs.data(), inputs.size(), outputs.data() );
+
+  double line_loss = 0.0;
+
+  for ( size_t k = 0; k < inputs.size(); ++k )
+  {
+    neuron_line.apply ( inputs[k] );
+    line_loss += noptim::neuron_line_loss<double> ( neuron_line, expected[k] );
+  }
+
+  // the mean over the elements of the summed per-sample squared errors
+  assert ( is_close ( noptim::batch_loss<noptim::loss_method::mse> ( outputs.data(), expected[0].data(), 2, 2 ),
+                      line_loss / 4.0, 1e-12 ) );
+}
+
+} // namespace anonymous
+
+void test_metrics()
+{
+  smoke_test_batch_loss_X<noptim::loss_method::mse> ( 0.81 / 9.0 );
+  smoke_test_batch_loss_X<noptim::loss_method::mae> ( 2.3 / 9.0 );
+  smoke_test_batch_loss_X<noptim::loss_method::huber> ( 0.40375 / 9.0 );
+  smoke_test_batch_loss_X<noptim::loss_method::cross_entropy> (
+    -( std::log ( 0.9 ) + std::log ( 0.5 ) + std::log ( 0.9 ) + std::log ( 0.8 ) + std::log ( 0.6 )
+       + std::log ( 0.6 ) + std::log ( 0.7 ) + std::log ( 0.7 ) + std::log ( 0.5 ) ) / 9.0 );
+
+  smoke_test_parallel_loss_X<noptim::loss_method::mse>();
+  smoke_test_parallel_loss_X<noptim::loss_method::huber>();
+  smoke_test_parallel_loss_X<noptim::loss_method::cross_entropy>();
+
+  smoke_test_line_loss();
+}
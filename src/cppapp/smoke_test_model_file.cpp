@@ -0,0 +1,184 @@
+#include <cppapp/smoke_test_model_file.h>
+
+#include <nnet/arena.h>
+#include <nnet/dynamic_line.h>
+#include <nnet/model_file.h>
+#include <nnet/neuron_line.h>
+#include <nnet/neuron_network.h>
+
+#include <cassert>
+#include <cstdint>
+#include <cstdio>
+#include <cmath>
+#include <array>
+#include <vector>
+
+namespace
+{
+
+char const* const model_path = "smoke_test_model_file.bin";
+
+template<typename LINE_T>
+void set_test_koefs ( LINE_T& line, size_t const seed )
+{
+  for ( size_t i = 0; i < LINE_T::line_dimension; ++i )
+  {
+    typename LINE_T::neuron_t::koef_array_t koefs{};
+
+    for ( size_t j = 0; j < LINE_T::input_dimension; ++j )
+    {
+      koefs[j] = 0.25f * ( static_cast<float> ( ( i * 3 + j * 5 + seed ) % 9 ) - 4.0f );
+    }
+
+    line.set_koefs ( i, koefs );
+  }
+}
+
+void corrupt_last_byte ( char const* path )
+{
+  auto* const file = std::fopen ( path, "r+b" );
+
+  assert ( file );
+
+  std::fseek ( file, -1, SEEK_END );
+  std::fputc ( 0x5a, file );
+  std::fclose ( file );
+}
+
+void write_first_dimension ( char const* path, uint64_t const dimension )
+{
+  auto* const file = std::fopen ( path, "r+b" );
+
+  assert ( file );
+
+  std::fseek ( file, static_cast<long> ( nnet::model_file_details::dimensions_offset() ), SEEK_SET );
+  std::fwrite ( &dimension, sizeof ( dimension ), 1, file );
+  std::fclose ( file );
+}
+
+void smoke_test_model_line()
+{
+  using my_line_t = nnet::neuron_line_t<float, 5, 3, nnet::line_layout::column_major>;
+
+  my_line_t line;
+  set_test_koefs ( line, 7 );
+
+  assert ( nnet::save_line ( model_path, line ) );
+
+  nnet::model_file_t model_file ( model_path );
+
+  assert ( model_file.is_valid() );
+  assert ( nnet::model_dtype::float32 == model_file.get_dtype() );
+  assert ( 1 == model_file.get_line_count() );
+  assert ( 5 == model_file.get_dimension ( 0 ) && 3 == model_file.get_dimension ( 1 ) );
+  assert ( nullptr == model_file.get_koefs<double> ( 0 ) );
+  assert ( reinterpret_cast<uintptr_t> ( model_file.get_koefs<float> ( 0 ) ) % 64 == 0 );
+
+  std::array<float, 3> values{};
+  auto mapped_line = model_file.get_line<float> ( 0, values.data() );
+
+  assert ( mapped_line.is_valid() );
+
+  constexpr my_line_t::input_array_t const inputs = {1.0f, -0.5f, 2.0f, 0.0f, 0.25f};
+
+  line.apply ( inputs );
+  mapped_line.apply ( inputs.data() );
+
+  assert ( line.get_value() == values );
+
+  // the mapping is private, the file keeps the saved koefs
+  model_file.get_koefs<float> ( 0 ) [0] += 1.0f;
+
+  nnet::model_file_t reloaded_file ( model_path );
+
+  assert ( reloaded_file.is_valid() );
+  assert ( line.koefs_data() [0] == reloaded_file.get_koefs<float> ( 0 ) [0] );
+
+  corrupt_last_byte ( model_path );
+
+  assert ( !nnet::model_file_t ( model_path ).is_valid() );
+  assert ( nnet::model_file_t ( model_path, false ).is_valid() );
+
+  // ( 2^62 + 5 ) * 3 * 4 wraps around to the 60 koef bytes of the saved line
+  write_first_dimension ( model_path, ( uint64_t{1} << 62 ) + 5 );
+  assert ( !nnet::model_file_t ( model_path, false ).is_valid() );
+
+  std::remove ( model_path );
+
+  assert ( !nnet::model_file_t ( model_path ).is_valid() );
+}
+
+void smoke_test_model_network()
+{
+  using my_line_1_t = nnet::neuron_line_t<float, 4, 6, nnet::line_layout::row_major, nnet::activation::tanh_t>;
+  using my_line_2_t = nnet::neuron_line_t<float, 6, 5, nnet::line_layout::column_major, nnet::activation::tanh_t>;
+  using my_line_3_t = nnet::neuron_line_t<float, 5, 2>;
+  using my_network_t = nnet::neuron_network_t<my_line_1_t, my_line_2_t, my_line_3_t>;
+  using my_dynamic_network_t = nnet::dynamic_network_t<float, nnet::activation::tanh_t, nnet::activation::identity_t>;
+
+  my_network_t network;
+
+  set_test_koefs ( network.get_line<0>(), 1 );
+  set_test_koefs ( network.get_line<1>(), 2 );
+  set_test_koefs ( network.get_line<2>(), 3 );
+
+  assert ( nnet::save_network ( model_path, network ) );
+
+  nnet::model_file_t model_file ( model_path );
+
+  assert ( model_file.is_valid() );
+  assert ( 3 == model_file.get_line_count() );
+
+  auto const dimensions = model_file.get_dimensions();
+  auto const koefs = model_file.get_all_koefs<float>();
+
+  assert ( 4 == dimensions.size() && 3 == koefs.size() );
+
+  // only the line descriptors and the buffers come from the arena
+  nnet::arena_t arena ( my_dynamic_network_t::required_bytes ( dimensions.data(), dimensions.size(), false ) );
+
+  my_dynamic_network_t dynamic_network ( arena, dimensions.data(), dimensions.size(), koefs.data() );
+
+  assert ( dynamic_network.is_valid() );
+  assert ( arena.get_used() == arena.get_capacity() );
+
+  constexpr my_network_t::input_array_t const inputs = {0.5f, -1.0f, 0.25f, 2.0f};
+
+  network.apply ( inputs );
+  dynamic_network.apply ( inputs.data() );
+
+  // the column-major line sums in another order
+  for ( size_t i = 0; i < dynamic_network.size(); ++i )
+  {
+    assert ( std::fabs ( network.get_value() [i] - dynamic_network.get_value() [i] ) < 1e-5f );
+  }
+
+  // the dynamic network round-trips as well
+  assert ( nnet::save_network ( model_path, dynamic_network ) );
+
+  nnet::model_file_t saved_file ( model_path );
+
+  assert ( saved_file.is_valid() );
+  assert ( dimensions == saved_file.get_dimensions() );
+
+  for ( size_t i = 0; i < koefs.size(); ++i )
+  {
+    auto const* const saved_koefs = saved_file.get_koefs<float> ( i );
+
+    for ( size_t j = 0; j < dimensions[i] * dimensions[i + 1]; ++j )
+    {
+      assert ( koefs[i][j] == saved_koefs[j] );
+    }
+  }
+
+  std::remove ( model_path );
+}
+
+} // namespace anonymous
+
+void test_model_file()
+{
+  smoke_test_model_line();
+
+  smoke_test_model_network();
+}
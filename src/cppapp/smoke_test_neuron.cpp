@@ -2,9 +2,17 @@
 
 #include <nnet/neuron.h>
 #include <nnet/neuron_line.h>
+#include <nnet/quantized_line.h>
+#include <nnet/sparse_line.h>
+#include <nnet/half_line.h>
+#include <nnet/incremental_line.h>
+#include <nnet/neuron_network.h>
 #include <noptim/metrics.h>
 
 #include <cassert>
+#include <algorithm>
+#include <cstdint>
+#include <cmath>
 
 namespace
 {
@@ -70,6 +78,496 @@ void smoke_test_neuron_line()
   assert ( fake_expected_loss == noptim::neuron_line_loss<input_t> ( neuron_line, fake_expected_results ) );
 }
 
+template<nnet::line_layout LAYOUT>
+void smoke_test_neuron_line_batch()
+{
+  // the dimensions are chosen to cross the gemm register and cache block borders
+  constexpr size_t input_dimension = 300;
+  constexpr size_t line_dimension = 70;
+  constexpr size_t batch_size = 7;
+
+  using input_t = int;
+  using my_neuron_line_t = nnet::neuron_line_t<input_t, input_dimension, line_dimension, LAYOUT>;
+
+  my_neuron_line_t neuron_line;
+
+  for ( size_t i = 0; i < line_dimension; ++i )
+  {
+    typename my_neuron_line_t::neuron_t::koef_array_t koefs{};
+
+    for ( size_t j = 0; j < input_dimension; ++j )
+    {
+      koefs[j] = static_cast<input_t> ( ( i * 7 + j * 3 ) % 11 ) - 5;
+    }
+
+    neuron_line.set_koefs ( i, koefs );
+  }
+
+  std::array<typename my_neuron_line_t::input_array_t, batch_size> inputs{};
+
+  for ( size_t k = 0; k < batch_size; ++k )
+  {
+    for ( size_t j = 0; j < input_dimension; ++j )
+    {
+      inputs[k][j] = static_cast<input_t> ( ( k * 5 + j ) % 13 ) - 6;
+    }
+  }
+
+  std::array<typename my_neuron_line_t::output_t, batch_size * line_dimension> outputs{};
+
+  neuron_line.apply_batch ( inputs.data(), batch_size, outputs.data() );
+
+  for ( size_t k = 0; k < batch_size; ++k )
+  {
+    neuron_line.apply ( inputs[k] );
+
+    auto const expected_results = neuron_line.get_value();
+
+    assert ( std::equal ( expected_results.cbegin(), expected_results.cend(),
+                          outputs.cbegin() + k * line_dimension ) );
+  }
+}
+
+void smoke_test_neuron_line_layout()
+{
+  constexpr size_t input_dimension = 5;
+  constexpr size_t line_dimension = 3;
+
+  using input_t = int;
+  using my_row_major_line_t = nnet::neuron_line_t<input_t, input_dimension, line_dimension,
+        nnet::line_layout::row_major>;
+  using my_column_major_line_t = nnet::neuron_line_t<input_t, input_dimension, line_dimension,
+        nnet::line_layout::column_major>;
+
+  constexpr my_row_major_line_t::input_array_t const inputs = {1, -2, 3, -4, 5};
+  constexpr std::array<my_row_major_line_t::neuron_t::koef_array_t, line_dimension> const koefs =
+  {
+    {
+      {1, 2, 3, 4, 5},
+      {0, -1, 0, 1, 0},
+      {2, 2, 2, 2, 2}
+    }
+  };
+  constexpr my_row_major_line_t::output_array_t const expected_results = {15, -2, 6};
+
+  my_row_major_line_t row_major_line;
+  my_column_major_line_t column_major_line;
+
+  for ( size_t i = 0; i < line_dimension; ++i )
+  {
+    row_major_line.set_koefs ( i, koefs[i] );
+    column_major_line[i].set_koefs ( koefs[i] );
+  }
+
+  assert ( reinterpret_cast<uintptr_t> ( row_major_line.koefs_data() ) % 64 == 0 );
+  assert ( reinterpret_cast<uintptr_t> ( column_major_line.koefs_data() ) % 64 == 0 );
+
+  assert ( koefs[1][3] == row_major_line.koefs_data() [1 * input_dimension + 3] );
+  assert ( koefs[1][3] == column_major_line.koefs_data() [3 * line_dimension + 1] );
+
+  row_major_line.apply ( inputs );
+  column_major_line.apply ( inputs );
+
+  assert ( expected_results == row_major_line.get_value() );
+  assert ( expected_results == column_major_line.get_value() );
+
+  for ( size_t i = 0; i < line_dimension; ++i )
+  {
+    my_column_major_line_t const& const_line = column_major_line;
+
+    assert ( koefs[i] == const_line[i].get_koefs() );
+    assert ( expected_results[i] == const_line[i].get_value() );
+  }
+}
+
+template<nnet::line_layout LAYOUT, typename ACTIVATION>
+void smoke_test_neuron_line_activation()
+{
+  constexpr size_t input_dimension = 9;
+  constexpr size_t line_dimension = 5;
+  constexpr size_t batch_size = 3;
+  constexpr double eps = 1e-12;
+
+  using input_t = double;
+  using my_linear_line_t = nnet::neuron_line_t<input_t, input_dimension, line_dimension, LAYOUT>;
+  using my_neuron_line_t = nnet::neuron_line_t<input_t, input_dimension, line_dimension, LAYOUT, ACTIVATION>;
+  using my_neuron_t = typename my_neuron_line_t::neuron_t;
+
+  my_linear_line_t linear_line;
+  my_neuron_line_t neuron_line;
+  my_neuron_t neuron;
+
+  std::array<typename my_neuron_line_t::input_array_t, batch_size> inputs{};
+
+  for ( size_t i = 0; i < line_dimension; ++i )
+  {
+    typename my_neuron_t::koef_array_t koefs{};
+
+    for ( size_t j = 0; j < input_dimension; ++j )
+    {
+      koefs[j] = 0.25 * ( static_cast<double> ( ( i * 5 + j * 3 ) % 9 ) - 4.0 );
+    }
+
+    linear_line.set_koefs ( i, koefs );
+    neuron_line.set_koefs ( i, koefs );
+  }
+
+  for ( size_t k = 0; k < batch_size; ++k )
+  {
+    for ( size_t j = 0; j < input_dimension; ++j )
+    {
+      inputs[k][j] = 0.5 * ( static_cast<double> ( ( k * 7 + j ) % 5 ) - 2.0 );
+    }
+  }
+
+  std::array<input_t, batch_size * line_dimension> outputs{};
+
+  neuron_line.apply_batch ( inputs.data(), batch_size, outputs.data() );
+
+  for ( size_t k = 0; k < batch_size; ++k )
+  {
+    linear_line.apply ( inputs[k] );
+    neuron_line.apply ( inputs[k] );
+
+    for ( size_t i = 0; i < line_dimension; ++i )
+    {
+      auto const expected_result = ACTIVATION::apply ( linear_line.get_value() [i] );
+
+      neuron.set_koefs ( neuron_line[i].get_koefs() );
+      neuron.apply ( inputs[k] );
+
+      assert ( fabs ( neuron_line.get_value() [i] - expected_result ) < eps );
+      assert ( fabs ( outputs[k * line_dimension + i] - expected_result ) < eps );
+      assert ( fabs ( neuron.get_value() - expected_result ) < eps );
+    }
+  }
+}
+
+void smoke_test_fast_activation()
+{
+  constexpr double eps = 1e-4;
+
+  for ( double x = -10.0; x <= 10.0; x += 0.001 )
+  {
+    assert ( fabs ( nnet::activation::fast_tanh_t::apply ( x ) - nnet::activation::tanh_t::apply ( x ) ) < eps );
+    assert ( fabs ( nnet::activation::fast_sigmoid_t::apply ( x ) - nnet::activation::sigmoid_t::apply ( x ) ) < eps );
+  }
+
+  assert ( nnet::activation::relu_t::apply ( -3 ) == 0 );
+  assert ( nnet::activation::relu_t::apply ( 3 ) == 3 );
+  assert ( nnet::activation::leaky_relu_t<>::apply ( -3.0 ) == -0.03 );
+}
+
+void smoke_test_quantized_line()
+{
+  constexpr size_t input_dimension = 64;
+  constexpr size_t line_dimension = 16;
+  constexpr size_t sample_count = 32;
+
+  using my_float_line_t = nnet::neuron_line_t<float, input_dimension, line_dimension,
+        nnet::line_layout::row_major, nnet::activation::relu_t>;
+  using my_quantized_line_t = nnet::quantized_neuron_line_t<input_dimension, line_dimension, nnet::activation::relu_t>;
+
+  my_float_line_t float_line;
+
+  for ( size_t i = 0; i < line_dimension; ++i )
+  {
+    my_float_line_t::neuron_t::koef_array_t koefs{};
+
+    for ( size_t j = 0; j < input_dimension; ++j )
+    {
+      koefs[j] = static_cast<float> ( static_cast<int> ( ( i * 13 + j * 7 ) % 31 ) - 15 ) / 15.0f;
+    }
+
+    float_line.set_koefs ( i, koefs );
+  }
+
+  std::array<my_float_line_t::input_array_t, sample_count> inputs{};
+
+  for ( size_t k = 0; k < sample_count; ++k )
+  {
+    for ( size_t j = 0; j < input_dimension; ++j )
+    {
+      inputs[k][j] = static_cast<float> ( static_cast<int> ( ( k * 11 + j * 5 ) % 41 ) - 20 ) / 20.0f;
+    }
+  }
+
+  my_quantized_line_t quantized_line;
+
+  nnet::quantize_line ( float_line, inputs.data(), sample_count, quantized_line );
+
+  auto const& input_quantization = quantized_line.get_input_quantization();
+  auto const& output_quantization = quantized_line.get_output_quantization();
+
+  // the quantized output is compared against 2% of the full output range
+  auto const eps = 0.02f * 255.0f * output_quantization.scale;
+
+  for ( size_t k = 0; k < sample_count; ++k )
+  {
+    my_quantized_line_t::input_array_t quantized_input{};
+
+    for ( size_t j = 0; j < input_dimension; ++j )
+    {
+      quantized_input[j] = input_quantization.quantize ( inputs[k][j] );
+    }
+
+    float_line.apply ( inputs[k] );
+    quantized_line.apply ( quantized_input );
+
+    for ( size_t i = 0; i < line_dimension; ++i )
+    {
+      auto const value = output_quantization.dequantize ( quantized_line.get_value() [i] );
+
+      assert ( fabs ( value - float_line.get_value() [i] ) <= eps );
+    }
+  }
+}
+
+template<nnet::line_layout LAYOUT>
+void smoke_test_sparse_line()
+{
+  constexpr size_t input_dimension = 37;
+  constexpr size_t line_dimension = 11;
+  constexpr size_t batch_size = 3;
+
+  using my_neuron_line_t =
+    nnet::neuron_line_t<int, input_dimension, line_dimension, LAYOUT, nnet::activation::relu_t>;
+  using my_sparse_line_t =
+    nnet::sparse_neuron_line_t<int, input_dimension, line_dimension, nnet::activation::relu_t>;
+
+  my_neuron_line_t neuron_line;
+  my_neuron_line_t pruned_line;
+  size_t nonzero_count = 0;
+
+  for ( size_t i = 0; i < line_dimension; ++i )
+  {
+    typename my_neuron_line_t::neuron_t::koef_array_t koefs{};
+    typename my_neuron_line_t::neuron_t::koef_array_t pruned_koefs{};
+
+    for ( size_t j = 0; j < input_dimension; ++j )
+    {
+      // mostly small koefs, the neuron 4 has none above the threshold
+      koefs[j] = ( ( i * 5 + j * 3 ) % 7 == 0 && i != 4 ) ? static_cast<int> ( ( i + j ) % 9 ) - 12 : ( j % 3 ) - 1;
+      pruned_koefs[j] = ( std::abs ( koefs[j] ) > 1 ) ? koefs[j] : 0;
+      nonzero_count += ( pruned_koefs[j] != 0 ) ? 1 : 0;
+    }
+
+    neuron_line.set_koefs ( i, koefs );
+    pruned_line.set_koefs ( i, pruned_koefs );
+  }
+
+  my_sparse_line_t const exact_line ( neuron_line );
+  my_sparse_line_t sparse_line ( neuron_line, 1 );
+
+  assert ( nonzero_count == sparse_line.get_nonzero_count() );
+  assert ( nonzero_count < exact_line.get_nonzero_count() );
+
+  std::array<typename my_neuron_line_t::input_array_t, batch_size> inputs{};
+
+  for ( size_t k = 0; k < batch_size; ++k )
+  {
+    for ( size_t j = 0; j < input_dimension; ++j )
+    {
+      inputs[k][j] = static_cast<int> ( ( k * 7 + j ) % 5 ) - 1;
+    }
+  }
+
+  std::array < int, batch_size* line_dimension > outputs{};
+
+  sparse_line.apply_batch ( inputs.data(), batch_size, outputs.data() );
+
+  for ( size_t k = 0; k < batch_size; ++k )
+  {
+    typename my_neuron_line_t::output_array_t exact_output{};
+
+    exact_line.apply ( inputs[k].data(), exact_output.data() );
+    neuron_line.apply ( inputs[k] );
+
+    assert ( neuron_line.get_value() == exact_output );
+
+    pruned_line.apply ( inputs[k] );
+    sparse_line.apply ( inputs[k] );
+
+    assert ( pruned_line.get_value() == sparse_line.get_value() );
+    assert ( std::equal ( sparse_line.get_value().cbegin(), sparse_line.get_value().cend(),
+                          outputs.cbegin() + k * line_dimension ) );
+  }
+
+  // the sparse line is a drop-in for the network
+  nnet::neuron_network_t<my_sparse_line_t> network;
+
+  network.get_line<0>() = sparse_line;
+  network.apply ( inputs[0] );
+
+  sparse_line.apply ( inputs[0] );
+
+  assert ( network.get_value() == sparse_line.get_value() );
+}
+
+template<typename HALF_T>
+void smoke_test_half_line ( float const relative_tolerance )
+{
+  constexpr size_t input_dimension = 300;
+  constexpr size_t line_dimension = 17;
+  constexpr size_t batch_size = 2;
+
+  using my_neuron_line_t =
+    nnet::neuron_line_t<float, input_dimension, line_dimension, nnet::line_layout::column_major, nnet::activation::tanh_t>;
+  using my_half_line_t = nnet::half_neuron_line_t<HALF_T, input_dimension, line_dimension, nnet::activation::tanh_t>;
+
+  my_neuron_line_t neuron_line;
+
+  for ( size_t i = 0; i < line_dimension; ++i )
+  {
+    typename my_neuron_line_t::neuron_t::koef_array_t koefs{};
+
+    for ( size_t j = 0; j < input_dimension; ++j )
+    {
+      // koefs that are not exact in 16 bits
+      koefs[j] = std::sin ( static_cast<float> ( i * input_dimension + j ) ) * 0.1f;
+    }
+
+    neuron_line.set_koefs ( i, koefs );
+  }
+
+  my_half_line_t const half_line ( neuron_line );
+
+  std::array<typename my_neuron_line_t::input_array_t, batch_size> inputs{};
+
+  for ( size_t k = 0; k < batch_size; ++k )
+  {
+    for ( size_t j = 0; j < input_dimension; ++j )
+    {
+      inputs[k][j] = std::cos ( static_cast<float> ( k * 31 + j ) );
+    }
+  }
+
+  std::array < float, batch_size* line_dimension > outputs{};
+
+  half_line.apply_batch ( inputs.data(), batch_size, outputs.data() );
+
+  for ( size_t k = 0; k < batch_size; ++k )
+  {
+    neuron_line.apply ( inputs[k] );
+
+    for ( size_t i = 0; i < line_dimension; ++i )
+    {
+      // the rounding error of every koef is bounded relative to it, so the sum error is bounded by sum | w x |
+      float magnitude = 0.0f;
+
+      for ( size_t j = 0; j < input_dimension; ++j )
+      {
+        magnitude += std::fabs ( neuron_line[i].get_koef ( j ) * inputs[k][j] );
+      }
+
+      assert ( std::fabs ( outputs[k * line_dimension + i] - neuron_line.get_value() [i] )
+               <= relative_tolerance * magnitude );
+    }
+  }
+}
+
+template<nnet::line_layout LAYOUT>
+void smoke_test_incremental_line()
+{
+  constexpr size_t input_dimension = 9;
+  constexpr size_t line_dimension = 5;
+
+  using my_neuron_line_t =
+    nnet::neuron_line_t<int, input_dimension, line_dimension, LAYOUT, nnet::activation::relu_t>;
+
+  my_neuron_line_t neuron_line;
+
+  for ( size_t i = 0; i < line_dimension; ++i )
+  {
+    typename my_neuron_line_t::neuron_t::koef_array_t koefs{};
+
+    for ( size_t j = 0; j < input_dimension; ++j )
+    {
+      koefs[j] = static_cast<int> ( ( i * 4 + j * 3 ) % 7 ) - 3;
+    }
+
+    neuron_line.set_koefs ( i, koefs );
+  }
+
+  nnet::incremental_line_t<my_neuron_line_t> incremental_line ( neuron_line, 10 );
+
+  typename my_neuron_line_t::input_array_t input = {1, 2, 3, 4, 5, 6, 7, 8, 9};
+
+  incremental_line.reset ( input );
+
+  assert ( 2 == incremental_line.get_refresh_count() );
+
+  for ( int step = 0; step < 20; ++step )
+  {
+    std::array<size_t, 2> const indexes = {static_cast<size_t> ( step ) % input_dimension,
+                                           static_cast<size_t> ( step * 5 + 1 ) % input_dimension
+                                          };
+    std::array<int, 2> const deltas = {step % 3 - 1, 2 - step % 5};
+
+    for ( size_t j = 0; j < indexes.size(); ++j )
+    {
+      input[indexes[j]] += deltas[j];
+    }
+
+    incremental_line.update ( indexes.data(), deltas.data(), indexes.size() );
+
+    // the integer sums are exact, so the incremental outputs match the full product
+    neuron_line.apply ( input );
+
+    assert ( input == incremental_line.get_input() );
+    assert ( neuron_line.get_value() == incremental_line.get_value() );
+  }
+
+  // 40 changed inputs with the refresh every 10 of them
+  assert ( 6 == incremental_line.get_refresh_count() );
+}
+
+void smoke_test_incremental_drift()
+{
+  constexpr size_t input_dimension = 64;
+  constexpr size_t line_dimension = 8;
+
+  using my_neuron_line_t = nnet::neuron_line_t<float, input_dimension, line_dimension>;
+
+  my_neuron_line_t neuron_line;
+
+  for ( size_t i = 0; i < line_dimension; ++i )
+  {
+    my_neuron_line_t::neuron_t::koef_array_t koefs{};
+
+    for ( size_t j = 0; j < input_dimension; ++j )
+    {
+      koefs[j] = std::sin ( static_cast<float> ( i * input_dimension + j ) );
+    }
+
+    neuron_line.set_koefs ( i, koefs );
+  }
+
+  nnet::incremental_line_t<my_neuron_line_t> incremental_line ( neuron_line, 256 );
+
+  for ( size_t step = 0; step < 1000; ++step )
+  {
+    size_t const index = step * 7 % input_dimension;
+    float const delta = std::cos ( static_cast<float> ( step ) ) * 100.0f;
+
+    incremental_line.update ( &index, &delta, 1 );
+  }
+
+  neuron_line.apply ( incremental_line.get_input() );
+
+  for ( size_t k = 0; k < line_dimension; ++k )
+  {
+    assert ( std::fabs ( neuron_line.get_value() [k] - incremental_line.get_value() [k] ) < 1e-2f );
+  }
+
+  incremental_line.refresh();
+
+  for ( size_t k = 0; k < line_dimension; ++k )
+  {
+    assert ( std::fabs ( neuron_line.get_value() [k] - incremental_line.get_value() [k] ) < 1e-4f );
+  }
+}
+
 } //namespace anonymous
 
 void test_neuron()
@@ -77,4 +575,32 @@ void test_neuron()
   smoke_test_neuron();
 
   smoke_test_neuron_line();
+
+  smoke_test_neuron_line_layout();
+
+  smoke_test_neuron_line_batch<nnet::line_layout::row_major>();
+
+  smoke_test_neuron_line_batch<nnet::line_layout::column_major>();
+
+  smoke_test_fast_activation();
+
+  smoke_test_neuron_line_activation<nnet::line_layout::row_major, nnet::activation::relu_t>();
+  smoke_test_neuron_line_activation<nnet::line_layout::column_major, nnet::activation::leaky_relu_t<>>();
+  smoke_test_neuron_line_activation<nnet::line_layout::row_major, nnet::activation::sigmoid_t>();
+  smoke_test_neuron_line_activation<nnet::line_layout::column_major, nnet::activation::tanh_t>();
+  smoke_test_neuron_line_activation<nnet::line_layout::row_major, nnet::activation::fast_tanh_t>();
+  smoke_test_neuron_line_activation<nnet::line_layout::row_major, nnet::activation::fast_sigmoid_t>();
+
+  smoke_test_quantized_line();
+
+  smoke_test_sparse_line<nnet::line_layout::row_major>();
+  smoke_test_sparse_line<nnet::line_layout::column_major>();
+
+  // twice the unit roundoff of the formats
+  smoke_test_half_line<nnet::bf16_t> ( 1.0f / 256.0f );
+  smoke_test_half_line<nnet::fp16_t> ( 1.0f / 1024.0f );
+
+  smoke_test_incremental_line<nnet::line_layout::row_major>();
+  smoke_test_incremental_line<nnet::line_layout::column_major>();
+  smoke_test_incremental_drift();
 }
@@ -0,0 +1,257 @@
+#include <cppapp/smoke_test_neuron_network.h>
+
+#include <nnet/neuron_line.h>
+#include <nnet/neuron_network.h>
+#include <utils/thread_pool.h>
+
+#include <cassert>
+#include <array>
+#include <vector>
+#include <thread>
+#include <memory>
+
+namespace
+{
+
+template<typename LINE_T>
+void set_test_koefs ( LINE_T& line, int const seed )
+{
+  for ( size_t i = 0; i < LINE_T::line_dimension; ++i )
+  {
+    typename LINE_T::neuron_t::koef_array_t koefs{};
+
+    for ( size_t j = 0; j < LINE_T::input_dimension; ++j )
+    {
+      koefs[j] = static_cast<int> ( ( i * 3 + j * 5 + seed ) % 7 ) - 3;
+    }
+
+    line.set_koefs ( i, koefs );
+  }
+}
+
+void smoke_test_neuron_network()
+{
+  using input_t = int;
+  using my_line_1_t = nnet::neuron_line_t<input_t, 4, 6>;
+  using my_line_2_t = nnet::neuron_line_t<input_t, 6, 5, nnet::line_layout::column_major>;
+  using my_line_3_t = nnet::neuron_line_t<input_t, 5, 2>;
+  using my_network_t = nnet::neuron_network_t<my_line_1_t, my_line_2_t, my_line_3_t>;
+
+  static_assert ( my_network_t::input_dimension == 4 );
+  static_assert ( my_network_t::line_dimension == 2 );
+  static_assert ( my_network_t::hidden_dimension == 6 );
+
+  constexpr my_network_t::input_array_t const inputs = {1, -2, 3, 2};
+
+  my_network_t network;
+
+  set_test_koefs ( network.get_line<0>(), 1 );
+  set_test_koefs ( network.get_line<1>(), 2 );
+  set_test_koefs ( network.get_line<2>(), 3 );
+
+  // the reference chain copies every layer output into the next input
+  my_line_1_t line_1 = network.get_line<0>();
+  my_line_2_t line_2 = network.get_line<1>();
+  my_line_3_t line_3 = network.get_line<2>();
+
+  line_1.apply ( inputs );
+  line_2.apply ( line_1.get_value() );
+  line_3.apply ( line_2.get_value() );
+
+  network.apply ( inputs );
+
+  assert ( line_3.get_value() == network.get_value() );
+
+  // repeated calls reuse the same buffers
+  network.apply ( inputs );
+
+  assert ( line_3.get_value() == network.get_value() );
+}
+
+void smoke_test_neuron_network_single_line()
+{
+  using input_t = int;
+  using my_line_t = nnet::neuron_line_t<input_t, 3, 3>;
+  using my_network_t = nnet::neuron_network_t<my_line_t>;
+
+  constexpr my_network_t::input_array_t const inputs = {1, 1, 1};
+  constexpr my_network_t::output_array_t const expected_results = {6, 6, 6};
+
+  my_network_t network;
+
+  for ( size_t i = 0; i < my_line_t::line_dimension; ++i )
+  {
+    network.get_line<0>().set_koefs ( i, {1, 2, 3} );
+  }
+
+  network.apply ( inputs );
+
+  assert ( expected_results == network.get_value() );
+}
+
+void smoke_test_shared_network()
+{
+  using input_t = int;
+  using my_line_1_t = nnet::neuron_line_t<input_t, 4, 6, nnet::line_layout::row_major, nnet::activation::relu_t>;
+  using my_line_2_t = nnet::neuron_line_t<input_t, 6, 3>;
+  using my_network_t = nnet::neuron_network_t<my_line_1_t, my_line_2_t>;
+
+  constexpr size_t const thread_count = 4;
+  constexpr size_t const sample_count = 100;
+
+  my_network_t model;
+
+  set_test_koefs ( model.get_line<0>(), 4 );
+  set_test_koefs ( model.get_line<1>(), 5 );
+
+  auto const make_input = [] ( size_t t, size_t s )
+  {
+    return my_network_t::input_array_t
+    {
+      static_cast<input_t> ( t ) - 2, static_cast<input_t> ( s % 5 ), static_cast<input_t> ( s % 3 ) - 1, 1
+    };
+  };
+
+  // the reference results come from the single-threaded apply of a copy
+  my_network_t reference = model;
+
+  std::vector<my_network_t::output_array_t> expected_results ( thread_count * sample_count );
+  std::vector<my_network_t::output_array_t> results ( thread_count * sample_count );
+
+  for ( size_t t = 0; t < thread_count; ++t )
+  {
+    for ( size_t s = 0; s < sample_count; ++s )
+    {
+      reference.apply ( make_input ( t, s ) );
+      expected_results[t * sample_count + s] = reference.get_value();
+    }
+  }
+
+  // every worker reads the same model and owns only its activations
+  my_network_t const& shared_model = model;
+
+  std::vector<my_network_t::context_t> contexts ( thread_count );
+  std::vector<std::thread> workers;
+
+  for ( size_t t = 0; t < thread_count; ++t )
+  {
+    workers.emplace_back ( [&shared_model, &contexts, &results, &make_input, t]
+    {
+      for ( size_t s = 0; s < sample_count; ++s )
+      {
+        shared_model.apply ( make_input ( t, s ), contexts[t] );
+        results[t * sample_count + s] = contexts[t].get_value();
+      }
+    } );
+  }
+
+  for ( auto& worker : workers )
+  {
+    worker.join();
+  }
+
+  assert ( results == expected_results );
+
+  // the contexts do not share cache lines
+  static_assert ( sizeof ( my_network_t::context_t ) % 64 == 0 );
+  static_assert ( alignof ( my_line_1_t::context_t ) == 64 );
+
+  // the line context works the same way
+  my_line_1_t::context_t line_context;
+
+  shared_model.get_line<0>().apply ( make_input ( 0, 0 ), line_context );
+  reference.get_line<0>().apply ( make_input ( 0, 0 ) );
+
+  assert ( line_context.get_value() == reference.get_line<0>().get_value() );
+}
+
+// a wide line is applied by every context on its own thread, also from inside a chunk of the default pool
+void smoke_test_shared_wide_network()
+{
+  using input_t = int;
+  using my_line_1_t = nnet::neuron_line_t<input_t, 1024, 256>;
+  using my_line_2_t = nnet::neuron_line_t<input_t, 256, 4>;
+  using my_network_t = nnet::neuron_network_t<my_line_1_t, my_line_2_t>;
+
+  static_assert ( my_line_1_t::input_dimension * my_line_1_t::line_dimension
+                  >= nnet::neuron_line_details::parallel_threshold );
+
+  constexpr size_t const thread_count = 3;
+
+  // the model is too large for the stack
+  auto const model = std::make_unique<my_network_t>();
+
+  set_test_koefs ( model->get_line<0>(), 6 );
+  set_test_koefs ( model->get_line<1>(), 7 );
+
+  std::vector<my_network_t::input_array_t> inputs ( thread_count );
+
+  for ( size_t t = 0; t < thread_count; ++t )
+  {
+    for ( size_t j = 0; j < my_network_t::input_dimension; ++j )
+    {
+      inputs[t][j] = static_cast<input_t> ( ( t + j ) % 5 ) - 2;
+    }
+  }
+
+  // the single-threaded apply splits the wide line across the pool
+  std::vector<my_network_t::output_array_t> expected_results ( thread_count );
+
+  for ( size_t t = 0; t < thread_count; ++t )
+  {
+    model->apply ( inputs[t] );
+    expected_results[t] = model->get_value();
+  }
+
+  my_network_t const& shared_model = *model;
+
+  std::vector<my_network_t::context_t> contexts ( thread_count );
+  std::vector<std::thread> workers;
+
+  for ( size_t t = 0; t < thread_count; ++t )
+  {
+    workers.emplace_back ( [&shared_model, &contexts, &inputs, t]
+    {
+      shared_model.apply ( inputs[t], contexts[t] );
+    } );
+  }
+
+  for ( auto& worker : workers )
+  {
+    worker.join();
+  }
+
+  for ( size_t t = 0; t < thread_count; ++t )
+  {
+    assert ( contexts[t].get_value() == expected_results[t] );
+  }
+
+  std::vector<my_network_t::context_t> pool_contexts ( thread_count );
+
+  thread_pool_utils::thread_pool_t::get_default_pool().parallel_for ( 0, thread_count, 1,
+      [&shared_model, &pool_contexts, &inputs] ( size_t begin, size_t end )
+  {
+    for ( size_t t = begin; t < end; ++t )
+    {
+      shared_model.apply ( inputs[t], pool_contexts[t] );
+    }
+  } );
+
+  for ( size_t t = 0; t < thread_count; ++t )
+  {
+    assert ( pool_contexts[t].get_value() == expected_results[t] );
+  }
+}
+
+} // namespace anonymous
+
+void test_neuron_network()
+{
+  smoke_test_neuron_network_single_line();
+
+  smoke_test_neuron_network();
+
+  smoke_test_shared_network();
+
+  smoke_test_shared_wide_network();
+}
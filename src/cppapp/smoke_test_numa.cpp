@@ -0,0 +1,149 @@
+#include <cppapp/smoke_test_numa.h>
+
+#include <nnet/numa_line.h>
+#include <nnet/neuron_line.h>
+#include <utils/numa.h>
+#include <utils/thread_pool.h>
+
+#include <cassert>
+#include <atomic>
+#include <array>
+#include <memory>
+#include <vector>
+
+namespace
+{
+
+void smoke_test_cpu_list()
+{
+  using numa_utils::numa_details::parse_cpu_list;
+
+  assert ( parse_cpu_list ( "" ).empty() );
+  assert ( ( parse_cpu_list ( "3" ) == std::vector<size_t> {3} ) );
+  assert ( ( parse_cpu_list ( "0-3,8,10-11" ) == std::vector<size_t> {0, 1, 2, 3, 8, 10, 11} ) );
+}
+
+void smoke_test_topology()
+{
+  auto const topology = numa_utils::numa_topology_t::detect();
+  assert ( topology.get_node_count() > 0 );
+  assert ( topology.get_cpu_count() >= topology.get_node_count() );
+
+  // the fake nodes exist even with fewer cpus than nodes
+  auto const fake = numa_utils::numa_topology_t::fake ( 3 );
+  assert ( fake.get_node_count() == 3 );
+
+  for ( size_t n = 0; n < fake.get_node_count(); ++n )
+  {
+    assert ( fake.nodes[n].id == n );
+    assert ( !fake.nodes[n].cpus.empty() );
+  }
+}
+
+void smoke_test_pinned_pool()
+{
+  cpu_set_t caller_set;
+  auto const got_caller_set = pthread_getaffinity_np ( pthread_self(), sizeof ( caller_set ), &caller_set ) == 0;
+  assert ( got_caller_set );
+
+  auto const topology = numa_utils::numa_topology_t::fake ( 2 );
+  auto const pool = numa_utils::make_pinned_pool ( topology, 4 );
+  assert ( pool->get_thread_count() == 4 );
+
+  // the calling thread is slot 0, the first cpu of the first node
+  assert ( numa_utils::numa_details::allowed_cpus() == std::vector<size_t> { topology.nodes[0].cpus[0] } );
+
+  std::array<std::atomic<size_t>, 2> node_chunks{};
+
+  pool->parallel_for ( 0, 64, 1, [&node_chunks] ( size_t, size_t )
+  {
+    auto const node = numa_utils::get_current_node();
+    assert ( node < 2 );
+    ++node_chunks[node];
+  } );
+
+  assert ( node_chunks[0] + node_chunks[1] == 64 );
+
+  // the worker_init runs on every worker before any chunk
+  std::atomic<size_t> init_count{};
+  {
+    thread_pool_utils::thread_pool_t counted ( 3, [&init_count] ( size_t i )
+    {
+      assert ( i >= 1 && i < 3 );
+      ++init_count;
+    } );
+
+    counted.parallel_for ( 0, 8, 1, [] ( size_t, size_t ) {} );
+  }
+  assert ( init_count == 2 );
+
+  // the other tests run on every cpu again
+  if ( got_caller_set )
+  {
+    pthread_setaffinity_np ( pthread_self(), sizeof ( caller_set ), &caller_set );
+  }
+}
+
+template<bool HUGE_PAGES>
+void smoke_test_numa_line()
+{
+  constexpr size_t input_dimension = 96;
+  constexpr size_t line_dimension = 1000;
+
+  using line_t = nnet::neuron_line_t<int, input_dimension, line_dimension>;
+
+  auto line = std::make_unique<line_t>();
+
+  for ( size_t k = 0; k < line_dimension; ++k )
+  {
+    line_t::neuron_t::koef_array_t koefs{};
+
+    for ( size_t i = 0; i < input_dimension; ++i )
+    {
+      koefs[i] = static_cast<int> ( ( k * 3 + i * 5 ) % 9 ) - 4;
+    }
+
+    line->set_koefs ( k, koefs );
+  }
+
+  line_t::input_array_t input{};
+
+  for ( size_t i = 0; i < input_dimension; ++i )
+  {
+    input[i] = static_cast<int> ( i % 7 ) - 3;
+  }
+
+  auto const topology = numa_utils::numa_topology_t::fake ( 2 );
+  auto const pool = numa_utils::make_pinned_pool ( topology, 4 );
+
+  nnet::numa_line_t<line_t> numa_line ( *line, *pool, topology, HUGE_PAGES );
+  assert ( numa_line.is_valid() );
+  assert ( numa_line.get_replica_count() == 2 );
+
+  // the replicas are copies in their own memory
+  for ( size_t n = 0; n < numa_line.get_replica_count(); ++n )
+  {
+    assert ( &numa_line.get_replica ( n ) != line.get() );
+    assert ( std::equal ( line->koefs_data(), line->koefs_data() + input_dimension * line_dimension,
+                          numa_line.get_replica ( n ).koefs_data() ) );
+  }
+
+  line_t::output_array_t expected{};
+  line_t::output_array_t actual{};
+
+  line->apply ( input.data(), expected.data() );
+  numa_line.apply ( input, actual );
+
+  assert ( expected == actual );
+}
+
+} // namespace anonymous
+
+void test_numa()
+{
+  smoke_test_cpu_list();
+  smoke_test_topology();
+  smoke_test_pinned_pool();
+  smoke_test_numa_line<false>();
+  smoke_test_numa_line<true>();
+}
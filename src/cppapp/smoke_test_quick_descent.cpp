@@ -6,6 +6,7 @@
 #include <utils/target_functions.h>
 
 #include <cassert>
+#include <type_traits>
 
 namespace
 {
@@ -103,6 +104,107 @@ void smoke_test_quick_descent_gold_ratio()
   smoke_test_quick_descent_two_argument<noptim::find_minimum_method::gold_ratio> ( 30 );
 }
 
+// make_quick_descent keeps the lambda type, the result is the one of the std::function flavour
+template<noptim::find_minimum_method METHOD_ENUM>
+void smoke_test_quick_descent_callable()
+{
+  using my_quick_descent_t = noptim::quick_descent<METHOD_ENUM, double, double, double>;
+  using my_funct_args_t = typename my_quick_descent_t::funct_args_t;
+
+  target_function_utils::test_function_parabola_t my_f;
+
+  my_funct_args_t const min_point = {my_f.xa, my_f.ya};
+  my_funct_args_t const max_point = {my_f.xb, my_f.yb};
+
+  auto my_lambda = [&my_f] ( my_funct_args_t const & x )
+  {
+    return my_f ( x );
+  };
+
+  my_quick_descent_t erased_qd ( my_f.h, my_f.eps, min_point, max_point, my_f );
+  auto const typed_qd = noptim::make_quick_descent<METHOD_ENUM> ( my_f.h, my_f.eps, min_point, max_point, my_lambda );
+
+  static_assert ( std::is_same<typename decltype ( typed_qd ) ::target_function_t, decltype ( my_lambda ) >::value,
+                  "The lambda should be stored as is" );
+
+  noptim::find_minimum_t erased_stat;
+  noptim::find_minimum_t typed_stat;
+
+  assert ( erased_qd.find_minimum ( &erased_stat ) == typed_qd.find_minimum ( &typed_stat ) );
+  assert ( erased_stat.funct_invocation_count == typed_stat.funct_invocation_count );
+  assert ( erased_qd.get_gradient ( min_point ) == typed_qd.get_gradient ( min_point ) );
+}
+
+void smoke_test_quick_descent_brent()
+{
+  // test for the single argument function
+  smoke_test_quick_descent_single_argument<noptim::find_minimum_method::brent> ( 8 );
+
+  // test for the two argument function
+  smoke_test_quick_descent_two_argument<noptim::find_minimum_method::brent> ( 12 );
+}
+
+// a coupled quadratic, the single sweep of find_minimum stops off the minimum;
+// with the root outside the box the minimum is on the x bound
+template<noptim::find_minimum_method METHOD_ENUM, noptim::descent_method DESCENT_ENUM>
+void smoke_test_quick_descent_iterative()
+{
+  using my_funct_args_t = tuple_utils::funct_args_t<double, double>;
+
+  constexpr double eps = 1e-4;
+  constexpr double step = 1e-3;
+
+  my_funct_args_t const min_point = {-1.0, 0.0};
+  my_funct_args_t const max_point = {2.0, 6.0};
+
+  auto const make_coupled = [] ( double root_x, double root_y )
+  {
+    return [root_x, root_y] ( my_funct_args_t const & x )
+    {
+      auto const dx = std::get<0> ( x ) - root_x;
+      auto const dy = std::get<1> ( x ) - root_y;
+      return 3.0 * dx * dx + 4.0 * dy * dy + 3.0 * dx * dy + 10.0;
+    };
+  };
+
+  auto const qd = noptim::make_quick_descent<METHOD_ENUM> ( step, eps, min_point, max_point, make_coupled ( 1.0, 1.0 ) );
+  my_funct_args_t const expected_x_min = {1.0, 1.0};
+
+  noptim::find_minimum_t sweep_stat;
+  noptim::find_minimum_t stat;
+
+  auto const sweep_x_min = qd.find_minimum ( &sweep_stat );
+  auto const x_min = qd.template find_minimum_iterative<DESCENT_ENUM> ( 100, &stat );
+
+  assert ( tuple_utils::get_normus<double> ( sweep_x_min, expected_x_min ) > 10 * eps );
+  assert ( tuple_utils::get_normus<double> ( x_min, expected_x_min ) <= 10 * eps );
+  assert ( sweep_stat.iteration_count == 0 );
+  assert ( stat.iteration_count > 0 );
+  assert ( stat.iteration_count < 100 );
+  assert ( stat.funct_invocation_count > sweep_stat.funct_invocation_count );
+
+  // conjugate directions end a quadratic in as many steps as there are arguments, up to the line search
+  if constexpr ( DESCENT_ENUM == noptim::descent_method::conjugate_gradient )
+  {
+    assert ( stat.iteration_count <= 3 );
+  }
+
+  // 8 ( y - 1 ) + 3 ( 2 - 3 ) = 0 on the bound x = 2; the target exists on the box only,
+  // the gradient at the bound must not probe x = 2 + step
+  auto const bound_qd = noptim::make_quick_descent<METHOD_ENUM> ( step, eps, min_point, max_point,
+                        [coupled = make_coupled ( 3.0, 1.0 ), min_point, max_point] ( my_funct_args_t const & x )
+  {
+    assert ( std::get<0> ( x ) >= std::get<0> ( min_point ) && std::get<0> ( x ) <= std::get<0> ( max_point ) );
+    assert ( std::get<1> ( x ) >= std::get<1> ( min_point ) && std::get<1> ( x ) <= std::get<1> ( max_point ) );
+    return coupled ( x );
+  } );
+  my_funct_args_t const expected_bound_x_min = {2.0, 1.375};
+
+  auto const bound_x_min = bound_qd.template find_minimum_iterative<DESCENT_ENUM> ( 100 );
+
+  assert ( tuple_utils::get_normus<double> ( bound_x_min, expected_bound_x_min ) <= 10 * eps );
+}
+
 } // namespace anonymous
 
 void test_quick_descent()
@@ -110,4 +212,18 @@ void test_quick_descent()
   smoke_test_quick_descent_dichotomie();
 
   smoke_test_quick_descent_gold_ratio();
+
+  smoke_test_quick_descent_brent();
+
+  smoke_test_quick_descent_callable<noptim::find_minimum_method::dichotomie>();
+
+  smoke_test_quick_descent_callable<noptim::find_minimum_method::gold_ratio>();
+
+  smoke_test_quick_descent_callable<noptim::find_minimum_method::brent>();
+
+  smoke_test_quick_descent_iterative<noptim::find_minimum_method::gold_ratio, noptim::descent_method::steepest>();
+
+  smoke_test_quick_descent_iterative<noptim::find_minimum_method::gold_ratio, noptim::descent_method::conjugate_gradient>();
+
+  smoke_test_quick_descent_iterative<noptim::find_minimum_method::brent, noptim::descent_method::conjugate_gradient>();
 }
@@ -0,0 +1,245 @@
+#include <cppapp/smoke_test_recurrent.h>
+
+#include <nnet/recurrent.h>
+#include <nnet/neuron_line.h>
+#include <nnet/activation.h>
+
+#include <cassert>
+#include <cmath>
+#include <array>
+#include <vector>
+
+namespace
+{
+
+constexpr size_t input_dimension = 5;
+constexpr size_t hidden_dimension = 3;
+constexpr size_t length = 12;
+constexpr size_t batch = 4;
+
+using input_array_t = std::array<double, input_dimension>;
+using hidden_array_t = std::array<double, hidden_dimension>;
+
+// one line per gate over [x, 1] and one over h, the chain a timestep had before the fused cell
+struct reference_gate_t
+{
+  nnet::neuron_line_t<double, input_dimension + 1, hidden_dimension> input_line;
+  nnet::neuron_line_t<double, hidden_dimension, hidden_dimension> hidden_line;
+
+  hidden_array_t input_part ( input_array_t const& x ) const
+  {
+    std::array < double, input_dimension + 1 > extended{};
+    std::copy ( x.cbegin(), x.cend(), extended.begin() );
+    extended.back() = 1;
+
+    hidden_array_t result{};
+    input_line.apply ( extended.data(), result.data() );
+    return result;
+  }
+
+  hidden_array_t hidden_part ( hidden_array_t const& h ) const
+  {
+    hidden_array_t result{};
+    hidden_line.apply ( h.data(), result.data() );
+    return result;
+  }
+};
+
+double test_koef ( size_t gate, size_t unit, size_t i )
+{
+  return 0.1 * static_cast<double> ( static_cast<int> ( ( gate * 7 + unit * 5 + i * 3 ) % 11 ) - 5 );
+}
+
+// fills the cell and the per-gate reference lines with the same koefs, the bias goes to the input line
+template<typename CELL_T>
+void set_koefs ( CELL_T& cell, std::array<reference_gate_t, 4>& reference )
+{
+  for ( size_t gate = 0; gate < 4; ++gate )
+  {
+    for ( size_t unit = 0; unit < hidden_dimension; ++unit )
+    {
+      input_array_t input_koefs{};
+      hidden_array_t hidden_koefs{};
+      std::array < double, input_dimension + 1 > input_line_koefs{};
+      hidden_array_t hidden_line_koefs{};
+
+      for ( size_t i = 0; i < input_dimension; ++i )
+      {
+        input_koefs[i] = test_koef ( gate, unit, i );
+        input_line_koefs[i] = input_koefs[i];
+      }
+
+      for ( size_t i = 0; i < hidden_dimension; ++i )
+      {
+        hidden_koefs[i] = test_koef ( gate, unit, input_dimension + i );
+        hidden_line_koefs[i] = hidden_koefs[i];
+      }
+
+      auto const bias = test_koef ( gate, unit, 100 );
+      input_line_koefs.back() = bias;
+
+      cell.set_gate_koefs ( static_cast<typename CELL_T::gate_t> ( gate ), unit, input_koefs, hidden_koefs, bias );
+      reference[gate].input_line.set_koefs ( unit, input_line_koefs );
+      reference[gate].hidden_line.set_koefs ( unit, hidden_line_koefs );
+    }
+  }
+}
+
+input_array_t test_input ( size_t t, size_t sequence )
+{
+  input_array_t x{};
+
+  for ( size_t i = 0; i < input_dimension; ++i )
+  {
+    x[i] = std::sin ( 0.3 * static_cast<double> ( t * input_dimension + i ) + static_cast<double> ( sequence ) );
+  }
+
+  return x;
+}
+
+void reference_lstm_step ( std::array<reference_gate_t, 4> const& reference, input_array_t const& x,
+                           hidden_array_t& h, hidden_array_t& c )
+{
+  std::array<hidden_array_t, 4> a{};
+
+  for ( size_t gate = 0; gate < 4; ++gate )
+  {
+    auto const xi = reference[gate].input_part ( x );
+    auto const hi = reference[gate].hidden_part ( h );
+
+    for ( size_t k = 0; k < hidden_dimension; ++k )
+    {
+      a[gate][k] = xi[k] + hi[k];
+    }
+  }
+
+  for ( size_t k = 0; k < hidden_dimension; ++k )
+  {
+    auto const i = nnet::activation::sigmoid_t::apply ( a[0][k] );
+    auto const f = nnet::activation::sigmoid_t::apply ( a[1][k] );
+    auto const g = std::tanh ( a[2][k] );
+    auto const o = nnet::activation::sigmoid_t::apply ( a[3][k] );
+
+    c[k] = f * c[k] + i * g;
+    h[k] = o * std::tanh ( c[k] );
+  }
+}
+
+// the candidate input block carries b_n, the candidate hidden block carries b_hn
+void reference_gru_step ( std::array<reference_gate_t, 4> const& reference, input_array_t const& x, hidden_array_t& h )
+{
+  auto const zx = reference[0].input_part ( x );
+  auto const zh = reference[0].hidden_part ( h );
+  auto const rx = reference[1].input_part ( x );
+  auto const rh = reference[1].hidden_part ( h );
+  auto const nx = reference[2].input_part ( x );
+
+  // the hidden block of the candidate has no input koefs but keeps its bias
+  input_array_t const zero{};
+  auto const nh_bias = reference[3].input_part ( zero );
+  auto const nh = reference[3].hidden_part ( h );
+
+  for ( size_t k = 0; k < hidden_dimension; ++k )
+  {
+    auto const z = nnet::activation::sigmoid_t::apply ( zx[k] + zh[k] );
+    auto const r = nnet::activation::sigmoid_t::apply ( rx[k] + rh[k] );
+    auto const n = std::tanh ( nx[k] + r * ( nh[k] + nh_bias[k] ) );
+
+    h[k] = ( 1 - z ) * n + z * h[k];
+  }
+}
+
+template<nnet::cell_method METHOD_ENUM>
+void smoke_test_recurrent_cell()
+{
+  using cell_t = nnet::recurrent_cell_t<METHOD_ENUM, double, input_dimension, hidden_dimension>;
+
+  static_assert ( cell_t::gate_dimension == 4 * hidden_dimension, "All the gates are one line" );
+
+  cell_t cell;
+  std::array<reference_gate_t, 4> reference{};
+  set_koefs ( cell, reference );
+
+  std::vector<input_array_t> inputs ( length * batch );
+
+  for ( size_t t = 0; t < length; ++t )
+  {
+    for ( size_t b = 0; b < batch; ++b )
+    {
+      inputs[t * batch + b] = test_input ( t, b );
+    }
+  }
+
+  // one sequence against the per-gate lines
+  std::vector<input_array_t> sequence ( length );
+
+  for ( size_t t = 0; t < length; ++t )
+  {
+    sequence[t] = inputs[t * batch];
+  }
+
+  typename cell_t::state_t state;
+  std::vector<double> hidden_outputs ( length * hidden_dimension );
+  cell.run_sequence ( sequence.data(), length, state, hidden_outputs.data() );
+
+  hidden_array_t h{};
+  hidden_array_t c{};
+
+  for ( size_t t = 0; t < length; ++t )
+  {
+    if constexpr ( METHOD_ENUM == nnet::cell_method::lstm )
+    {
+      reference_lstm_step ( reference, sequence[t], h, c );
+    }
+    else
+    {
+      reference_gru_step ( reference, sequence[t], h );
+    }
+
+    for ( size_t k = 0; k < hidden_dimension; ++k )
+    {
+      assert ( std::fabs ( hidden_outputs[t * hidden_dimension + k] - h[k] ) < 1e-12 );
+    }
+  }
+
+  for ( size_t k = 0; k < hidden_dimension; ++k )
+  {
+    assert ( state.get_hidden() [k] == hidden_outputs[ ( length - 1 ) * hidden_dimension + k] );
+  }
+
+  // the batched sequences match the sequences run one by one
+  typename cell_t::template batch_state_t<batch> batch_state;
+  cell.run_sequence_batch ( inputs.data(), length, batch_state );
+
+  for ( size_t b = 0; b < batch; ++b )
+  {
+    typename cell_t::state_t single;
+
+    for ( size_t t = 0; t < length; ++t )
+    {
+      cell.step ( inputs[t * batch + b], single );
+    }
+
+    for ( size_t k = 0; k < hidden_dimension; ++k )
+    {
+      assert ( std::fabs ( batch_state.get_hidden ( b ) [k] - single.get_hidden() [k] ) < 1e-12 );
+    }
+  }
+
+  // a reset state starts the sequence over
+  state.reset();
+  cell.run_sequence ( sequence.data(), length, state );
+
+  for ( size_t k = 0; k < hidden_dimension; ++k )
+  {
+    assert ( state.get_hidden() [k] == hidden_outputs[ ( length - 1 ) * hidden_dimension + k] );
+  }
+}
+
+} // namespace anonymous
+
+void test_recurrent()
+{
+  smoke_test_recurrent_cell<nnet::cell_method::lstm>();
+  smoke_test_recurrent_cell<nnet::cell_method::gru>();
+}
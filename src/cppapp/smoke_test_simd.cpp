@@ -0,0 +1,233 @@
+#include <cppapp/smoke_test_simd.h>
+
+#include <nnet/simd.h>
+#include <nnet/half.h>
+
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+namespace
+{
+
+template<typename T>
+bool is_close ( T const value, T const expected_value )
+{
+  if constexpr ( std::is_floating_point<T>::value )
+  {
+    auto const eps = std::is_same<T, float>::value ? 1e-4 : 1e-12;
+    return std::fabs ( value - expected_value ) <= eps * ( 1.0 + std::fabs ( expected_value ) );
+  }
+  else
+  {
+    return value == expected_value;
+  }
+}
+
+template<typename T>
+void smoke_test_dot_X ( nnet::simd::isa const instruction_set )
+{
+  constexpr size_t max_size = 1031;
+
+  // one element of the headroom to check the unaligned access as well
+  std::vector<T> a ( max_size + 1 );
+  std::vector<T> b ( max_size + 1 );
+
+  for ( size_t i = 0; i < a.size(); ++i )
+  {
+    a[i] = static_cast<T> ( static_cast<int> ( i * 7 % 19 ) - 9 ) / static_cast<T> ( 4 );
+    b[i] = static_cast<T> ( static_cast<int> ( i * 5 % 23 ) - 11 ) / static_cast<T> ( 2 );
+  }
+
+  auto const kernel = nnet::simd::get_dot_kernel<T> ( instruction_set );
+
+  for ( size_t offset = 0; offset < 2; ++offset )
+  {
+    for ( size_t n = 0; n < max_size; n = ( n < 70 ) ? n + 1 : n * 2 + 1 )
+    {
+      T const expected_value = std::inner_product ( a.data() + offset, a.data() + offset + n, b.data(), T{} );
+
+      assert ( is_close ( kernel ( a.data() + offset, b.data(), n ), expected_value ) );
+    }
+  }
+}
+
+template<typename T, nnet::simd::diff_norm NORM>
+void smoke_test_diff_sum_X ( nnet::simd::isa const instruction_set )
+{
+  constexpr size_t max_size = 1031;
+
+  std::vector<T> a ( max_size + 1 );
+  std::vector<T> b ( max_size + 1 );
+
+  for ( size_t i = 0; i < a.size(); ++i )
+  {
+    a[i] = static_cast<T> ( static_cast<int> ( i * 7 % 19 ) - 9 ) / static_cast<T> ( 4 );
+    b[i] = static_cast<T> ( static_cast<int> ( i * 5 % 23 ) - 11 ) / static_cast<T> ( 2 );
+  }
+
+  auto const kernel = nnet::simd::get_diff_sum_kernel<T, NORM> ( instruction_set );
+
+  for ( size_t offset = 0; offset < 2; ++offset )
+  {
+    for ( size_t n = 0; n < max_size; n = ( n < 70 ) ? n + 1 : n * 2 + 1 )
+    {
+      T expected_value{};
+
+      for ( size_t i = 0; i < n; ++i )
+      {
+        auto const d = a[offset + i] - b[i];
+        expected_value += ( NORM == nnet::simd::diff_norm::squared ) ? d * d : std::fabs ( d );
+      }
+
+      assert ( is_close ( kernel ( a.data() + offset, b.data(), n ), expected_value ) );
+    }
+  }
+}
+
+void smoke_test_dot_u8s8_X ( nnet::simd::isa const instruction_set )
+{
+  constexpr size_t max_size = 1031;
+
+  std::vector<uint8_t> a ( max_size + 1 );
+  std::vector<int8_t> b ( max_size + 1 );
+
+  // the extreme values check that no int16 pair sum saturates
+  for ( size_t i = 0; i < a.size(); ++i )
+  {
+    a[i] = ( i % 3 == 0 ) ? 255 : static_cast<uint8_t> ( i * 37 % 256 );
+    b[i] = ( i % 5 == 0 ) ? -128 : ( i % 5 == 1 ) ? 127 : static_cast<int8_t> ( i * 11 % 256 - 128 );
+  }
+
+  auto const kernel = nnet::simd::get_dot_u8s8_kernel ( instruction_set );
+  auto const reference_kernel = nnet::simd::get_dot_u8s8_kernel ( nnet::simd::isa::scalar );
+
+  for ( size_t offset = 0; offset < 2; ++offset )
+  {
+    for ( size_t n = 0; n < max_size; n = ( n < 130 ) ? n + 1 : n * 2 + 1 )
+    {
+      assert ( kernel ( a.data() + offset, b.data(), n ) == reference_kernel ( a.data() + offset, b.data(), n ) );
+    }
+  }
+}
+
+template<typename HALF_T>
+void smoke_test_dot_half_X ( nnet::simd::isa const instruction_set )
+{
+  constexpr size_t max_size = 1031;
+
+  std::vector<float> a ( max_size + 1 );
+  std::vector<HALF_T> b ( max_size + 1 );
+
+  // the koefs are exact in both formats, so every kernel matches the float dot
+  std::vector<float> float_b ( max_size + 1 );
+
+  for ( size_t i = 0; i < a.size(); ++i )
+  {
+    a[i] = static_cast<float> ( static_cast<int> ( i * 7 % 19 ) - 9 ) / 4.0f;
+    float_b[i] = static_cast<float> ( static_cast<int> ( i * 5 % 23 ) - 11 ) / 2.0f;
+    b[i] = HALF_T::from_float ( float_b[i] );
+  }
+
+  auto const kernel = nnet::simd::get_dot_half_kernel<HALF_T> ( instruction_set );
+
+  for ( size_t offset = 0; offset < 2; ++offset )
+  {
+    for ( size_t n = 0; n < max_size; n = ( n < 70 ) ? n + 1 : n * 2 + 1 )
+    {
+      float const expected_value = std::inner_product ( a.data() + offset, a.data() + offset + n, float_b.data(), 0.0f );
+
+      assert ( is_close ( kernel ( a.data() + offset, b.data(), n ), expected_value ) );
+    }
+  }
+}
+
+void smoke_test_half_conversion()
+{
+  using nnet::bf16_t;
+  using nnet::fp16_t;
+
+  for ( float const x : {0.0f, -0.0f, 1.0f, -2.5f, 0.15625f, 65504.0f, 6.103515625e-5f, 5.9604644775390625e-8f} )
+  {
+    assert ( x == fp16_t::from_float ( x ).to_float() );
+  }
+
+  for ( float const x : {0.0f, 1.0f, -2.5f, 3.0e38f, 1.0e-38f} )
+  {
+    auto const y = bf16_t::from_float ( x ).to_float();
+    assert ( std::fabs ( y - x ) <= std::fabs ( x ) / 256.0f );
+  }
+
+  // every non nan pattern round-trips through float
+  for ( uint32_t bits = 0; bits <= 0xffff; ++bits )
+  {
+    fp16_t const h{static_cast<uint16_t> ( bits )};
+    bf16_t const b{static_cast<uint16_t> ( bits )};
+
+    assert ( std::isnan ( h.to_float() ) || h.bits == fp16_t::from_float ( h.to_float() ).bits );
+    assert ( std::isnan ( b.to_float() ) || b.bits == bf16_t::from_float ( b.to_float() ).bits );
+  }
+
+  // round to nearest even at the halfway points
+  assert ( 0x3c00 == fp16_t::from_float ( 1.0f + 1.0f / 2048.0f ).bits );
+  assert ( 0x3c02 == fp16_t::from_float ( 1.0f + 3.0f / 2048.0f ).bits );
+  assert ( 0x3f80 == bf16_t::from_float ( 1.0f + 1.0f / 256.0f ).bits );
+  assert ( 0x3f82 == bf16_t::from_float ( 1.0f + 3.0f / 256.0f ).bits );
+
+  // overflow, subnormals and specials
+  assert ( 0x7c00 == fp16_t::from_float ( 65520.0f ).bits );
+  assert ( 0x0001 == fp16_t::from_float ( 5.9604644775390625e-8f ).bits );
+  assert ( 0x0000 == fp16_t::from_float ( 2.9802322387695312e-8f ).bits );
+  assert ( 0x8000 == fp16_t::from_float ( -1.0e-10f ).bits );
+  assert ( std::isinf ( fp16_t::from_float ( std::numeric_limits<float>::infinity() ).to_float() ) );
+  assert ( std::isnan ( fp16_t::from_float ( std::numeric_limits<float>::quiet_NaN() ).to_float() ) );
+  assert ( std::isnan ( bf16_t::from_float ( std::numeric_limits<float>::quiet_NaN() ).to_float() ) );
+}
+
+void smoke_test_dot()
+{
+  auto const detected_isa = nnet::simd::get_isa();
+
+  for ( auto const instruction_set :
+        {
+          nnet::simd::isa::scalar, nnet::simd::isa::sse2, nnet::simd::isa::avx2, nnet::simd::isa::avx512,
+          nnet::simd::isa::avx512_vnni
+        } )
+  {
+    if ( instruction_set > detected_isa )
+    {
+      break;
+    }
+
+    smoke_test_dot_X<float> ( instruction_set );
+    smoke_test_dot_X<double> ( instruction_set );
+    smoke_test_dot_X<int32_t> ( instruction_set );
+    smoke_test_dot_u8s8_X ( instruction_set );
+    smoke_test_dot_half_X<nnet::bf16_t> ( instruction_set );
+    smoke_test_dot_half_X<nnet::fp16_t> ( instruction_set );
+    smoke_test_diff_sum_X<float, nnet::simd::diff_norm::squared> ( instruction_set );
+    smoke_test_diff_sum_X<float, nnet::simd::diff_norm::absolute> ( instruction_set );
+    smoke_test_diff_sum_X<double, nnet::simd::diff_norm::squared> ( instruction_set );
+    smoke_test_diff_sum_X<double, nnet::simd::diff_norm::absolute> ( instruction_set );
+  }
+
+  {
+    constexpr std::array<int32_t, 3> const a = {1, 2, 3};
+    constexpr std::array<int32_t, 3> const b = {4, 5, 6};
+
+    assert ( 32 == nnet::simd::dot ( a.data(), b.data(), a.size() ) );
+  }
+}
+
+} // namespace anonymous
+
+void test_simd()
+{
+  smoke_test_dot();
+
+  smoke_test_half_conversion();
+}
@@ -0,0 +1,202 @@
+#include <cppapp/smoke_test_thread_pool.h>
+
+#include <utils/thread_pool.h>
+#include <nnet/neuron_line.h>
+
+#include <cassert>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <algorithm>
+
+namespace
+{
+
+void smoke_test_parallel_for()
+{
+  thread_pool_utils::thread_pool_t pool ( 4 );
+
+  assert ( 4 == pool.get_thread_count() );
+
+  constexpr size_t const size = 1000;
+
+  for ( size_t chunk_size : {1, 7, 64, 1000, 5000} )
+  {
+    std::vector<int> hits ( size );
+    std::atomic<size_t> chunk_count{};
+
+    pool.parallel_for ( 0, size, chunk_size, [&hits, &chunk_count] ( size_t begin, size_t end )
+    {
+      for ( size_t i = begin; i < end; ++i )
+      {
+        hits[i]++;
+      }
+
+      chunk_count++;
+    } );
+
+    for ( auto const hit : hits )
+    {
+      assert ( 1 == hit );
+    }
+
+    assert ( ( size + chunk_size - 1 ) / chunk_size == chunk_count );
+  }
+
+  // an empty range returns at once
+  pool.parallel_for ( 5, 5, 1, [] ( size_t, size_t )
+  {
+    assert ( false );
+  } );
+}
+
+template<nnet::line_layout LAYOUT>
+void smoke_test_wide_line()
+{
+  constexpr size_t input_dimension = 1024;
+  constexpr size_t line_dimension = 512;
+  constexpr size_t batch_size = 9;
+
+  using my_neuron_line_t = nnet::neuron_line_t<int, input_dimension, line_dimension, LAYOUT>;
+
+  static_assert ( input_dimension * line_dimension >= nnet::neuron_line_details::parallel_threshold );
+
+  // the line is too large for the stack
+  auto const neuron_line = std::make_unique<my_neuron_line_t>();
+
+  for ( size_t i = 0; i < line_dimension; ++i )
+  {
+    typename my_neuron_line_t::neuron_t::koef_array_t koefs{};
+
+    for ( size_t j = 0; j < input_dimension; ++j )
+    {
+      koefs[j] = static_cast<int> ( ( i * 7 + j * 3 ) % 11 ) - 5;
+    }
+
+    neuron_line->set_koefs ( i, koefs );
+  }
+
+  auto const inputs = std::make_unique<std::array<typename my_neuron_line_t::input_array_t, batch_size>>();
+
+  for ( size_t k = 0; k < batch_size; ++k )
+  {
+    for ( size_t j = 0; j < input_dimension; ++j )
+    {
+      ( *inputs ) [k][j] = static_cast<int> ( ( k * 5 + j ) % 13 ) - 6;
+    }
+  }
+
+  std::vector<int> outputs ( batch_size * line_dimension );
+
+  neuron_line->apply_batch ( inputs->data(), batch_size, outputs.data() );
+
+  std::vector<int> parallel_values ( line_dimension );
+  std::vector<int> serial_values ( line_dimension );
+
+  for ( size_t k = 0; k < batch_size; ++k )
+  {
+    // the neuron views below write into the same values, so the parallel result is copied first
+    neuron_line->apply ( ( *inputs ) [k] );
+    std::copy ( neuron_line->get_value().cbegin(), neuron_line->get_value().cend(), parallel_values.begin() );
+
+    // the single neuron path is the serial reference
+    for ( size_t i = 0; i < line_dimension; ++i )
+    {
+      ( *neuron_line ) [i].apply ( ( *inputs ) [k] );
+      serial_values[i] = ( *neuron_line ) [i].get_value();
+    }
+
+    for ( size_t i = 0; i < line_dimension; ++i )
+    {
+      assert ( serial_values[i] == parallel_values[i] );
+      assert ( serial_values[i] == outputs[k * line_dimension + i] );
+    }
+  }
+}
+
+// a parallel_for from inside a chunk of the same pool, on a worker or on the calling thread,
+// runs inline instead of waiting for the outer call to finish
+void smoke_test_nested_parallel_for()
+{
+  thread_pool_utils::thread_pool_t pool ( 4 );
+
+  constexpr size_t const outer_size = 16;
+  constexpr size_t const inner_size = 100;
+
+  std::vector<int> hits ( outer_size * inner_size );
+
+  pool.parallel_for ( 0, outer_size, 1, [&pool, &hits] ( size_t begin, size_t end )
+  {
+    for ( size_t i = begin; i < end; ++i )
+    {
+      pool.parallel_for ( 0, inner_size, 7, [&hits, i] ( size_t inner_begin, size_t inner_end )
+      {
+        for ( size_t j = inner_begin; j < inner_end; ++j )
+        {
+          hits[i * inner_size + j]++;
+        }
+      } );
+    }
+  } );
+
+  for ( auto const hit : hits )
+  {
+    assert ( 1 == hit );
+  }
+
+  // a wide line calls the default pool from inside a chunk of the default pool
+  constexpr size_t input_dimension = 1024;
+  constexpr size_t line_dimension = 256;
+
+  using my_neuron_line_t = nnet::neuron_line_t<int, input_dimension, line_dimension>;
+
+  static_assert ( input_dimension * line_dimension >= nnet::neuron_line_details::parallel_threshold );
+
+  auto const neuron_line = std::make_unique<my_neuron_line_t>();
+  typename my_neuron_line_t::neuron_t::koef_array_t koefs{};
+  typename my_neuron_line_t::input_array_t input{};
+
+  for ( size_t j = 0; j < input_dimension; ++j )
+  {
+    koefs[j] = static_cast<int> ( j % 5 ) - 2;
+    input[j] = static_cast<int> ( j % 3 ) - 1;
+  }
+
+  for ( size_t i = 0; i < line_dimension; ++i )
+  {
+    neuron_line->set_koefs ( i, koefs );
+  }
+
+  my_neuron_line_t::output_array_t expected{};
+  neuron_line->apply_range ( input.data(), expected.data(), 0, line_dimension );
+
+  constexpr size_t const task_count = 8;
+  std::vector<my_neuron_line_t::output_array_t> results ( task_count );
+
+  thread_pool_utils::thread_pool_t::get_default_pool().parallel_for ( 0, task_count, 1,
+      [&neuron_line, &input, &results] ( size_t begin, size_t end )
+  {
+    for ( size_t t = begin; t < end; ++t )
+    {
+      neuron_line->apply ( input.data(), results[t].data() );
+    }
+  } );
+
+  for ( auto const& result : results )
+  {
+    assert ( expected == result );
+  }
+}
+
+} // namespace anonymous
+
+void test_thread_pool()
+{
+  smoke_test_parallel_for();
+
+  smoke_test_nested_parallel_for();
+
+  smoke_test_wide_line<nnet::line_layout::row_major>();
+
+  smoke_test_wide_line<nnet::line_layout::column_major>();
+}
@@ -0,0 +1,206 @@
+#include <cppapp/smoke_test_trainer.h>
+
+#include <nnet/neuron_line.h>
+#include <nnet/neuron_network.h>
+#include <nnet/backprop.h>
+#include <noptim/trainer.h>
+
+#include <cassert>
+#include <cmath>
+#include <array>
+
+namespace
+{
+
+using input_t = double;
+using my_hidden_line_t = nnet::neuron_line_t<input_t, 3, 4, nnet::line_layout::row_major, nnet::activation::tanh_t>;
+using my_output_line_t = nnet::neuron_line_t<input_t, 4, 2, nnet::line_layout::column_major, nnet::activation::identity_t>;
+using my_network_t = nnet::neuron_network_t<my_hidden_line_t, my_output_line_t>;
+
+constexpr size_t const sample_count = 64;
+
+template<typename LINE_T>
+void set_test_koefs ( LINE_T& line, size_t const seed )
+{
+  for ( size_t i = 0; i < LINE_T::line_dimension; ++i )
+  {
+    typename LINE_T::neuron_t::koef_array_t koefs{};
+
+    for ( size_t j = 0; j < LINE_T::input_dimension; ++j )
+    {
+      koefs[j] = 0.2 * ( static_cast<double> ( ( i * 5 + j * 3 + seed ) % 11 ) - 5.0 );
+    }
+
+    line.set_koefs ( i, koefs );
+  }
+}
+
+template<typename MODEL_T>
+void make_data_set ( MODEL_T& teacher,
+                     std::array<typename MODEL_T::input_array_t, sample_count>& inputs,
+                     std::array<typename MODEL_T::output_array_t, sample_count>& expected_values )
+{
+  for ( size_t s = 0; s < sample_count; ++s )
+  {
+    for ( size_t j = 0; j < inputs[s].size(); ++j )
+    {
+      inputs[s][j] = 0.1 * ( static_cast<double> ( ( s * 7 + j * 13 ) % 21 ) - 10.0 );
+    }
+
+    teacher.apply ( inputs[s] );
+    expected_values[s] = teacher.get_value();
+  }
+}
+
+double network_loss ( my_network_t& network,
+                      my_network_t::input_array_t const& input,
+                      my_network_t::output_array_t const& expected_value )
+{
+  network.apply ( input );
+
+  double loss{};
+
+  for ( size_t k = 0; k < expected_value.size(); ++k )
+  {
+    loss += ( network.get_value() [k] - expected_value[k] ) * ( network.get_value() [k] - expected_value[k] );
+  }
+
+  return loss;
+}
+
+template<size_t Index>
+void check_gradient ( my_network_t& network,
+                      nnet::backprop_t<my_network_t> const& backprop,
+                      my_network_t::input_array_t const& input,
+                      my_network_t::output_array_t const& expected_value )
+{
+  constexpr double const h = 1e-6;
+  constexpr double const eps = 1e-6;
+
+  auto* koefs = network.get_line<Index>().koefs_data();
+  auto const& gradient = backprop.get_gradient<Index>();
+
+  for ( size_t i = 0; i < gradient.size(); ++i )
+  {
+    auto const koef = koefs[i];
+
+    koefs[i] = koef + h;
+    auto const loss_plus = network_loss ( network, input, expected_value );
+    koefs[i] = koef - h;
+    auto const loss_minus = network_loss ( network, input, expected_value );
+    koefs[i] = koef;
+
+    auto const expected_gradient = ( loss_plus - loss_minus ) / ( 2.0 * h );
+
+    assert ( fabs ( gradient[i] - expected_gradient ) <= eps * ( 1.0 + fabs ( expected_gradient ) ) );
+  }
+}
+
+void smoke_test_backprop()
+{
+  my_network_t network;
+
+  set_test_koefs ( network.get_line<0>(), 1 );
+  set_test_koefs ( network.get_line<1>(), 4 );
+
+  constexpr my_network_t::input_array_t const input = {0.3, -0.7, 0.5};
+  constexpr my_network_t::output_array_t const expected_value = {0.25, -0.5};
+
+  nnet::backprop_t<my_network_t> backprop;
+
+  backprop.forward ( network, input );
+
+  network.apply ( input );
+  assert ( network.get_value() == backprop.get_value() );
+
+  my_network_t::output_array_t output_gradient{};
+
+  for ( size_t k = 0; k < output_gradient.size(); ++k )
+  {
+    output_gradient[k] = 2.0 * ( backprop.get_value() [k] - expected_value[k] );
+  }
+
+  backprop.zero_gradient();
+  backprop.backward ( network, input, output_gradient.data() );
+
+  check_gradient<0> ( network, backprop, input, expected_value );
+  check_gradient<1> ( network, backprop, input, expected_value );
+}
+
+template<noptim::train_method METHOD_ENUM>
+void smoke_test_train_line ( double const learning_rate, size_t const epoch_count, double const expected_loss )
+{
+  using my_line_t = nnet::neuron_line_t<input_t, 3, 2>;
+
+  my_line_t teacher;
+  set_test_koefs ( teacher, 2 );
+
+  std::array<my_line_t::input_array_t, sample_count> inputs{};
+  std::array<my_line_t::output_array_t, sample_count> expected_values{};
+  make_data_set ( teacher, inputs, expected_values );
+
+  my_line_t line;
+
+  noptim::train_parameters_t parameters;
+  parameters.learning_rate = learning_rate;
+  parameters.batch_size = 8;
+
+  noptim::trainer<METHOD_ENUM, my_line_t> tr ( line, parameters );
+  noptim::train_statistics_t stat;
+
+  for ( size_t e = 0; e < epoch_count; ++e )
+  {
+    tr.train_epoch ( inputs.data(), expected_values.data(), sample_count, &stat );
+  }
+
+  assert ( epoch_count == stat.epoch_count );
+  assert ( epoch_count * sample_count / parameters.batch_size == stat.step_count );
+  assert ( stat.loss < expected_loss );
+}
+
+template<noptim::train_method METHOD_ENUM>
+void smoke_test_train_network ( double const learning_rate, size_t const epoch_count )
+{
+  my_network_t teacher;
+  set_test_koefs ( teacher.get_line<0>(), 3 );
+  set_test_koefs ( teacher.get_line<1>(), 5 );
+
+  std::array<my_network_t::input_array_t, sample_count> inputs{};
+  std::array<my_network_t::output_array_t, sample_count> expected_values{};
+  make_data_set ( teacher, inputs, expected_values );
+
+  my_network_t network;
+  set_test_koefs ( network.get_line<0>(), 7 );
+  set_test_koefs ( network.get_line<1>(), 9 );
+
+  noptim::train_parameters_t parameters;
+  parameters.learning_rate = learning_rate;
+  parameters.batch_size = 8;
+
+  noptim::trainer<METHOD_ENUM, my_network_t> tr ( network, parameters );
+
+  auto const initial_loss = tr.train_epoch ( inputs.data(), expected_values.data(), sample_count );
+  auto loss = initial_loss;
+
+  for ( size_t e = 1; e < epoch_count; ++e )
+  {
+    loss = tr.train_epoch ( inputs.data(), expected_values.data(), sample_count );
+  }
+
+  assert ( loss < 0.01 * initial_loss );
+}
+
+} // namespace anonymous
+
+void test_trainer()
+{
+  smoke_test_backprop();
+
+  smoke_test_train_line<noptim::train_method::sgd> ( 0.1, 200, 1e-8 );
+  smoke_test_train_line<noptim::train_method::momentum> ( 0.02, 200, 1e-8 );
+  smoke_test_train_line<noptim::train_method::adam> ( 0.05, 300, 1e-6 );
+
+  smoke_test_train_network<noptim::train_method::sgd> ( 0.05, 300 );
+  smoke_test_train_network<noptim::train_method::momentum> ( 0.01, 300 );
+  smoke_test_train_network<noptim::train_method::adam> ( 0.01, 300 );
+}